@@ -0,0 +1,395 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2022 David Oniani
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef BATCH_HPP
+#define BATCH_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "expr.hpp"
+#include "parallel.hpp"
+
+namespace parallel {
+
+class batch;
+
+namespace detail {
+
+/**
+ * @brief A step of a batch, run once every step it reads from has completed.
+ */
+class step {
+   public:
+    std::vector<std::size_t> operands;
+    std::vector<std::size_t> consumers;
+    bool kept{false};
+
+    step() = default;
+    step(const step&) = delete;
+    step& operator=(const step&) = delete;
+    virtual ~step() = default;
+
+    virtual void run(std::pmr::memory_resource* resource) = 0;
+    virtual void release() noexcept = 0;
+};
+
+/**
+ * @brief A step producing a tensor, which is held until the last step reading it has completed.
+ */
+template <arithmetic T, size_type Order>
+class output : public step {
+   public:
+    std::optional<core::tensor<T, Order> > result;
+
+    void release() noexcept override {
+        result.reset();
+    }
+};
+
+/**
+ * @brief Maps what a recorded callable returns onto the tensor type of the step, either the tensor
+ * itself or the one an expression is evaluated into.
+ */
+template <typename R>
+struct result;
+
+template <arithmetic T, size_type Order>
+struct result<core::tensor<T, Order> > {
+    using value_type = T;
+    static constexpr size_type order = Order;
+};
+
+template <expression E>
+struct result<E> {
+    using value_type = typename E::value_type;
+    static constexpr size_type order = E::order;
+};
+
+}  // namespace detail
+
+/**
+ * @brief Refers to a tensor within a batch, either an input or the result of a recorded step.
+ * @tparam T An arithmetic type representing the type of each element in tensor.
+ * @tparam Order The NTTP representing the order of a tensor.
+ */
+template <arithmetic T, size_type Order>
+class handle {
+   private:
+    friend class batch;
+
+    const core::tensor<T, Order>* m_input{nullptr};
+    const detail::output<T, Order>* m_output{nullptr};
+    std::size_t m_id{0};
+
+    [[nodiscard]] const core::tensor<T, Order>& value() const noexcept {
+        return m_input != nullptr ? *m_input : *m_output->result;
+    }
+
+   public:
+    using value_type = T;
+    static constexpr size_type order = Order;
+};
+
+/**
+ * @brief Records operations on tensors into a graph and runs them as a whole, so that many small
+ * operations share a single hand-off to the pool instead of paying for one each.
+ *
+ * Every step reads the tensors behind the handles it is recorded with, and its result is held by
+ * the batch. Steps run once every step they read from has completed, independent ones concurrently
+ * on the pool when threading is enabled via `set_threads`. Results only read by other steps are
+ * released once the last of them has completed, unless kept, and their buffers are recycled for
+ * the steps that follow and for later submissions. A batch may be submitted any number of times,
+ * e.g. after updating its inputs.
+ */
+class batch {
+   private:
+    template <arithmetic T, size_type Order, typename F, typename... Hs>
+    class task final : public detail::output<T, Order> {
+       private:
+        F m_func;
+        std::tuple<Hs...> m_operands;
+
+       public:
+        explicit task(F func, const Hs&... operands)
+            : m_func(std::move(func)), m_operands(operands...) {}
+
+        void run(std::pmr::memory_resource* const resource) override {
+            auto value = std::apply(
+                [this](const Hs&... operands) { return m_func(operands.value()...); }, m_operands);
+            if constexpr (expression<decltype(value)>) {
+                if (!this->result) {
+                    this->result.emplace(value.extents(), resource);
+                }
+                *this->result = value;
+            } else {
+                this->result = std::move(value);
+            }
+        }
+    };
+
+    static constexpr auto none = static_cast<std::size_t>(-1);
+
+    memory::buffer_pool m_pool;
+    std::vector<std::unique_ptr<detail::step> > m_steps;
+    std::unique_ptr<std::atomic<std::size_t>[]> m_pending;
+    std::unique_ptr<std::atomic<std::size_t>[]> m_uses;
+    std::size_t m_counted{0};
+    std::size_t m_workers{0};
+    std::atomic<std::size_t> m_remaining{0};
+    std::atomic<bool> m_failed{false};
+    std::exception_ptr m_error;
+    std::mutex m_mutex;
+    std::promise<void> m_promise;
+    std::shared_future<void> m_done;
+
+    /**
+     * @brief Runs the step unless an earlier one failed, and releases the results it was the last
+     * step to read.
+     */
+    void run(const std::size_t idx) {
+        auto& current = *m_steps[idx];
+        if (!m_failed.load(std::memory_order_relaxed)) {
+            try {
+                current.run(&m_pool);
+            } catch (...) {
+                std::lock_guard lock(m_mutex);
+                if (!m_error) {
+                    m_error = std::current_exception();
+                }
+                m_failed = true;
+            }
+        }
+        for (const auto operand : current.operands) {
+            if (m_uses[operand].fetch_sub(1, std::memory_order_acq_rel) == 1 &&
+                !m_steps[operand]->kept) {
+                m_steps[operand]->release();
+            }
+        }
+    }
+
+    /**
+     * @brief Runs the step on a worker and then the steps it makes ready, continuing with the first
+     * of them on the same worker and queueing the others.
+     */
+    void execute(std::size_t idx) {
+        while (true) {
+            run(idx);
+            auto next = none;
+            for (const auto consumer : m_steps[idx]->consumers) {
+                if (m_pending[consumer].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                    if (next == none) {
+                        next = consumer;
+                    } else {
+                        spawn(consumer);
+                    }
+                }
+            }
+            // The batch may be destroyed as soon as the last step has completed.
+            if (m_remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                finish();
+                return;
+            }
+            if (next == none) {
+                return;
+            }
+            idx = next;
+        }
+    }
+
+    void spawn(const std::size_t idx) {
+        detail::instance().submit(m_workers, [this, idx] { execute(idx); });
+    }
+
+    void finish() noexcept {
+        auto promise = std::move(m_promise);
+        auto error = m_error;
+        if (error) {
+            promise.set_exception(std::move(error));
+        } else {
+            promise.set_value();
+        }
+    }
+
+   public:
+    /**
+     * @brief Constructs an empty batch, whose intermediate results are allocated from the default
+     * resource at the time of construction.
+     */
+    batch() : m_pool(std::size_t{1} << 30, memory::default_resource()) {}
+
+    batch(const batch&) = delete;
+    batch& operator=(const batch&) = delete;
+
+    /**
+     * @brief Waits for the last submission to complete.
+     */
+    ~batch() {
+        wait();
+    }
+
+    /**
+     * @brief Refers to an existing tensor, which has to outlive the batch and must not be modified
+     * while a submission runs.
+     * @param t Tensor to read from.
+     * @return Handle to pass to the steps reading the tensor.
+     */
+    template <arithmetic T, size_type Order>
+    [[nodiscard]] handle<T, Order> input(const core::tensor<T, Order>& t) const noexcept {
+        handle<T, Order> result;
+        result.m_input = &t;
+        return result;
+    }
+
+    /**
+     * @brief Records a step invoking the callable with the tensors behind the handles once they are
+     * available. A returned expression is evaluated into a buffer recycled by the batch, so that
+     * e.g. `core::lazy(x) * y + 1` avoids allocating, while a returned tensor is held as is.
+     * @param func Callable taking a `const core::tensor&` per handle.
+     * @param operands Handles of the tensors to read, recorded with the same batch.
+     * @return Handle to the result of the step.
+     */
+    template <typename F, typename... Hs>
+    [[nodiscard]] auto record(F func, const Hs&... operands) {
+        using R = std::remove_cvref_t<std::invoke_result_t<
+            F&, const core::tensor<typename Hs::value_type, Hs::order>&...> >;
+        using T = typename detail::result<R>::value_type;
+        constexpr auto Order = detail::result<R>::order;
+
+        wait();
+        auto step = std::make_unique<task<T, Order, F, Hs...> >(std::move(func), operands...);
+        const auto id = m_steps.size();
+        (
+            [&] {
+                if (operands.m_output != nullptr) {
+                    step->operands.push_back(operands.m_id);
+                    m_steps[operands.m_id]->consumers.push_back(id);
+                }
+            }(),
+            ...);
+
+        handle<T, Order> result;
+        result.m_output = step.get();
+        result.m_id = id;
+        m_steps.push_back(std::move(step));
+        return result;
+    }
+
+    /**
+     * @brief Keeps the result of a step that is read by other steps, which is otherwise released
+     * once they have completed. Results no step reads from are always kept.
+     * @param h Handle to the result.
+     */
+    template <arithmetic T, size_type Order>
+    void keep(const handle<T, Order>& h) {
+        wait();
+        if (h.m_output != nullptr) {
+            m_steps[h.m_id]->kept = true;
+        }
+    }
+
+    /**
+     * @brief Runs every recorded step, waiting for the previous submission to complete first. With
+     * one thread, or from within a worker, the steps run on the calling thread in recording order
+     * before returning. Once a step throws, the remaining ones are skipped.
+     * @return Future becoming ready once every step has completed, holding the first exception.
+     */
+    std::shared_future<void> submit() {
+        wait();
+        const auto count = m_steps.size();
+        if (count != m_counted) {
+            m_pending = std::make_unique<std::atomic<std::size_t>[]>(count);
+            m_uses = std::make_unique<std::atomic<std::size_t>[]>(count);
+            m_counted = count;
+        }
+        for (std::size_t idx = 0; idx < count; ++idx) {
+            m_pending[idx].store(m_steps[idx]->operands.size(), std::memory_order_relaxed);
+            m_uses[idx].store(m_steps[idx]->consumers.size(), std::memory_order_relaxed);
+        }
+        m_remaining.store(count, std::memory_order_relaxed);
+        m_failed.store(false, std::memory_order_relaxed);
+        m_error = nullptr;
+        m_promise = std::promise<void>();
+        m_done = m_promise.get_future().share();
+
+        m_workers = threads() - 1;
+        if (m_workers == 0 || count <= 1 || detail::is_worker) {
+            for (std::size_t idx = 0; idx < count; ++idx) {
+                run(idx);
+            }
+            finish();
+            return m_done;
+        }
+        for (std::size_t idx = 0; idx < count; ++idx) {
+            if (m_steps[idx]->operands.empty()) {
+                spawn(idx);
+            }
+        }
+        return m_done;
+    }
+
+    /**
+     * @brief Waits for the last submission to complete, without rethrowing its exception.
+     */
+    void wait() const {
+        if (m_done.valid()) {
+            m_done.wait();
+        }
+    }
+
+    /**
+     * @brief Returns the tensor behind the handle once the last submission has completed.
+     * @param h Handle to the tensor.
+     * @return Input tensor or result of the step.
+     */
+    template <arithmetic T, size_type Order>
+    [[nodiscard]] const core::tensor<T, Order>& get(const handle<T, Order>& h) const {
+        wait();
+        if (h.m_output != nullptr && !h.m_output->result) {
+            throw std::runtime_error("Batch result unavailable.");
+        }
+        return h.value();
+    }
+
+    /**
+     * @brief Returns the number of recorded steps.
+     */
+    [[nodiscard]] std::size_t size() const noexcept {
+        return m_steps.size();
+    }
+};
+
+}  // namespace parallel
+
+#endif  // BATCH_HPP
@@ -25,10 +25,50 @@
 #ifndef BUILDER_HPP
 #define BUILDER_HPP
 
+#include <cmath>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+
 #include "core.hpp"
+#include "expr.hpp"
+#include "sparse.hpp"
 
 namespace builder {
 
+namespace detail {
+
+/**
+ * @brief Constructs a tensor of zeros. Unless the default resource has been changed, the buffer is
+ * allocated from `memory::zeroed_resource`, so large tensors are backed by pages the kernel zeroes
+ * on first access instead of being written here.
+ */
+template <arithmetic T, size_type Order>
+[[nodiscard]] constexpr auto zeros(const array<Order>& extents) {
+    if (!std::is_constant_evaluated() &&
+        memory::default_resource() == memory::aligned_resource()) {
+        return core::tensor<T, Order>(extents, memory::zeroed_resource::instance());
+    }
+    auto result = core::tensor<T, Order>(extents);
+    core::kernel::fill(result.data(), result.size(), static_cast<T>(0));
+    return std::move(result).take();
+}
+
+}  // namespace detail
+
+/**
+ * @brief Constructs a tensor with uninitialized elements from the provided extents, for when every
+ * element is overwritten anyway.
+ * @tparam T Arithmetic type representing the type of every element in the returned tensor.
+ * @tparam Order Order of the tensor.
+ * @param extents Extents for constructing a tensor.
+ * @return A tensor with uninitialized elements and the provided extents.
+ */
+template <arithmetic T, size_type Order>
+[[nodiscard]] constexpr auto empty(const array<Order>& extents) {
+    return core::tensor<T, Order>(extents);
+}
+
 /**
  * @brief Constructs a tensor of zeros from the provided extents.
  * @tparam T Arithmetic type representing the type of every element in the returned tensor.
@@ -38,11 +78,7 @@ namespace builder {
  */
 template <arithmetic T, size_type Order>
 [[nodiscard]] constexpr auto zeros(const array<Order>& extents) {
-    auto result = core::tensor<T, Order>(extents);
-    for (size_type idx = 0; idx < result.size(); ++idx) {
-        result[idx] = static_cast<T>(0);
-    }
-    return result;
+    return detail::zeros<T, Order>(extents);
 }
 
 /**
@@ -55,9 +91,7 @@ template <arithmetic T, size_type Order>
 template <arithmetic T, size_type Order>
 [[nodiscard]] constexpr auto ones(const array<Order>& extents) {
     auto result = core::tensor<T, Order>(extents);
-    for (size_type idx = 0; idx < result.size(); ++idx) {
-        result[idx] = static_cast<T>(1);
-    }
+    core::kernel::fill(result.data(), result.size(), static_cast<T>(1));
     return result;
 }
 
@@ -71,12 +105,22 @@ template <arithmetic T, size_type Order>
 template <arithmetic T, size_type Order>
 [[nodiscard]] constexpr auto xs(const array<Order>& extents, const T x) {
     auto result = core::tensor<T, Order>(extents);
-    for (size_type idx = 0; idx < result.size(); ++idx) {
-        result[idx] = x;
-    }
+    core::kernel::fill(result.data(), result.size(), x);
     return result;
 }
 
+/**
+ * @brief Constructs a tensor with uninitialized elements from the extents of the provided tensor.
+ * @tparam T Arithmetic type representing the type of every element in the returned tensor.
+ * @tparam Order Order of the tensor.
+ * @param t Tensor to match the extents against.
+ * @return A tensor with uninitialized elements and the extents of the provided tensor.
+ */
+template <arithmetic T, size_type Order>
+[[nodiscard]] constexpr auto empty_like(const core::tensor<T, Order>& t) {
+    return core::tensor<T, Order>(t.extents());
+}
+
 /**
  * @brief Constructs a tensor of zeros from the extents of the provided tensor.
  * @tparam T Arithmetic type representing the type of every element in the returned tensor.
@@ -86,11 +130,7 @@ template <arithmetic T, size_type Order>
  */
 template <arithmetic T, size_type Order>
 [[nodiscard]] constexpr auto zeros_like(const core::tensor<T, Order>& t) {
-    auto result = core::tensor<T, Order>(t.extents());
-    for (size_type idx = 0; idx < t.size(); ++idx) {
-        result[idx] = static_cast<T>(0);
-    }
-    return result;
+    return detail::zeros<T, Order>(t.extents());
 }
 
 /**
@@ -103,9 +143,7 @@ template <arithmetic T, size_type Order>
 template <arithmetic T, size_type Order>
 [[nodiscard]] constexpr auto ones_like(const core::tensor<T, Order>& t) {
     auto result = core::tensor<T, Order>(t.extents());
-    for (size_type idx = 0; idx < t.size(); ++idx) {
-        result[idx] = static_cast<T>(1);
-    }
+    core::kernel::fill(result.data(), result.size(), static_cast<T>(1));
     return result;
 }
 
@@ -118,10 +156,8 @@ template <arithmetic T, size_type Order>
  */
 template <arithmetic T, size_type Order>
 [[nodiscard]] constexpr auto xs_like(const core::tensor<T, Order>& t, const T x) {
-    auto result = core::tensor(t.extents());
-    for (size_type idx = 0; idx < t.size(); ++idx) {
-        result[idx] = x;
-    }
+    auto result = core::tensor<T, Order>(t.extents());
+    core::kernel::fill(result.data(), result.size(), x);
     return result;
 }
 
@@ -135,13 +171,184 @@ template <arithmetic T, size_type Order>
  */
 template <arithmetic T>
 [[nodiscard]] constexpr auto range1(const T begin, const T end, const T stride) {
-    auto extents = std::array<size_type, 1>{static_cast<size_type>((end - begin) / stride)};
-    auto result = core::tensor<T, 1>(extents);
-    size_type idx = 0;
-    for (T val = begin; val < end; val += stride) {
-        result[idx++] = val;
+    const auto extent = static_cast<size_type>((end - begin) / stride);
+    using W = core::compute_t<T>;
+    return core::tensor<T, 1>(core::grid_expr<T, 1>(static_cast<W>(begin), static_cast<W>(stride),
+                                                    {extent}));
+}
+
+namespace detail {
+
+/**
+ * @brief Returns the number of values in [begin, end) with the given stride, rounded up as in
+ * NumPy and exact for integral types.
+ */
+template <arithmetic T>
+[[nodiscard]] constexpr size_type count(const T begin, const T end, const T stride) {
+    if (stride == T{0}) {
+        throw std::domain_error("Division by zero.");
     }
-    return result;
+    if constexpr (std::is_integral_v<T>) {
+        if (stride > T{0}) {
+            return end > begin ? static_cast<size_type>((end - begin - 1) / stride) + 1 : 0;
+        }
+        if constexpr (std::is_signed_v<T>) {
+            return begin > end ? static_cast<size_type>((begin - end - 1) / -stride) + 1 : 0;
+        }
+        return 0;
+    } else {
+        using W = core::compute_t<T>;
+        const auto span = std::ceil((static_cast<W>(end) - static_cast<W>(begin)) /
+                                    static_cast<W>(stride));
+        return span > 0 ? static_cast<size_type>(span) : 0;
+    }
+}
+
+/**
+ * @brief Type `linspace` computes values in, `double` for integral types.
+ */
+template <typename T>
+using space_t = std::conditional_t<std::is_integral_v<T>, double, core::compute_t<T> >;
+
+}  // namespace detail
+
+/**
+ * @brief Lazily constructs the values from begin up to, but excluding, end with the given stride.
+ * Value `idx` is computed as `begin + idx * stride`, so that no error accumulates, and the
+ * expression is only evaluated once assigned, so that `arange(0.0F, 1.0F, 0.1F) * 2` never
+ * materializes the range.
+ * @tparam T Arithmetic type representing the type of every element.
+ * @param begin Start of the range.
+ * @param end End of the range, excluded.
+ * @param stride Stride for the range, which must not be zero.
+ * @return An order one expression of `ceil((end - begin) / stride)` values.
+ */
+template <arithmetic T>
+[[nodiscard]] constexpr auto arange(const T begin, const T end, const T stride = T{1}) {
+    using W = core::compute_t<T>;
+    return core::grid_expr<T, 1>(static_cast<W>(begin), static_cast<W>(stride),
+                                 {detail::count(begin, end, stride)});
+}
+
+/**
+ * @brief Lazily constructs the values from zero up to, but excluding, end, see `arange`.
+ * @tparam T Arithmetic type representing the type of every element.
+ * @param end End of the range, excluded.
+ * @return An order one expression of values.
+ */
+template <arithmetic T>
+[[nodiscard]] constexpr auto arange(const T end) {
+    return arange(T{0}, end);
+}
+
+/**
+ * @brief Lazily constructs evenly spaced values between begin and end, see `arange`. If the end is
+ * included, the last value is exactly end.
+ * @tparam T Arithmetic type representing the type of every element, computed in `double` and
+ * truncated for integral types.
+ * @param begin Start of the interval.
+ * @param end End of the interval.
+ * @param count Number of values.
+ * @param endpoint Whether end is the last value rather than excluded.
+ * @return An order one expression of `count` values.
+ */
+template <arithmetic T>
+[[nodiscard]] constexpr auto linspace(const T begin, const T end, const size_type count,
+                                      const bool endpoint = true) {
+    using W = detail::space_t<T>;
+    const auto first = static_cast<W>(begin);
+    const auto last = static_cast<W>(end);
+    const auto intervals = endpoint ? count - 1 : count;
+    const auto stride = count > 0 && intervals > 0 ? (last - first) / static_cast<W>(intervals)
+                                                   : W{0};
+    const auto exact = endpoint && count > 1 ? std::optional<W>(last) : std::nullopt;
+    return core::grid_expr<T, 1, W>(first, stride, {count}, 0, exact);
+}
+
+/**
+ * @brief Lazily constructs values evenly spaced on a log scale, i.e. the base raised to the values
+ * of `linspace(begin, end, count, endpoint)`.
+ * @tparam T Arithmetic type representing the type of every element.
+ * @param begin Exponent of the first value.
+ * @param end Exponent of the last value.
+ * @param count Number of values.
+ * @param base Base of the log scale.
+ * @param endpoint Whether the last value is base raised to end.
+ * @return An order one expression of `count` values.
+ */
+template <arithmetic T>
+[[nodiscard]] constexpr auto logspace(const T begin, const T end, const size_type count,
+                                      const T base = T{10}, const bool endpoint = true) {
+    using W = detail::space_t<T>;
+    const auto b = static_cast<W>(base);
+    return linspace(begin, end, count, endpoint).map([b](const W x) { return std::pow(b, x); });
+}
+
+/**
+ * @brief Lazily spreads order one ranges over the grid of their extents, as NumPy's `meshgrid`
+ * with matrix indexing: element `[i_0, ..., i_n]` of expression `k` is value `i_k` of range `k`.
+ * @param first Range along the first axis, from `arange` or `linspace`.
+ * @param rest Ranges along the following axes.
+ * @return An array of one expression per range, each of order the number of ranges.
+ */
+template <arithmetic T, typename W, std::same_as<core::grid_expr<T, 1, W> >... Rest>
+[[nodiscard]] constexpr auto meshgrid(const core::grid_expr<T, 1, W>& first,
+                                      const Rest&... rest) {
+    constexpr auto N = 1 + sizeof...(Rest);
+    const auto extents = array<N>{first.size(), rest.size()...};
+    return [&]<size_type... Axis>(std::index_sequence<Axis...>) {
+        const std::array<core::grid_expr<T, 1, W>, N> ranges{first, rest...};
+        return std::array{ranges[Axis].along(extents, Axis)...};
+    }(std::make_index_sequence<N>{});
+}
+
+/**
+ * @brief Lazily constructs the coordinates of every element of the provided extents, as the
+ * leading axis of NumPy's `indices`: element `idx` of expression `k` is its coordinate along `k`.
+ * @tparam T Arithmetic type representing the type of every coordinate.
+ * @tparam Order Order of the extents.
+ * @param extents Extents of the grid.
+ * @return An array of one expression per axis, each of order `Order`.
+ */
+template <arithmetic T, size_type Order>
+[[nodiscard]] constexpr auto indices(const array<Order>& extents) {
+    using W = core::compute_t<T>;
+    return [&]<size_type... Axis>(std::index_sequence<Axis...>) {
+        return std::array{core::grid_expr<T, Order>(W{0}, W{1}, extents, Axis)...};
+    }(std::make_index_sequence<Order>{});
+}
+
+/**
+ * @brief Constructs an empty sparse matrix in coordinate format, to insert elements into.
+ * @tparam T Arithmetic type representing the type of every element in the returned matrix.
+ * @param extents Number of rows and columns.
+ * @return A sparse matrix without elements.
+ */
+template <typename T>
+[[nodiscard]] auto coo(const array<2>& extents) {
+    return core::coo_matrix<T>(extents);
+}
+
+/**
+ * @brief Constructs a sparse matrix of zeros stored row by row.
+ * @tparam T Arithmetic type representing the type of every element in the returned matrix.
+ * @param extents Number of rows and columns.
+ * @return A sparse matrix without elements.
+ */
+template <typename T>
+[[nodiscard]] auto csr(const array<2>& extents) {
+    return core::csr_matrix<T>(extents, std::vector<size_type>(extents[0] + 1, 0), {}, {});
+}
+
+/**
+ * @brief Constructs a sparse matrix of zeros stored column by column.
+ * @tparam T Arithmetic type representing the type of every element in the returned matrix.
+ * @param extents Number of rows and columns.
+ * @return A sparse matrix without elements.
+ */
+template <typename T>
+[[nodiscard]] auto csc(const array<2>& extents) {
+    return core::csc_matrix<T>(extents, std::vector<size_type>(extents[1] + 1, 0), {}, {});
 }
 
 }  // namespace builder
@@ -0,0 +1,271 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2022 David Oniani
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef COMPARE_HPP
+#define COMPARE_HPP
+
+#include <cstring>
+#include <type_traits>
+
+#include "expr.hpp"
+
+namespace core {
+
+/**
+ * @brief Defines a node comparing two expressions element-wise, whose elements are `bool`. The
+ * operands are combined by a binary node, so that they are broadcast as for arithmetic, and packs
+ * of operands compare to SIMD masks that are turned into bits when evaluated.
+ * @tparam B Binary node applying a predicate from `op`.
+ */
+template <expression B>
+class compare_expr {
+   private:
+    B m_expr;
+
+   public:
+    using value_type = bool;
+    using operand_type = simd::lane_t<typename B::value_type>;
+    static constexpr size_type order = B::order;
+    static constexpr bool is_expression = true;
+    static constexpr bool is_predicate = true;
+
+    // Loads yield masks rather than packs, hence the node cannot be an operand of vectorized nodes.
+    template <typename V>
+    static constexpr bool vectorizable = false;
+
+    static constexpr bool vectorizable_mask = B::template vectorizable<operand_type>;
+
+    /**
+     * @brief Constructs a node from the binary node applying the predicate.
+     * @param expr Binary node.
+     */
+    constexpr explicit compare_expr(const B& expr) noexcept : m_expr{expr} {}
+
+    [[nodiscard]] constexpr bool operator[](const size_type idx) const {
+        return m_expr[idx] != 0;
+    }
+
+    template <typename V>
+    [[nodiscard]] auto load_mask(const size_type idx, const size_type count) const {
+        return m_expr.template load<V>(idx, count);
+    }
+
+    [[nodiscard]] constexpr auto extents() const noexcept {
+        return m_expr.extents();
+    }
+
+    [[nodiscard]] constexpr auto size() const noexcept {
+        return m_expr.size();
+    }
+
+    [[nodiscard]] bool aliases(const void* first, const void* last) const noexcept {
+        return m_expr.aliases(first, last);
+    }
+
+    /**
+     * @brief Evaluates the comparison in a single pass.
+     * @return New tensor holding the result of every comparison.
+     */
+    [[nodiscard]] constexpr auto eval() const {
+        return tensor<bool, order>(*this);
+    }
+};
+
+namespace detail {
+
+template <typename X>
+struct is_compare : std::false_type {};
+
+template <expression B>
+struct is_compare<compare_expr<B> > : std::true_type {};
+
+template <typename X>
+struct is_mask : std::false_type {};
+
+template <size_type Order>
+struct is_mask<tensor<bool, Order> > : std::true_type {};
+
+template <typename Op, operand L, operand R>
+[[nodiscard]] constexpr auto make_compare(const L& lhs, const R& rhs) {
+    const auto expr = make_binary<Op>(lhs, rhs);
+    return compare_expr<std::remove_const_t<decltype(expr)> >(expr);
+}
+
+/**
+ * @brief Returns whether every element of the comparison equals `Expected`, stopping at the first
+ * that does not. Whole SIMD masks are tested at once where the operands allow.
+ */
+template <bool Expected, expression E>
+[[nodiscard]] bool holds(const E& expr) {
+    const auto check = [&](const size_type begin, const size_type end) {
+        size_type idx = begin;
+        if constexpr (E::vectorizable_mask) {
+            using U = typename E::operand_type;
+            constexpr auto width = simd::pack<U>::width;
+            constexpr auto lanes = (1U << width) - 1;
+            for (; idx + width <= end; idx += width) {
+                if (simd::bits(expr.template load_mask<U>(idx, width)) != (Expected ? lanes : 0U)) {
+                    return false;
+                }
+            }
+            if (const auto rest = end - idx; rest != 0) {
+                const auto part = (1U << rest) - 1;
+                const auto hits = simd::bits(expr.template load_mask<U>(idx, rest)) & part;
+                return hits == (Expected ? part : 0U);
+            }
+        } else {
+            for (; idx < end; ++idx) {
+                if (expr[idx] != Expected) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    };
+    return parallel::for_each_until(expr.size(), check);
+}
+
+/**
+ * @brief Returns the comparison testing whether the elements are nonzero, unless they are results
+ * of a comparison already.
+ */
+template <operand X>
+[[nodiscard]] constexpr auto as_compare(const X& x) {
+    if constexpr (is_compare<X>::value) {
+        return x;
+    } else {
+        using T = typename std::remove_cvref_t<decltype(as_expr(x))>::value_type;
+        return make_compare<op::not_equal>(x, T{0});
+    }
+}
+
+}  // namespace detail
+
+/**
+ * @brief Lazily compares two operands element-wise for equality.
+ * @param lhs Left-hand side expression, tensor or scalar.
+ * @param rhs Right-hand side expression, tensor or scalar.
+ * @return Expression of `bool` elements, which is broadcast as arithmetic is.
+ */
+template <detail::operand L, detail::operand R>
+    requires(!arithmetic<L> || !arithmetic<R>)
+[[nodiscard]] constexpr auto equal(const L& lhs, const R& rhs) {
+    return detail::make_compare<op::equal>(lhs, rhs);
+}
+
+/**
+ * @brief Lazily compares two operands element-wise for inequality.
+ * @param lhs Left-hand side expression, tensor or scalar.
+ * @param rhs Right-hand side expression, tensor or scalar.
+ * @return Expression of `bool` elements, which is broadcast as arithmetic is.
+ */
+template <detail::operand L, detail::operand R>
+    requires(!arithmetic<L> || !arithmetic<R>)
+[[nodiscard]] constexpr auto not_equal(const L& lhs, const R& rhs) {
+    return detail::make_compare<op::not_equal>(lhs, rhs);
+}
+
+/**
+ * @brief Lazily tests element-wise whether the left-hand side is greater.
+ * @param lhs Left-hand side expression, tensor or scalar.
+ * @param rhs Right-hand side expression, tensor or scalar.
+ * @return Expression of `bool` elements, which is broadcast as arithmetic is.
+ */
+template <detail::operand L, detail::operand R>
+    requires(!arithmetic<L> || !arithmetic<R>)
+[[nodiscard]] constexpr auto greater(const L& lhs, const R& rhs) {
+    return detail::make_compare<op::greater>(lhs, rhs);
+}
+
+/**
+ * @brief Lazily tests element-wise whether the left-hand side is greater or equal.
+ * @param lhs Left-hand side expression, tensor or scalar.
+ * @param rhs Right-hand side expression, tensor or scalar.
+ * @return Expression of `bool` elements, which is broadcast as arithmetic is.
+ */
+template <detail::operand L, detail::operand R>
+    requires(!arithmetic<L> || !arithmetic<R>)
+[[nodiscard]] constexpr auto greater_equal(const L& lhs, const R& rhs) {
+    return detail::make_compare<op::greater_equal>(lhs, rhs);
+}
+
+/**
+ * @brief Lazily tests element-wise whether the left-hand side is less.
+ * @param lhs Left-hand side expression, tensor or scalar.
+ * @param rhs Right-hand side expression, tensor or scalar.
+ * @return Expression of `bool` elements, which is broadcast as arithmetic is.
+ */
+template <detail::operand L, detail::operand R>
+    requires(!arithmetic<L> || !arithmetic<R>)
+[[nodiscard]] constexpr auto less(const L& lhs, const R& rhs) {
+    return detail::make_compare<op::less>(lhs, rhs);
+}
+
+/**
+ * @brief Lazily tests element-wise whether the left-hand side is less or equal.
+ * @param lhs Left-hand side expression, tensor or scalar.
+ * @param rhs Right-hand side expression, tensor or scalar.
+ * @return Expression of `bool` elements, which is broadcast as arithmetic is.
+ */
+template <detail::operand L, detail::operand R>
+    requires(!arithmetic<L> || !arithmetic<R>)
+[[nodiscard]] constexpr auto less_equal(const L& lhs, const R& rhs) {
+    return detail::make_compare<op::less_equal>(lhs, rhs);
+}
+
+/**
+ * @brief Returns whether every element is true, or nonzero, stopping at the first that is not.
+ * Comparisons are tested as they are computed, without being evaluated into a tensor, e.g.
+ * `all(less_equal(abs_error, 1e-6F))`.
+ * @param x Tensor, view, expression or comparison.
+ * @return True if every element is true, including for zero elements.
+ */
+template <detail::operand X>
+    requires(!arithmetic<X>)
+[[nodiscard]] bool all(const X& x) {
+    if constexpr (detail::is_mask<X>::value) {
+        return x.size() == 0 || std::memchr(x.data(), 0, x.size()) == nullptr;
+    } else {
+        return detail::holds<true>(detail::as_compare(x));
+    }
+}
+
+/**
+ * @brief Returns whether any element is true, or nonzero, stopping at the first that is.
+ * @param x Tensor, view, expression or comparison.
+ * @return True if some element is true, false for zero elements.
+ */
+template <detail::operand X>
+    requires(!arithmetic<X>)
+[[nodiscard]] bool any(const X& x) {
+    if constexpr (detail::is_mask<X>::value) {
+        return x.size() != 0 && std::memchr(x.data(), 1, x.size()) != nullptr;
+    } else {
+        return !detail::holds<false>(detail::as_compare(x));
+    }
+}
+
+}  // namespace core
+
+#endif  // COMPARE_HPP
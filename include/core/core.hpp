@@ -25,6 +25,7 @@
 #ifndef CORE_HPP
 #define CORE_HPP
 
+#include <algorithm>
 #include <array>
 #include <cmath>
 #include <concepts>
@@ -32,6 +33,20 @@
 #include <iostream>
 #include <numeric>
 #include <stdexcept>
+#include <string>
+#include <utility>
+
+#include "format.hpp"
+#include "kernel.hpp"
+#include "memory.hpp"
+
+#ifndef TENSOR_BOUNDS_CHECK
+#ifdef NDEBUG
+#define TENSOR_BOUNDS_CHECK 0
+#else
+#define TENSOR_BOUNDS_CHECK 1
+#endif
+#endif
 
 using size_type = std::size_t;
 
@@ -39,10 +54,44 @@ template <size_type N>
 using array = std::array<size_type, N>;
 
 template <typename T>
-concept arithmetic = std::is_arithmetic_v<T>;
+concept arithmetic = std::is_arithmetic_v<T> || core::is_half_v<T>;
+
+template <typename E>
+concept expression = requires(const E& e, const size_type idx) {
+    typename E::value_type;
+    { E::order } -> std::convertible_to<size_type>;
+    { e.extents() };
+    { e.size() } -> std::convertible_to<size_type>;
+    { e[idx] } -> std::convertible_to<typename E::value_type>;
+} && E::is_expression;
 
 namespace core {
 
+template <typename T, size_type Order>
+    requires arithmetic<std::remove_const_t<T> >
+class tensor_view;
+
+namespace detail {
+
+/**
+ * @brief Computes the strides of a row-major layout, i.e. the number of elements between
+ * consecutive indices along every axis, in exact integer arithmetic.
+ * @param extents Extents of the layout.
+ * @return Strides of the layout.
+ */
+template <size_type Order>
+[[nodiscard]] constexpr array<Order> row_major_strides(const array<Order>& extents) noexcept {
+    array<Order> result{};
+    size_type stride = 1;
+    for (size_type dim = Order; dim-- > 0;) {
+        result[dim] = stride;
+        stride *= extents[dim];
+    }
+    return result;
+}
+
+}  // namespace detail
+
 /**
  * @brief Defines the representation of a tensor. Prefer "order" to "rank," as its unambiguous and
  * order 0 tensors exist (they are scalars).
@@ -52,25 +101,83 @@ namespace core {
 template <arithmetic T, size_type Order>
 class tensor {
    private:
+    std::pmr::memory_resource* m_resource;
     T* m_data;
     array<Order> m_extents;
     size_type m_size;
     array<Order> m_strides;
 
+    /**
+     * @brief Returns whether the expression reads elements of the buffer other than the one being
+     * written, e.g. a transposed view of the tensor, so that it cannot be evaluated in place.
+     */
+    template <typename E>
+    [[nodiscard]] constexpr bool aliased(const E& expr) const noexcept {
+        if constexpr (requires { expr.aliases(m_data, m_data); }) {
+            return !std::is_constant_evaluated() && expr.aliases(m_data, m_data + m_size);
+        } else {
+            return false;
+        }
+    }
+
+    /**
+     * @brief Combines the tensor with the expression in place in a single pass, broadcasting the
+     * expression to the extents of the tensor if they differ.
+     * @param expr Lazily evaluated expression or view.
+     * @param operation Element-wise operation.
+     */
+    template <typename E, typename Op>
+    constexpr void update(const E& expr, const Op operation) {
+        if (aliased(expr)) {
+            const auto copy = tensor<typename E::value_type, E::order>(expr);
+            update(lazy(copy), operation);
+            return;
+        }
+        if constexpr (E::order == Order) {
+            if (m_extents == expr.extents()) {
+                kernel::update(m_data, expr, m_size, operation);
+                return;
+            }
+        }
+        kernel::update(m_data, broadcast_to(expr, m_extents), m_size, operation);
+    }
+
+    /**
+     * @brief Evaluates the expression into the buffer in a single pass. Views of the same element
+     * type are copied via `kernel::copy`, which transposes in tiles rather than gathering strided
+     * elements one pack at a time.
+     * @param expr Lazily evaluated expression or view of the same extents.
+     */
+    template <typename E>
+    constexpr void evaluate(const E& expr) {
+        if constexpr (requires { expr.strides(); } &&
+                      std::is_same_v<typename E::value_type, T>) {
+            kernel::copy(m_data, expr.data(), expr.extents(), expr.strides());
+        } else {
+            kernel::evaluate(m_data, expr, m_size);
+        }
+    }
+
    public:
     /**
      * @brief Constructs an empty tensor.
      */
-    constexpr tensor() noexcept : m_data{nullptr}, m_extents{}, m_size{0}, m_strides{} {}
+    constexpr tensor() noexcept
+        : m_resource{memory::current_resource()},
+          m_data{nullptr},
+          m_extents{},
+          m_size{0},
+          m_strides{} {}
 
     /**
      * @brief Constructs an order one tensor.
      * @param values Initializer list holding values of the order one tensor.
      */
     constexpr tensor(std::initializer_list<T> values) noexcept
-        : m_size(values.size()), m_strides({1}) {
+        : m_resource{memory::current_resource()}, m_size(values.size()), m_strides({1}) {
+        TENSOR_RECORD(construct, m_size);
         m_extents = {m_size};
-        m_data = new T[m_size];
+        m_data = memory::allocate<T>(m_size, m_resource);
         std::copy(values.begin(), values.end(), m_data);
     }
 
@@ -78,7 +185,8 @@ class tensor {
      * @brief Constructs a tensor of an arbitrary order.
      * @param t_list Initializer list holding tensors.
      */
-    constexpr tensor(std::initializer_list<tensor<T, Order> > t_list) {
+    constexpr tensor(std::initializer_list<tensor<T, Order> > t_list)
+        : m_resource{memory::current_resource()} {
         size_type size{0};
         size_type check_size{0};
         for (const tensor<T, Order>& t : t_list) {
@@ -91,8 +199,9 @@ class tensor {
             }
             size += t.size();
         }
-        m_data = new T[size];
         m_size = size;
+        TENSOR_RECORD(construct, m_size);
+        m_data = memory::allocate<T>(m_size, m_resource);
 
         size_type acc_idx = 0;
         for (const tensor<T, Order>& t : t_list) {
@@ -101,26 +210,76 @@ class tensor {
             }
         }
 
-        auto prod = static_cast<float>(m_size);
-        for (size_type idx = 0; idx < Order; ++idx) {
-            prod /= m_extents[idx];
-            m_strides[idx] = static_cast<size_type>(prod);
-        }
+        m_strides = detail::row_major_strides(m_extents);
     }
 
     /**
      * @brief Constructs a tensor from the provided extents.
      * @param extents Extents for constructing a tensor.
      */
-    constexpr tensor(const array<Order> extents)
-        : m_extents(extents),
-          m_size(std::reduce(extents.begin(), extents.end(), 1, std::multiplies<size_type>())) {
-        m_data = new T[m_size];
-        auto prod = static_cast<float>(m_size);
-        for (size_type idx = 0; idx < Order; ++idx) {
-            prod /= m_extents[idx];
-            m_strides[idx] = static_cast<size_type>(prod);
+    constexpr tensor(const array<Order> extents) : tensor(extents, memory::current_resource()) {}
+
+    /**
+     * @brief Constructs a tensor from the provided extents, allocating from the provided resource.
+     * The resource has to outlive the tensor, and is not propagated to copies.
+     * @param extents Extents for constructing a tensor.
+     * @param resource Memory resource to allocate the elements from.
+     */
+    constexpr tensor(const array<Order> extents, std::pmr::memory_resource* const resource)
+        : m_resource(resource),
+          m_extents(extents),
+          m_size(std::reduce(extents.begin(), extents.end(), size_type{1},
+                             std::multiplies<size_type>())) {
+        TENSOR_RECORD(construct, m_size);
+        m_data = memory::allocate<T>(m_size, m_resource);
+        m_strides = detail::row_major_strides(m_extents);
+    }
+
+    /**
+     * @brief Constructs a tensor taking ownership of a buffer of row-major elements allocated from
+     * the provided resource, e.g. a memory-mapped file. The buffer is returned to the resource once
+     * the tensor is destroyed or reassigned to a tensor of a different size.
+     * @param data Buffer holding as many elements as the extents describe.
+     * @param extents Extents of the tensor.
+     * @param resource Memory resource the buffer was allocated from.
+     */
+    constexpr tensor(T* const data, const array<Order> extents,
+                     std::pmr::memory_resource* const resource) noexcept
+        : m_resource(resource),
+          m_data(data),
+          m_extents(extents),
+          m_size(std::reduce(extents.begin(), extents.end(), size_type{1},
+                             std::multiplies<size_type>())),
+          m_strides(detail::row_major_strides(extents)) {}
+
+    /**
+     * @brief Constructs a tensor by evaluating the expression in a single pass.
+     * @param expr Lazily evaluated expression.
+     */
+    template <expression E>
+        requires(E::order == Order)
+    constexpr tensor(const E& expr) : tensor(expr.extents()) {
+        TENSOR_RECORD(evaluate, m_size);
+        evaluate(expr);
+    }
+
+    /**
+     * @brief Assigns the result of evaluating the expression in a single pass. The existing buffer
+     * is reused when the extents match and the expression only reads it at the element being
+     * written, otherwise a new one comes from the same resource.
+     * @param expr Lazily evaluated expression.
+     */
+    template <expression E>
+        requires(E::order == Order)
+    constexpr auto& operator=(const E& expr) {
+        TENSOR_RECORD(evaluate, expr.size());
+        if (m_extents != expr.extents() || aliased(expr)) {
+            auto result = tensor(expr.extents(), m_resource);
+            result.evaluate(expr);
+            return *this = std::move(result);
         }
+        evaluate(expr);
+        return *this;
     }
 
     /**
@@ -128,21 +287,32 @@ class tensor {
      * @param rhs Right-hand side of the assignment.
      */
     constexpr tensor(const tensor& rhs)
-        : m_data(new T[rhs.m_size]),
+        : m_resource(memory::current_resource()),
+          m_data(nullptr),
           m_extents(rhs.m_extents),
           m_size(rhs.m_size),
           m_strides(rhs.m_strides) {
+        TENSOR_RECORD(copy, m_size);
+        m_data = memory::allocate<T>(m_size, m_resource);
         std::copy(rhs.m_data, rhs.m_data + rhs.m_size, m_data);
+        instrument::copied(m_size * sizeof(T));
     }
 
     /**
-     * @brief Overloads the copy assignment operator.
+     * @brief Overloads the copy assignment operator. The existing buffer is reused when the sizes
+     * match, otherwise it is freed once the new one is allocated.
      * @param rhs Right-hand side of the assignment.
      */
     constexpr auto& operator=(const tensor& rhs) {
         if (this != &rhs) {
-            m_data = new T[rhs.m_size];
+            TENSOR_RECORD(copy_assign, rhs.m_size);
+            if (m_size != rhs.m_size) {
+                auto* data = memory::allocate<T>(rhs.m_size, m_resource);
+                memory::deallocate(m_data, m_size, m_resource);
+                m_data = data;
+            }
             std::copy(rhs.m_data, rhs.m_data + rhs.m_size, m_data);
+            instrument::copied(rhs.m_size * sizeof(T));
 
             m_extents = rhs.m_extents;
             m_size = rhs.m_size;
@@ -152,29 +322,68 @@ class tensor {
     }
 
     /**
-     * @brief Defines a move constructor.
+     * @brief Defines a move constructor. Leaves the right-hand side empty. A buffer from a
+     * `memory::tensor_arena` open on the calling thread is copied into the resource that was the
+     * default when the arena opened instead, as the tensor may outlive the scope, so that moves
+     * within the scope copy too and may throw `std::bad_alloc`, leaving the right-hand side intact.
+     * See `take` for results staying within the scope.
      * @param rhs Right-hand side of the assignment.
      */
-    constexpr tensor(tensor&& rhs) noexcept
-        : m_data{rhs.m_data},
+    constexpr tensor(tensor&& rhs)
+        : m_resource{rhs.m_resource},
+          m_data{rhs.m_data},
           m_extents{rhs.m_extents},
           m_size{rhs.m_size},
           m_strides{rhs.m_strides} {
+        if (!std::is_constant_evaluated()) {
+            if (auto* resource = memory::tensor_arena::upstream(m_resource);
+                resource != m_resource) {
+                m_data = memory::allocate<T>(m_size, resource);
+                std::copy(rhs.m_data, rhs.m_data + m_size, m_data);
+                instrument::copied(m_size * sizeof(T));
+                memory::deallocate(rhs.m_data, rhs.m_size, rhs.m_resource);
+                m_resource = resource;
+            }
+        }
         rhs.m_data = nullptr;
+        rhs.m_extents = {};
+        rhs.m_size = 0;
+        rhs.m_strides = {};
     }
 
     /**
-     * @brief Overloads the move assignment operator.
+     * @brief Moves the tensor into the returned one even if its buffer comes from an open
+     * `memory::tensor_arena`, for returning results that stay within the scope where copy elision
+     * does not apply, e.g. a function returning one of several tensors.
+     * @return The tensor owning the buffer, leaving the expiring one empty.
+     */
+    [[nodiscard]] constexpr tensor take() && noexcept {
+        const auto extents = std::exchange(m_extents, {});
+        m_size = 0;
+        m_strides = {};
+        return tensor(std::exchange(m_data, nullptr), extents, m_resource);
+    }
+
+    /**
+     * @brief Overloads the move assignment operator. Frees the existing buffer and leaves the
+     * right-hand side empty. A buffer from a `memory::tensor_arena` open on the calling thread is
+     * copied instead unless the tensor uses the same arena, as the tensor may outlive the scope,
+     * which may throw `std::bad_alloc` as copy assignment does.
      * @param rhs Right-hand side of the assignment.
      */
-    constexpr auto& operator=(tensor&& rhs) noexcept {
+    constexpr auto& operator=(tensor&& rhs) {
         if (this != &rhs) {
-            m_data = rhs.m_data;
-            m_extents = rhs.m_extents;
-            m_size = rhs.m_size;
-            m_strides = rhs.m_strides;
+            if (!std::is_constant_evaluated() && rhs.m_resource != m_resource &&
+                memory::tensor_arena::is_open(rhs.m_resource)) {
+                return *this = std::as_const(rhs);
+            }
+            memory::deallocate(m_data, m_size, m_resource);
 
-            rhs.m_data = nullptr;
+            m_resource = rhs.m_resource;
+            m_data = std::exchange(rhs.m_data, nullptr);
+            m_extents = std::exchange(rhs.m_extents, {});
+            m_size = std::exchange(rhs.m_size, 0);
+            m_strides = std::exchange(rhs.m_strides, {});
         }
         return *this;
     }
@@ -184,16 +393,29 @@ class tensor {
      * @param rhs Right-hand side of the assignment.
      */
     constexpr ~tensor() {
-        delete[] m_data;
+        memory::deallocate(m_data, m_size, m_resource);
         m_data = nullptr;
     }
 
     /**
-     * @brief Defines an operator for getting raw data.
+     * @brief Defines an operator for getting raw data. Bounds are only checked if
+     * `TENSOR_BOUNDS_CHECK` is enabled, which is the default for builds without `NDEBUG`.
      * @param idx Index for obtaining a value.
      */
     [[nodiscard]] constexpr auto& operator[](const size_type idx) const {
-        if (idx > m_size - 1) {
+#if TENSOR_BOUNDS_CHECK
+        return at(idx);
+#else
+        return m_data[idx];
+#endif
+    }
+
+    /**
+     * @brief Returns raw data at the provided index with bounds checking.
+     * @param idx Index for obtaining a value.
+     */
+    [[nodiscard]] constexpr auto& at(const size_type idx) const {
+        if (idx >= m_size) {
             throw std::out_of_range("Index out of bounds.");
         }
         return m_data[idx];
@@ -207,6 +429,14 @@ class tensor {
         return m_data;
     }
 
+    /**
+     * @brief Returns the memory resource the elements are allocated from.
+     * @return Memory resource, `nullptr` for tensors created during constant evaluation.
+     */
+    [[nodiscard]] constexpr auto resource() const noexcept {
+        return m_resource;
+    }
+
     /**
      * @brief Returns the extents.
      * @return Extents.
@@ -242,129 +472,589 @@ class tensor {
             std::array<size_type, Order - U> extents;
             std::copy(m_extents.begin() + U, m_extents.end(), extents.begin());
 
-            auto offset = std::reduce(m_extents.begin() + idxs.size(), m_extents.end(), 1,
-                                      std::multiplies<int>());
+            const auto offset = std::reduce(m_extents.begin() + U, m_extents.end(), size_type{1},
+                                            std::multiplies<size_type>());
 
+            TENSOR_RECORD(get, offset);
             auto result = tensor<T, Order - U>(extents);
-            for (size_type idx = flat_idx; idx < flat_idx + offset; ++idx) {
-                result[idx - flat_idx] = m_data[idx];
-            }
+            std::copy(m_data + flat_idx, m_data + flat_idx + offset, result.data());
+            instrument::copied(offset * sizeof(T));
 
-            return result;
+            return std::move(result).take();
         }
     }
 
     /**
-     * @brief Helper method for printing a tensor.
-     * @param data Data representation.
-     * @param Extents C-style array representing extents.
-     * @param order Order of a tensor.
+     * @brief Returns a view sharing the data of the tensor, see `tensor_view`.
+     * @return A view of the whole tensor.
      */
-    constexpr const T* __print(const T* data, const size_type* extents, const size_type order) {
-        const char* p_sep = "";
-        std::cout << '{';
-        if (order > 1) {
-            for (size_type idx = 0; idx < extents[0]; ++idx) {
-                std::cout << p_sep;
-                data = __print(data, &extents[1], order - 1);
-                p_sep = ", ";
-            }
-        } else {
-            for (size_type idx = 0; idx < extents[0]; ++idx) {
-                std::cout << p_sep << *data++;
-                p_sep = ", ";
-            }
+    [[nodiscard]] constexpr auto view() noexcept {
+        return tensor_view<T, Order>(m_data, m_extents, m_strides);
+    }
+
+    /**
+     * @brief Returns a read-only view sharing the data of the tensor, see `tensor_view`.
+     * @return A read-only view of the whole tensor.
+     */
+    [[nodiscard]] constexpr auto view() const noexcept {
+        return tensor_view<const T, Order>(m_data, m_extents, m_strides);
+    }
+
+    /**
+     * @brief Returns a view of the sub-tensor at the provided leading indices without copying, in
+     * contrast to `get`.
+     * @param idxs Array of leading indices.
+     * @return A view of order `Order - U`.
+     */
+    template <size_type U>
+        requires(U < Order)
+    [[nodiscard]] constexpr auto slice(const std::array<size_type, U> idxs) {
+        return view().get(idxs);
+    }
+
+    /**
+     * @brief Returns a read-only view of the sub-tensor at the provided leading indices without
+     * copying, in contrast to `get`.
+     * @param idxs Array of leading indices.
+     * @return A read-only view of order `Order - U`.
+     */
+    template <size_type U>
+        requires(U < Order)
+    [[nodiscard]] constexpr auto slice(const std::array<size_type, U> idxs) const {
+        return view().get(idxs);
+    }
+
+    /**
+     * @brief Returns a view with the order of the axes reversed, without copying.
+     * @return A view of the same order.
+     */
+    [[nodiscard]] constexpr auto transpose() noexcept {
+        return view().transpose();
+    }
+
+    /**
+     * @brief Returns a read-only view with the order of the axes reversed, without copying.
+     * @return A read-only view of the same order.
+     */
+    [[nodiscard]] constexpr auto transpose() const noexcept {
+        return view().transpose();
+    }
+
+    /**
+     * @brief Returns a view with the axes reordered, so that axis `idx` of the view is axis
+     * `axes[idx]` of the tensor, without copying. Use `contiguous()` on the view for a copy.
+     * @param axes Permutation of the axes.
+     * @return A view of the same order.
+     */
+    [[nodiscard]] constexpr auto permute(const array<Order> axes) {
+        return view().permute(axes);
+    }
+
+    /**
+     * @brief Returns a read-only view with the axes reordered, so that axis `idx` of the view is
+     * axis `axes[idx]` of the tensor, without copying.
+     * @param axes Permutation of the axes.
+     * @return A read-only view of the same order.
+     */
+    [[nodiscard]] constexpr auto permute(const array<Order> axes) const {
+        return view().permute(axes);
+    }
+
+    /**
+     * @brief Copies the elements into a tensor of the provided extents.
+     * @param extents Extents of as many elements as the tensor holds.
+     * @return New tensor of order `N`.
+     */
+    template <size_type N>
+    [[nodiscard]] constexpr auto reshape(const array<N> extents) const& {
+        return tensor(*this).template reshape<N>(extents);
+    }
+
+    /**
+     * @brief Moves the elements into a tensor of the provided extents in constant time, leaving
+     * the expiring tensor empty.
+     * @param extents Extents of as many elements as the tensor holds.
+     * @return The tensor of order `N` owning the buffer.
+     */
+    template <size_type N>
+    [[nodiscard]] constexpr auto reshape(const array<N> extents) && {
+        if (std::reduce(extents.begin(), extents.end(), size_type{1},
+                        std::multiplies<size_type>()) != m_size) {
+            throw std::runtime_error("Tensor dimension mismatch.");
         }
-        std::cout << '}';
-        return data;
+        auto* data = std::exchange(m_data, nullptr);
+        m_extents = {};
+        m_size = 0;
+        m_strides = {};
+        return tensor<T, N>(data, extents, m_resource);
+    }
+
+    /**
+     * @brief Copies the elements into an order one tensor.
+     * @return New tensor of order one.
+     */
+    [[nodiscard]] constexpr auto flatten() const& {
+        return reshape<1>({m_size});
     }
 
     /**
-     * @brief Prints the tensor via the helper method.
+     * @brief Moves the elements into an order one tensor in constant time, leaving the expiring
+     * tensor empty.
+     * @return The tensor of order one owning the buffer.
      */
-    constexpr void print() {
-        std::cout << "tensor ";
-        (void)__print(m_data, m_extents.data(), Order);
-        std::cout << '\n';
+    [[nodiscard]] constexpr auto flatten() && {
+        return std::move(*this).template reshape<1>({m_size});
+    }
 
-        std::cout << "shape (";
-        if (m_extents.size() == 1) {
-            std::cout << m_extents[0];
-        } else {
-            for (size_type idx = 0; idx < m_extents.size() - 1; ++idx) {
-                std::cout << m_extents[idx] << ", ";
+    /**
+     * @brief Prints the tensor, followed by its shape and size, in a single write. Tensors of more
+     * than `format::threshold()` elements are summarized.
+     * @param out Stream to print to.
+     */
+    void print(std::ostream& out = std::cout) const {
+        std::string str = "tensor ";
+        format::append(str, m_data, m_extents);
+        str += "\nshape (";
+        for (size_type idx = 0; idx < Order; ++idx) {
+            str += idx == 0 ? "" : ", ";
+            format::append(str, m_extents[idx]);
+        }
+        str += ")\nsize ";
+        format::append(str, m_size);
+        str += '\n';
+        format::write(out, str);
+    }
+
+    /**
+     * @brief Prints a flat representation of the tensor in a single write, summarized as by
+     * `print`.
+     * @param out Stream to print to.
+     */
+    void flat_print(std::ostream& out = std::cout) const {
+        std::string str;
+        format::append_flat(str, m_data, m_size);
+        str += '\n';
+        format::write(out, str);
+    }
+
+    /**
+     * @brief Adds the other tensor to the tensor in place, which is broadcast to the extents of
+     * the tensor if they differ.
+     * @param other Other tensor.
+     * @return Reference to the tensor.
+     */
+    constexpr auto& operator+=(const tensor& other) {
+        if (m_extents != other.m_extents) {
+            return *this += broadcast_to(other, m_extents);
+        }
+        TENSOR_RECORD(add_assign, m_size);
+        kernel::transform(m_data, m_data, other.m_data, m_size, op::add{});
+        return *this;
+    }
+
+    /**
+     * @brief Adds the other tensor of lower order to the tensor in place, broadcasting it to the
+     * extents of the tensor.
+     * @param other Other tensor.
+     * @return Reference to the tensor.
+     */
+    template <size_type U>
+        requires(U < Order)
+    constexpr auto& operator+=(const tensor<T, U>& other) {
+        return *this += broadcast_to(other, m_extents);
+    }
+
+    /**
+     * @brief Subtracts the other tensor from the tensor in place, which is broadcast to the
+     * extents of the tensor if they differ.
+     * @param other Other tensor.
+     * @return Reference to the tensor.
+     */
+    constexpr auto& operator-=(const tensor& other) {
+        if (m_extents != other.m_extents) {
+            return *this -= broadcast_to(other, m_extents);
+        }
+        TENSOR_RECORD(subtract_assign, m_size);
+        kernel::transform(m_data, m_data, other.m_data, m_size, op::sub{});
+        return *this;
+    }
+
+    /**
+     * @brief Subtracts the other tensor of lower order from the tensor in place, broadcasting it
+     * to the extents of the tensor.
+     * @param other Other tensor.
+     * @return Reference to the tensor.
+     */
+    template <size_type U>
+        requires(U < Order)
+    constexpr auto& operator-=(const tensor<T, U>& other) {
+        return *this -= broadcast_to(other, m_extents);
+    }
+
+    /**
+     * @brief Multiplies the tensor by the other tensor in place, which is broadcast to the
+     * extents of the tensor if they differ.
+     * @param other Other tensor.
+     * @return Reference to the tensor.
+     */
+    constexpr auto& operator*=(const tensor& other) {
+        if (m_extents != other.m_extents) {
+            return *this *= broadcast_to(other, m_extents);
+        }
+        TENSOR_RECORD(multiply_assign, m_size);
+        kernel::transform(m_data, m_data, other.m_data, m_size, op::mul{});
+        return *this;
+    }
+
+    /**
+     * @brief Multiplies the tensor by the other tensor of lower order in place, broadcasting it
+     * to the extents of the tensor.
+     * @param other Other tensor.
+     * @return Reference to the tensor.
+     */
+    template <size_type U>
+        requires(U < Order)
+    constexpr auto& operator*=(const tensor<T, U>& other) {
+        return *this *= broadcast_to(other, m_extents);
+    }
+
+    /**
+     * @brief Divides the tensor by the other tensor in place, which is broadcast to the extents of
+     * the tensor if they differ. The tensor is left untouched if the other tensor holds a zero.
+     * @param other Other tensor.
+     * @return Reference to the tensor.
+     */
+    constexpr auto& operator/=(const tensor& other) {
+        if (m_extents != other.m_extents) {
+            const auto expr = broadcast_to(other, m_extents);
+            if (std::find(other.m_data, other.m_data + other.m_size, T{0}) !=
+                other.m_data + other.m_size) {
+                throw std::domain_error("Division by zero.");
             }
-            std::cout << m_extents.back();
+            return *this /= expr;
         }
-        std::cout << ')' << '\n';
+        TENSOR_RECORD(divide_assign, m_size);
+        if (std::find(other.m_data, other.m_data + m_size, T{0}) != other.m_data + m_size) {
+            throw std::domain_error("Division by zero.");
+        }
+        kernel::transform(m_data, m_data, other.m_data, m_size, op::div{});
+        return *this;
+    }
 
-        std::cout << "size " << m_size << '\n';
+    /**
+     * @brief Divides the tensor by the other tensor of lower order in place, which is broadcast to
+     * the extents of the tensor. The tensor is left untouched if the other tensor holds a zero.
+     * @param other Other tensor.
+     * @return Reference to the tensor.
+     */
+    template <size_type U>
+        requires(U < Order)
+    constexpr auto& operator/=(const tensor<T, U>& other) {
+        const auto expr = broadcast_to(other, m_extents);
+        if (std::find(other.data(), other.data() + other.size(), T{0}) !=
+            other.data() + other.size()) {
+            throw std::domain_error("Division by zero.");
+        }
+        return *this /= expr;
     }
 
     /**
-     * @brief Prints a flat representation of the tensor.
+     * @brief Broadcasts in-place addition via the specified value.
+     * @param val Value to be added to every element of the tensor.
+     * @return Reference to the tensor.
      */
-    constexpr void flat_print() const {
-        std::cout << '{' << ' ';
-        for (size_type idx = 0; idx < m_size; ++idx) {
-            std::cout << m_data[idx] << ' ';
+    constexpr auto& operator+=(const arithmetic auto& val) {
+        TENSOR_RECORD(add_assign, m_size);
+        kernel::transform(m_data, m_data, val, m_size, op::add{});
+        return *this;
+    }
+
+    /**
+     * @brief Broadcasts in-place subtraction via the specified value.
+     * @param val Value to be subtracted from every element of the tensor.
+     * @return Reference to the tensor.
+     */
+    constexpr auto& operator-=(const arithmetic auto& val) {
+        TENSOR_RECORD(subtract_assign, m_size);
+        kernel::transform(m_data, m_data, val, m_size, op::sub{});
+        return *this;
+    }
+
+    /**
+     * @brief Broadcasts in-place multiplication via the specified value.
+     * @param val Value to be multiplied by every element of the tensor.
+     * @return Reference to the tensor.
+     */
+    constexpr auto& operator*=(const arithmetic auto& val) {
+        TENSOR_RECORD(multiply_assign, m_size);
+        kernel::transform(m_data, m_data, val, m_size, op::mul{});
+        return *this;
+    }
+
+    /**
+     * @brief Broadcasts in-place division via the specified value.
+     * @param val Value to be divided by every element of the tensor.
+     * @return Reference to the tensor.
+     */
+    constexpr auto& operator/=(const arithmetic auto& val) {
+        TENSOR_RECORD(divide_assign, m_size);
+        if (val == 0) {
+            throw std::domain_error("Division by zero.");
         }
-        std::cout << '}' << std::endl;
+        kernel::transform(m_data, m_data, val, m_size, op::div{});
+        return *this;
+    }
+
+    /**
+     * @brief Adds the expression to the tensor in place in a single pass, broadcasting it to the
+     * extents of the tensor if they differ.
+     * @param expr Lazily evaluated expression or view.
+     * @return Reference to the tensor.
+     */
+    template <expression E>
+        requires(E::order <= Order)
+    constexpr auto& operator+=(const E& expr) {
+        TENSOR_RECORD(add_assign, m_size);
+        update(expr, op::add{});
+        return *this;
+    }
+
+    /**
+     * @brief Subtracts the expression from the tensor in place in a single pass, broadcasting it to
+     * the extents of the tensor if they differ.
+     * @param expr Lazily evaluated expression or view.
+     * @return Reference to the tensor.
+     */
+    template <expression E>
+        requires(E::order <= Order)
+    constexpr auto& operator-=(const E& expr) {
+        TENSOR_RECORD(subtract_assign, m_size);
+        update(expr, op::sub{});
+        return *this;
     }
 
     /**
-     * @brief Adds the other tensor to the tensor.
+     * @brief Multiplies the tensor by the expression in place in a single pass, broadcasting it to
+     * the extents of the tensor if they differ.
+     * @param expr Lazily evaluated expression or view.
+     * @return Reference to the tensor.
+     */
+    template <expression E>
+        requires(E::order <= Order)
+    constexpr auto& operator*=(const E& expr) {
+        TENSOR_RECORD(multiply_assign, m_size);
+        update(expr, op::mul{});
+        return *this;
+    }
+
+    /**
+     * @brief Divides the tensor by the expression in place in a single pass, broadcasting it to the
+     * extents of the tensor if they differ.
+     * @param expr Lazily evaluated expression or view.
+     * @return Reference to the tensor.
+     */
+    template <expression E>
+        requires(E::order <= Order)
+    constexpr auto& operator/=(const E& expr) {
+        TENSOR_RECORD(divide_assign, m_size);
+        update(expr, op::div{});
+        return *this;
+    }
+
+    /**
+     * @brief Adds the other tensor to the tensor, broadcasting both to common extents if they
+     * differ.
      * @param other Other tensor.
      * @return New tensor representing the result of the addition.
      */
-    [[nodiscard]] constexpr auto operator+(const tensor& other) const {
+    [[nodiscard]] constexpr auto operator+(const tensor& other) const& {
+        TENSOR_RECORD(add, m_size);
+        if (m_extents != other.m_extents) {
+            return tensor(lazy(*this) + other);
+        }
         auto result = *this;
-        for (size_type idx = 0; idx < result.size(); ++idx) {
-            result[idx] += other[idx];
+        result += other;
+        return std::move(result).take();
+    }
+
+    /**
+     * @brief Adds the other tensor to the tensor, broadcasting both to common extents if they
+     * differ and reusing the buffer of the expiring tensor if its extents are the common ones.
+     * @param other Other tensor.
+     * @return The tensor holding the result of the addition.
+     */
+    [[nodiscard]] constexpr auto operator+(const tensor& other) && {
+        TENSOR_RECORD(add, m_size);
+        if (m_extents != other.m_extents) {
+            const auto expr = lazy(*this) + other;
+            if (expr.extents() != m_extents) {
+                return tensor(expr);
+            }
+            kernel::evaluate(m_data, expr, m_size);
+        } else {
+            *this += other;
         }
-        return result;
+        return std::move(*this).take();
     }
 
     /**
-     * @brief Subtracts the other tensor from the tensor.
+     * @brief Adds the other tensor of a different order to the tensor, broadcasting both to common
+     * extents.
+     * @param other Other tensor.
+     * @return New tensor representing the result of the addition.
+     */
+    template <size_type U>
+        requires(U != Order)
+    [[nodiscard]] constexpr auto operator+(const tensor<T, U>& other) const {
+        TENSOR_RECORD(add, m_size);
+        return (lazy(*this) + other).eval();
+    }
+
+    /**
+     * @brief Subtracts the other tensor from the tensor, broadcasting both to common extents if
+     * they differ.
      * @param other Other tensor.
      * @return New tensor representing the result of the subtraction.
      */
-    [[nodiscard]] constexpr auto operator-(const tensor& other) const {
+    [[nodiscard]] constexpr auto operator-(const tensor& other) const& {
+        TENSOR_RECORD(subtract, m_size);
+        if (m_extents != other.m_extents) {
+            return tensor(lazy(*this) - other);
+        }
         auto result = *this;
-        for (size_type idx = 0; idx < result.size(); ++idx) {
-            result[idx] -= other[idx];
+        result -= other;
+        return std::move(result).take();
+    }
+
+    /**
+     * @brief Subtracts the other tensor from the tensor, broadcasting both to common extents if
+     * they differ and reusing the buffer of the expiring tensor if its extents are the common ones.
+     * @param other Other tensor.
+     * @return The tensor holding the result of the subtraction.
+     */
+    [[nodiscard]] constexpr auto operator-(const tensor& other) && {
+        TENSOR_RECORD(subtract, m_size);
+        if (m_extents != other.m_extents) {
+            const auto expr = lazy(*this) - other;
+            if (expr.extents() != m_extents) {
+                return tensor(expr);
+            }
+            kernel::evaluate(m_data, expr, m_size);
+        } else {
+            *this -= other;
         }
-        return result;
+        return std::move(*this).take();
     }
 
     /**
-     * @brief Multiplies the tensor by the other tensor.
+     * @brief Subtracts the other tensor of a different order from the tensor, broadcasting both to
+     * common extents.
+     * @param other Other tensor.
+     * @return New tensor representing the result of the subtraction.
+     */
+    template <size_type U>
+        requires(U != Order)
+    [[nodiscard]] constexpr auto operator-(const tensor<T, U>& other) const {
+        TENSOR_RECORD(subtract, m_size);
+        return (lazy(*this) - other).eval();
+    }
+
+    /**
+     * @brief Multiplies the tensor by the other tensor, broadcasting both to common extents if they
+     * differ.
      * @param other Other tensor.
      * @return New tensor representing the result of the multiplication.
      */
-    [[nodiscard]] constexpr auto operator*(const tensor& other) const {
+    [[nodiscard]] constexpr auto operator*(const tensor& other) const& {
+        TENSOR_RECORD(multiply, m_size);
+        if (m_extents != other.m_extents) {
+            return tensor(lazy(*this) * other);
+        }
         auto result = *this;
-        for (size_type idx = 0; idx < result.size(); ++idx) {
-            result[idx] *= other[idx];
+        result *= other;
+        return std::move(result).take();
+    }
+
+    /**
+     * @brief Multiplies the tensor by the other tensor, broadcasting both to common extents if they
+     * differ and reusing the buffer of the expiring tensor if its extents are the common ones.
+     * @param other Other tensor.
+     * @return The tensor holding the result of the multiplication.
+     */
+    [[nodiscard]] constexpr auto operator*(const tensor& other) && {
+        TENSOR_RECORD(multiply, m_size);
+        if (m_extents != other.m_extents) {
+            const auto expr = lazy(*this) * other;
+            if (expr.extents() != m_extents) {
+                return tensor(expr);
+            }
+            kernel::evaluate(m_data, expr, m_size);
+        } else {
+            *this *= other;
         }
-        return result;
+        return std::move(*this).take();
     }
 
     /**
-     * @brief Divides the tensor by the other tensor.
+     * @brief Multiplies the tensor by the other tensor of a different order, broadcasting both to
+     * common extents.
+     * @param other Other tensor.
+     * @return New tensor representing the result of the multiplication.
+     */
+    template <size_type U>
+        requires(U != Order)
+    [[nodiscard]] constexpr auto operator*(const tensor<T, U>& other) const {
+        TENSOR_RECORD(multiply, m_size);
+        return (lazy(*this) * other).eval();
+    }
+
+    /**
+     * @brief Divides the tensor by the other tensor, broadcasting both to common extents if they
+     * differ.
      * @param other Other tensor.
      * @return New tensor representing the result of the division.
      */
-    [[nodiscard]] constexpr auto operator/(const tensor& other) const {
+    [[nodiscard]] constexpr auto operator/(const tensor& other) const& {
+        TENSOR_RECORD(divide, m_size);
+        if (m_extents != other.m_extents) {
+            return tensor(lazy(*this) / other);
+        }
         auto result = *this;
-        for (size_type idx = 0; idx < result.size(); ++idx) {
-            if (other[idx] == 0) {
-                throw std::domain_error("Division by zero.");
+        result /= other;
+        return std::move(result).take();
+    }
+
+    /**
+     * @brief Divides the tensor by the other tensor, broadcasting both to common extents if they
+     * differ and reusing the buffer of the expiring tensor if its extents are the common ones.
+     * @param other Other tensor.
+     * @return The tensor holding the result of the division.
+     */
+    [[nodiscard]] constexpr auto operator/(const tensor& other) && {
+        TENSOR_RECORD(divide, m_size);
+        if (m_extents != other.m_extents) {
+            const auto expr = lazy(*this) / other;
+            if (expr.extents() != m_extents) {
+                return tensor(expr);
             }
-            result[idx] /= other[idx];
+            kernel::evaluate(m_data, expr, m_size);
+        } else {
+            *this /= other;
         }
-        return result;
+        return std::move(*this).take();
+    }
+
+    /**
+     * @brief Divides the tensor by the other tensor of a different order, broadcasting both to
+     * common extents.
+     * @param other Other tensor.
+     * @return New tensor representing the result of the division.
+     */
+    template <size_type U>
+        requires(U != Order)
+    [[nodiscard]] constexpr auto operator/(const tensor<T, U>& other) const {
+        TENSOR_RECORD(divide, m_size);
+        return (lazy(*this) / other).eval();
     }
 
     /**
@@ -372,94 +1062,121 @@ class tensor {
      * @param val Value to be added to every element of the tensor.
      * @return Result tensor with every value incremented by `val`.
      */
-    [[nodiscard]] constexpr auto operator+(const arithmetic auto& val) const {
+    [[nodiscard]] constexpr auto operator+(const arithmetic auto& val) const& {
+        TENSOR_RECORD(add, m_size);
         auto result = *this;
-        for (size_type idx = 0; idx < result.size(); ++idx) {
-            result[idx] += val;
-        }
+        result += val;
         return result;
     }
 
+    /**
+     * @brief Broadcasts addition via the specified value, reusing the buffer of the expiring
+     * tensor.
+     * @param val Value to be added to every element of the tensor.
+     * @return The tensor with every value incremented by `val`.
+     */
+    [[nodiscard]] constexpr auto operator+(const arithmetic auto& val) && {
+        TENSOR_RECORD(add, m_size);
+        *this += val;
+        return std::move(*this).take();
+    }
+
     /**
      * @brief Broadcasts subtraction via the specified value.
      * @param val Value to be subtracted from every element of the tensor.
      * @return Result tensor with every value decremented by `val`.
      */
-    [[nodiscard]] constexpr auto operator-(const arithmetic auto& val) const {
+    [[nodiscard]] constexpr auto operator-(const arithmetic auto& val) const& {
+        TENSOR_RECORD(subtract, m_size);
         auto result = *this;
-        for (size_type idx = 0; idx < result.size(); ++idx) {
-            result[idx] -= val;
-        }
+        result -= val;
         return result;
     }
 
+    /**
+     * @brief Broadcasts subtraction via the specified value, reusing the buffer of the expiring
+     * tensor.
+     * @param val Value to be subtracted from every element of the tensor.
+     * @return The tensor with every value decremented by `val`.
+     */
+    [[nodiscard]] constexpr auto operator-(const arithmetic auto& val) && {
+        TENSOR_RECORD(subtract, m_size);
+        *this -= val;
+        return std::move(*this).take();
+    }
+
     /**
      * @brief Broadcasts multiplication via the specified value.
      * @param val Value to be multiplied by every element of the tensor.
      * @return Result tensor with every value multiplied by `val`.
      */
-    [[nodiscard]] constexpr auto operator*(const arithmetic auto& val) const {
+    [[nodiscard]] constexpr auto operator*(const arithmetic auto& val) const& {
+        TENSOR_RECORD(multiply, m_size);
         auto result = *this;
-        for (size_type idx = 0; idx < result.size(); ++idx) {
-            result[idx] *= val;
-        }
+        result *= val;
         return result;
     }
 
+    /**
+     * @brief Broadcasts multiplication via the specified value, reusing the buffer of the expiring
+     * tensor.
+     * @param val Value to be multiplied by every element of the tensor.
+     * @return The tensor with every value multiplied by `val`.
+     */
+    [[nodiscard]] constexpr auto operator*(const arithmetic auto& val) && {
+        TENSOR_RECORD(multiply, m_size);
+        *this *= val;
+        return std::move(*this).take();
+    }
+
     /**
      * @brief Broadcasts division via the specified value.
      * @param val Value to be divided by every element of the tensor.
      * @return Result tensor with every value divided by `val`.
      */
-    [[nodiscard]] constexpr auto operator/(const arithmetic auto& val) const {
-        if (val == 0) {
-            throw std::domain_error("Division by zero.");
-        }
+    [[nodiscard]] constexpr auto operator/(const arithmetic auto& val) const& {
+        TENSOR_RECORD(divide, m_size);
         auto result = *this;
-        for (size_type idx = 0; idx < result.size(); ++idx) {
-            result[idx] /= val;
-        }
+        result /= val;
         return result;
     }
 
+    /**
+     * @brief Broadcasts division via the specified value, reusing the buffer of the expiring
+     * tensor.
+     * @param val Value to be divided by every element of the tensor.
+     * @return The tensor with every value divided by `val`.
+     */
+    [[nodiscard]] constexpr auto operator/(const arithmetic auto& val) && {
+        TENSOR_RECORD(divide, m_size);
+        *this /= val;
+        return std::move(*this).take();
+    }
+
     /**
      * @brief Returns true if the tensor is equal to the other tensor, false otherwise.
      * @param other Other tensor.
      * @return `true` if the comparison holds, `false` otherwise.
      */
     [[nodiscard]] constexpr auto operator==(const tensor& other) const {
+        TENSOR_RECORD(compare, m_size);
         if (m_size != other.size()) {
             return false;
         }
         if (m_extents != other.extents()) {
             return false;
         }
-        for (size_type idx = 0; idx < m_size; ++idx) {
-            if (m_data[idx] != other[idx]) {
-                return false;
-            }
-        }
-        return true;
+        return kernel::all_of(m_data, other.m_data, m_size, op::equal{});
     }
 
     /**
-     * @brief Returns true if the tensor is not equal to the other tensor, false otherwise.
+     * @brief Returns true if the extents or any element differ, false otherwise. Use
+     * `core::not_equal` for the element-wise comparison.
      * @param other Other tensor.
      * @return `true` if the comparison holds, `false` otherwise.
      */
     [[nodiscard]] constexpr auto operator!=(const tensor& other) const {
-        if (m_size != other.size()) {
-            return true;
-        }
-        if (m_extents != other.extents()) {
-            return true;
-        }
-        for (size_type idx = 0; idx < m_size; ++idx) {
-            if (m_data[idx] == other[idx]) {
-                return false;
-            }
-        }
-        return true;
+        return !(*this == other);
     }
 
     /**
@@ -468,18 +1185,14 @@ class tensor {
      * @return `true` if the comparison holds, `false` otherwise.
      */
     [[nodiscard]] constexpr auto operator>(const tensor& other) const {
+        TENSOR_RECORD(compare, m_size);
         if (m_size != other.size()) {
             throw std::runtime_error("Tensor size mismatch.");
         }
         if (m_extents != other.extents()) {
             throw std::runtime_error("Tensor dimension mismatch.");
         }
-        for (size_type idx = 0; idx < m_size; ++idx) {
-            if (m_data[idx] <= other[idx]) {
-                return false;
-            }
-        }
-        return true;
+        return kernel::all_of(m_data, other.m_data, m_size, op::greater{});
     }
 
     /**
@@ -488,15 +1201,14 @@ class tensor {
      * @return `true` if the comparison holds, `false` otherwise.
      */
     [[nodiscard]] constexpr auto operator>=(const tensor& other) const {
+        TENSOR_RECORD(compare, m_size);
         if (m_size != other.size()) {
             throw std::runtime_error("Tensor size mismatch.");
         }
-        for (size_type idx = 0; idx < m_size; ++idx) {
-            if (m_data[idx] < other[idx]) {
-                return false;
-            }
+        if (m_extents != other.extents()) {
+            throw std::runtime_error("Tensor dimension mismatch.");
         }
-        return true;
+        return kernel::all_of(m_data, other.m_data, m_size, op::greater_equal{});
     }
 
     /**
@@ -505,18 +1217,14 @@ class tensor {
      * @return `true` if the comparison holds, `false` otherwise.
      */
     [[nodiscard]] constexpr auto operator<(const tensor& other) const {
+        TENSOR_RECORD(compare, m_size);
         if (m_size != other.size()) {
             throw std::runtime_error("Tensor size mismatch.");
         }
         if (m_extents != other.extents()) {
             throw std::runtime_error("Tensor dimension mismatch.");
         }
-        for (size_type idx = 0; idx < m_size; ++idx) {
-            if (m_data[idx] >= other[idx]) {
-                return false;
-            }
-        }
-        return true;
+        return kernel::all_of(m_data, other.m_data, m_size, op::less{});
     }
 
     /**
@@ -525,18 +1233,14 @@ class tensor {
      * @return `true` if the comparison holds, `false` otherwise.
      */
     [[nodiscard]] constexpr auto operator<=(const tensor& other) const {
+        TENSOR_RECORD(compare, m_size);
         if (m_size != other.size()) {
             throw std::runtime_error("Tensor size mismatch.");
         }
         if (m_extents != other.extents()) {
             throw std::runtime_error("Tensor dimension mismatch.");
         }
-        for (size_type idx = 0; idx < m_size; ++idx) {
-            if (m_data[idx] > other[idx]) {
-                return false;
-            }
-        }
-        return true;
+        return kernel::all_of(m_data, other.m_data, m_size, op::less_equal{});
     }
 
     /**
@@ -544,84 +1248,245 @@ class tensor {
      * @param exp Exponent.
      * @return Tensor with every value transformed via the power function.
      */
-    [[nodiscard]] constexpr auto pow(const arithmetic auto exp) const {
-        auto result = *this;
-        for (size_type idx = 0; idx < result.size(); ++idx) {
-            result[idx] = std::pow(result[idx], exp);
-        }
-        return result;
+    [[nodiscard]] constexpr auto pow(const arithmetic auto exp) const& {
+        return tensor(*this).pow(exp);
+    }
+
+    /**
+     * @brief Broadcasts the power operation across the tensor in place, reusing the buffer of the
+     * expiring tensor.
+     * @param exp Exponent.
+     * @return The tensor with every value transformed via the power function.
+     */
+    [[nodiscard]] constexpr auto pow(const arithmetic auto exp) && {
+        TENSOR_RECORD(pow, m_size);
+        using E = std::remove_cvref_t<decltype(exp)>;
+        kernel::transform(m_data, m_data, m_size, op::pow<E>{exp});
+        return std::move(*this).take();
     }
 
     /**
      * @brief Broadcasts the square operation across the tensor.
      * @return Tensor with every value transformed via the square function.
      */
-    [[nodiscard]] constexpr auto square() const {
-        auto result = *this;
-        for (size_type idx = 0; idx < result.size(); ++idx) {
-            result[idx] = std::pow(result[idx], 2);
-        }
-        return result;
+    [[nodiscard]] constexpr auto square() const& {
+        return tensor(*this).square();
+    }
+
+    /**
+     * @brief Broadcasts the square operation across the tensor in place, reusing the buffer of the
+     * expiring tensor.
+     * @return The tensor with every value transformed via the square function.
+     */
+    [[nodiscard]] constexpr auto square() && {
+        TENSOR_RECORD(square, m_size);
+        kernel::transform(m_data, m_data, m_size, op::square{});
+        return std::move(*this).take();
     }
 
     /**
      * @brief Broadcasts the square root operation across the tensor.
      * @return Tensor with every value transformed via the square root function.
      */
-    [[nodiscard]] constexpr auto sqrt() const {
-        auto result = *this;
-        for (size_type idx = 0; idx < result.size(); ++idx) {
-            result[idx] = std::sqrt(result[idx]);
-        }
-        return result;
+    [[nodiscard]] constexpr auto sqrt() const& {
+        return tensor(*this).sqrt();
+    }
+
+    /**
+     * @brief Broadcasts the square root operation across the tensor in place, reusing the buffer of
+     * the expiring tensor.
+     * @return The tensor with every value transformed via the square root function.
+     */
+    [[nodiscard]] constexpr auto sqrt() && {
+        TENSOR_RECORD(sqrt, m_size);
+        kernel::transform(m_data, m_data, m_size, op::sqrt{});
+        return std::move(*this).take();
     }
 
     /**
      * @brief Broadcasts the sine operation across the tensor.
      * @return Tensor with every value transformed via the sine function.
      */
-    [[nodiscard]] constexpr auto sin() const {
-        auto result = *this;
-        for (size_type idx = 0; idx < result.size(); ++idx) {
-            result[idx] = std::sin(result[idx]);
-        }
-        return result;
+    [[nodiscard]] constexpr auto sin() const& {
+        return tensor(*this).sin();
+    }
+
+    /**
+     * @brief Broadcasts the sine operation across the tensor in place, reusing the buffer of the
+     * expiring tensor.
+     * @return The tensor with every value transformed via the sine function.
+     */
+    [[nodiscard]] constexpr auto sin() && {
+        TENSOR_RECORD(sin, m_size);
+        kernel::transform(m_data, m_data, m_size, op::sin{});
+        return std::move(*this).take();
     }
 
     /**
      * @brief Broadcasts the cosine operation across the tensor.
      * @return Tensor with every value transformed via the cosine function.
      */
-    [[nodiscard]] constexpr auto cos() const {
-        auto result = *this;
-        for (size_type idx = 0; idx < result.size(); ++idx) {
-            result[idx] = std::cos(result[idx]);
-        }
-        return result;
+    [[nodiscard]] constexpr auto cos() const& {
+        return tensor(*this).cos();
+    }
+
+    /**
+     * @brief Broadcasts the cosine operation across the tensor in place, reusing the buffer of the
+     * expiring tensor.
+     * @return The tensor with every value transformed via the cosine function.
+     */
+    [[nodiscard]] constexpr auto cos() && {
+        TENSOR_RECORD(cos, m_size);
+        kernel::transform(m_data, m_data, m_size, op::cos{});
+        return std::move(*this).take();
     }
 
     /**
      * @brief Broadcasts the tangent operation across the tensor.
      * @return Tensor with every value transformed via the tangent function.
      */
-    [[nodiscard]] constexpr auto tan() const {
-        auto result = *this;
-        for (size_type idx = 0; idx < result.size(); ++idx) {
-            result[idx] = std::tan(result[idx]);
-        }
-        return result;
+    [[nodiscard]] constexpr auto tan() const& {
+        return tensor(*this).tan();
+    }
+
+    /**
+     * @brief Broadcasts the tangent operation across the tensor in place, reusing the buffer of the
+     * expiring tensor.
+     * @return The tensor with every value transformed via the tangent function.
+     */
+    [[nodiscard]] constexpr auto tan() && {
+        TENSOR_RECORD(tan, m_size);
+        kernel::transform(m_data, m_data, m_size, op::tan{});
+        return std::move(*this).take();
     }
 
     /**
      * @brief Broadcasts the round operation across the tensor.
      * @return Tensor with every value transformed via the round function.
      */
-    [[nodiscard]] constexpr auto round() const {
-        auto result = *this;
-        for (size_type idx = 0; idx < result.size(); ++idx) {
-            result[idx] = std::round(result[idx]);
-        }
-        return result;
+    [[nodiscard]] constexpr auto round() const& {
+        return tensor(*this).round();
+    }
+
+    /**
+     * @brief Broadcasts the round operation across the tensor in place, reusing the buffer of the
+     * expiring tensor.
+     * @return The tensor with every value transformed via the round function.
+     */
+    [[nodiscard]] constexpr auto round() && {
+        TENSOR_RECORD(round, m_size);
+        kernel::transform(m_data, m_data, m_size, op::round{});
+        return std::move(*this).take();
+    }
+
+    /**
+     * @brief Broadcasts the exponential operation across the tensor.
+     * @return Tensor with every value transformed via the exponential function.
+     */
+    [[nodiscard]] constexpr auto exp() const& {
+        return tensor(*this).exp();
+    }
+
+    /**
+     * @brief Broadcasts the exponential operation across the tensor in place, reusing the buffer
+     * of the expiring tensor.
+     * @return The tensor with every value transformed via the exponential function.
+     */
+    [[nodiscard]] constexpr auto exp() && {
+        TENSOR_RECORD(exp, m_size);
+        kernel::transform(m_data, m_data, m_size, op::exp{});
+        return std::move(*this).take();
+    }
+
+    /**
+     * @brief Broadcasts the natural logarithm operation across the tensor.
+     * @return Tensor with every value transformed via the natural logarithm function.
+     */
+    [[nodiscard]] constexpr auto log() const& {
+        return tensor(*this).log();
+    }
+
+    /**
+     * @brief Broadcasts the natural logarithm operation across the tensor in place, reusing the
+     * buffer of the expiring tensor.
+     * @return The tensor with every value transformed via the natural logarithm function.
+     */
+    [[nodiscard]] constexpr auto log() && {
+        TENSOR_RECORD(log, m_size);
+        kernel::transform(m_data, m_data, m_size, op::log{});
+        return std::move(*this).take();
+    }
+
+    /**
+     * @brief Broadcasts the hyperbolic tangent operation across the tensor.
+     * @return Tensor with every value transformed via the hyperbolic tangent function.
+     */
+    [[nodiscard]] constexpr auto tanh() const& {
+        return tensor(*this).tanh();
+    }
+
+    /**
+     * @brief Broadcasts the hyperbolic tangent operation across the tensor in place, reusing the
+     * buffer of the expiring tensor.
+     * @return The tensor with every value transformed via the hyperbolic tangent function.
+     */
+    [[nodiscard]] constexpr auto tanh() && {
+        TENSOR_RECORD(tanh, m_size);
+        kernel::transform(m_data, m_data, m_size, op::tanh{});
+        return std::move(*this).take();
+    }
+
+    /**
+     * @brief Broadcasts the absolute value operation across the tensor.
+     * @return Tensor with every value transformed via the absolute value function.
+     */
+    [[nodiscard]] constexpr auto abs() const& {
+        return tensor(*this).abs();
+    }
+
+    /**
+     * @brief Broadcasts the absolute value operation across the tensor in place, reusing the buffer
+     * of the expiring tensor.
+     * @return The tensor with every value transformed via the absolute value function.
+     */
+    [[nodiscard]] constexpr auto abs() && {
+        TENSOR_RECORD(abs, m_size);
+        kernel::transform(m_data, m_data, m_size, op::abs{});
+        return std::move(*this).take();
+    }
+
+    /**
+     * @brief Broadcasts the callable across the tensor. Results are converted to the value type.
+     * @param func Callable taking a value, wrapped in `op::packed` if it also accepts SIMD packs.
+     * @return Tensor with every value transformed via the callable.
+     */
+    template <typename F>
+    [[nodiscard]] constexpr auto map(const F func) const& {
+        return tensor(*this).map(func);
+    }
+
+    /**
+     * @brief Broadcasts the callable across the tensor in place, reusing the buffer of the expiring
+     * tensor.
+     * @param func Callable taking a value, wrapped in `op::packed` if it also accepts SIMD packs.
+     * @return The tensor with every value transformed via the callable.
+     */
+    template <typename F>
+    [[nodiscard]] constexpr auto map(const F func) && {
+        transform_inplace(func);
+        return std::move(*this).take();
+    }
+
+    /**
+     * @brief Replaces every value of the tensor by the result of the callable.
+     * @param func Callable taking a value, wrapped in `op::packed` if it also accepts SIMD packs.
+     * @return Reference to the tensor.
+     */
+    template <typename F>
+    constexpr auto& transform_inplace(const F func) {
+        TENSOR_RECORD(transform_inplace, m_size);
+        kernel::transform(m_data, m_data, m_size, op::map<F>{func});
+        return *this;
     }
 };
 
@@ -0,0 +1,687 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2022 David Oniani
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef EINSUM_HPP
+#define EINSUM_HPP
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "linalg.hpp"
+
+namespace core {
+
+namespace detail {
+
+/**
+ * @brief Holds a string literal so that it can be passed as a template argument.
+ */
+template <size_type N>
+struct fixed_string {
+    char value[N];
+
+    constexpr fixed_string(const char (&str)[N]) noexcept {
+        std::copy_n(str, N, value);
+    }
+
+    [[nodiscard]] constexpr std::string_view view() const noexcept {
+        return {value, N - 1};
+    }
+};
+
+/**
+ * @brief Parses subscripts such as "bij,bjk->bik". Without an arrow the output holds the labels
+ * that appear exactly once, in alphabetical order.
+ */
+struct einsum_spec {
+    static constexpr size_type max_labels = 52;
+
+    [[nodiscard]] static constexpr bool is_label(const char c) noexcept {
+        return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+    }
+
+    [[nodiscard]] static constexpr size_type index(const char c) noexcept {
+        return c >= 'a' ? static_cast<size_type>(c - 'a') : static_cast<size_type>(c - 'A') + 26;
+    }
+
+    [[nodiscard]] static constexpr char label(const size_type idx) noexcept {
+        return idx < 26 ? static_cast<char>('a' + idx) : static_cast<char>('A' + (idx - 26));
+    }
+
+    // Hand-written rather than `std::string_view::find`, which GCC 12 fails to evaluate on template
+    // argument objects.
+    [[nodiscard]] static constexpr size_type find(const std::string_view str, const char c,
+                                                  const size_type pos = 0) noexcept {
+        for (size_type idx = pos; idx < str.size(); ++idx) {
+            if (str[idx] == c) {
+                return idx;
+            }
+        }
+        return std::string_view::npos;
+    }
+
+    [[nodiscard]] static constexpr size_type arrow(const std::string_view spec) noexcept {
+        const auto idx = find(spec, '-');
+        return idx + 1 < spec.size() && spec[idx + 1] == '>' ? idx : std::string_view::npos;
+    }
+
+    [[nodiscard]] static constexpr std::string_view inputs(const std::string_view spec) noexcept {
+        return spec.substr(0, std::min(arrow(spec), spec.size()));
+    }
+
+    [[nodiscard]] static constexpr size_type terms(const std::string_view spec) noexcept {
+        const auto in = inputs(spec);
+        return static_cast<size_type>(std::count(in.begin(), in.end(), ',')) + 1;
+    }
+
+    [[nodiscard]] static constexpr std::string_view term(const std::string_view spec,
+                                                         size_type idx) noexcept {
+        auto in = inputs(spec);
+        for (; idx > 0; --idx) {
+            in.remove_prefix(find(in, ',') + 1);
+        }
+        return in.substr(0, std::min(find(in, ','), in.size()));
+    }
+
+    /**
+     * @brief Labels of the output, held in a fixed buffer so that they are usable in constant
+     * expressions.
+     */
+    struct labels {
+        std::array<char, max_labels> value{};
+        size_type size{0};
+
+        [[nodiscard]] constexpr std::string_view view() const noexcept {
+            return {value.data(), size};
+        }
+    };
+
+    [[nodiscard]] static constexpr labels output(const std::string_view spec) noexcept {
+        labels result;
+        if (const auto idx = arrow(spec); idx != std::string_view::npos) {
+            for (const char c : spec.substr(idx + 2)) {
+                if (result.size == max_labels) {
+                    break;
+                }
+                result.value[result.size++] = c;
+            }
+            return result;
+        }
+        std::array<size_type, max_labels> counts{};
+        for (const char c : inputs(spec)) {
+            if (is_label(c)) {
+                ++counts[index(c)];
+            }
+        }
+        // Upper case letters sort before lower case ones.
+        for (size_type idx = 0; idx < max_labels; ++idx) {
+            if (const auto c = label((idx + 26) % max_labels); counts[index(c)] == 1) {
+                result.value[result.size++] = c;
+            }
+        }
+        return result;
+    }
+
+    /**
+     * @brief Returns whether every input term consists of labels, and the output of distinct labels
+     * that appear in the inputs.
+     */
+    [[nodiscard]] static constexpr bool valid(const std::string_view spec) {
+        std::array<bool, max_labels> seen{};
+        for (const char c : inputs(spec)) {
+            if (c != ',' && !is_label(c)) {
+                return false;
+            }
+            if (c != ',') {
+                seen[index(c)] = true;
+            }
+        }
+        if (const auto arrow_idx = arrow(spec);
+            arrow_idx != std::string_view::npos && spec.size() - arrow_idx - 2 > max_labels) {
+            return false;
+        }
+        const auto out = output(spec).view();
+        for (size_type idx = 0; idx < out.size(); ++idx) {
+            if (!is_label(out[idx]) || !seen[index(out[idx])] ||
+                find(out, out[idx], idx + 1) != std::string_view::npos) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+/**
+ * @brief A strided operand of a contraction whose axes are named by labels. Intermediate results
+ * own their data, inputs refer to the data of the tensors passed in.
+ */
+template <typename T>
+struct einsum_operand {
+    const T* data{nullptr};
+    std::vector<size_type> extents;
+    std::vector<size_type> strides;
+    std::string labels;
+    std::vector<T> storage;
+
+    einsum_operand() = default;
+    einsum_operand(const einsum_operand&) = delete;
+    einsum_operand& operator=(const einsum_operand&) = delete;
+    einsum_operand(einsum_operand&&) noexcept = default;
+    einsum_operand& operator=(einsum_operand&&) noexcept = default;
+    ~einsum_operand() = default;
+
+    /**
+     * @brief Allocates a zeroed, row-major operand.
+     */
+    static einsum_operand allocate(std::string names, std::vector<size_type> dims) {
+        einsum_operand result;
+        result.labels = std::move(names);
+        result.extents = std::move(dims);
+        result.strides.assign(result.extents.size(), 1);
+        size_type size = 1;
+        for (size_type dim = result.extents.size(); dim-- > 0;) {
+            result.strides[dim] = size;
+            size *= result.extents[dim];
+        }
+        result.storage.assign(size, T{0});
+        result.data = result.storage.data();
+        return result;
+    }
+
+    [[nodiscard]] size_type axis(const char c) const noexcept {
+        return labels.find(c);
+    }
+};
+
+/**
+ * @brief Merges axes sharing a label into a single axis walking their diagonal, e.g. for "ii->i".
+ */
+template <typename T>
+void diagonalize(einsum_operand<T>& op) {
+    for (size_type dim = 0; dim < op.labels.size(); ++dim) {
+        for (size_type other = op.labels.size(); other-- > dim + 1;) {
+            if (op.labels[other] != op.labels[dim]) {
+                continue;
+            }
+            if (op.extents[other] != op.extents[dim]) {
+                throw std::runtime_error("Tensor dimension mismatch.");
+            }
+            op.strides[dim] += op.strides[other];
+            op.labels.erase(other, 1);
+            op.extents.erase(op.extents.begin() + static_cast<std::ptrdiff_t>(other));
+            op.strides.erase(op.strides.begin() + static_cast<std::ptrdiff_t>(other));
+        }
+    }
+}
+
+/**
+ * @brief Returns whether the labels already name the axes of the operand in row-major order.
+ */
+template <typename T>
+[[nodiscard]] bool is_row_major(const einsum_operand<T>& op, const std::string_view labels) {
+    if (op.labels != labels) {
+        return false;
+    }
+    size_type expected = 1;
+    for (size_type dim = op.labels.size(); dim-- > 0;) {
+        if (op.extents[dim] != 1 && op.strides[dim] != expected) {
+            return false;
+        }
+        expected *= op.extents[dim];
+    }
+    return true;
+}
+
+/**
+ * @brief Returns a row-major operand holding the provided axes in the provided order, summing over
+ * all other axes. The operand is passed through if it is laid out accordingly already.
+ */
+template <typename T>
+[[nodiscard]] einsum_operand<T> sum_to(einsum_operand<T>&& op, const std::string& labels) {
+    if (is_row_major(op, labels)) {
+        return std::move(op);
+    }
+    std::vector<size_type> extents;
+    for (const char c : labels) {
+        extents.push_back(op.extents[op.axis(c)]);
+    }
+    auto result = einsum_operand<T>::allocate(labels, extents);
+
+    const auto order = op.labels.size();
+    std::vector<size_type> targets(order, 0);
+    size_type size = 1;
+    for (size_type dim = 0; dim < order; ++dim) {
+        if (const auto axis = result.axis(op.labels[dim]); axis != std::string::npos) {
+            targets[dim] = result.strides[axis];
+        }
+        size *= op.extents[dim];
+    }
+    if (size == 0) {
+        return result;
+    }
+
+    std::vector<size_type> idxs(order, 0);
+    size_type source = 0;
+    size_type target = 0;
+    auto* dst = result.storage.data();
+    for (size_type count = 0; count < size; ++count) {
+        dst[target] += op.data[source];
+        for (size_type dim = order; dim-- > 0;) {
+            source += op.strides[dim];
+            target += targets[dim];
+            if (++idxs[dim] < op.extents[dim]) {
+                break;
+            }
+            source -= op.strides[dim] * op.extents[dim];
+            target -= targets[dim] * op.extents[dim];
+            idxs[dim] = 0;
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief Returns the extent and innermost stride of the axes taken as a single axis, provided they
+ * are laid out contiguously relative to each other in the given order.
+ */
+template <typename T>
+bool collapse(const einsum_operand<T>& op, const std::string_view labels, size_type& extent,
+              size_type& stride) {
+    extent = 1;
+    stride = 0;
+    bool first = true;
+    for (size_type idx = labels.size(); idx-- > 0;) {
+        const auto axis = op.axis(labels[idx]);
+        if (op.extents[axis] == 1) {
+            continue;
+        }
+        if (first) {
+            stride = op.strides[axis];
+            first = false;
+        } else if (op.strides[axis] != stride * extent) {
+            return false;
+        }
+        extent *= op.extents[axis];
+    }
+    for (const char c : labels) {
+        if (op.extents[op.axis(c)] == 0) {
+            extent = 0;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Contracts two operands, keeping the provided labels. Labels shared by both operands and
+ * kept become batch axes, shared labels dropped are summed over via the matrix multiplication, and
+ * labels of a single operand that are dropped are summed over beforehand.
+ */
+template <typename T>
+[[nodiscard]] einsum_operand<T> contract(einsum_operand<T>&& a, einsum_operand<T>&& b,
+                                         const std::string& keep) {
+    const auto kept = [&](const std::string& own, const einsum_operand<T>& other) {
+        std::string result;
+        for (const char c : own) {
+            if (other.labels.find(c) != std::string::npos || keep.find(c) != std::string::npos) {
+                result += c;
+            }
+        }
+        return result;
+    };
+    const auto lhs_labels = kept(a.labels, b);
+    const auto rhs_labels = kept(b.labels, a);
+    // Operands are only materialized here if a label has to be summed over, strided views are
+    // otherwise passed to the matrix multiplication as they are.
+    if (lhs_labels != a.labels) {
+        a = sum_to(std::move(a), lhs_labels);
+    }
+    if (rhs_labels != b.labels) {
+        b = sum_to(std::move(b), rhs_labels);
+    }
+
+    std::string batch;
+    std::string rows;
+    std::string inner;
+    std::string cols;
+    for (const char c : a.labels) {
+        if (b.labels.find(c) == std::string::npos) {
+            rows += c;
+        } else if (keep.find(c) != std::string::npos) {
+            batch += c;
+        } else {
+            inner += c;
+        }
+    }
+    for (const char c : b.labels) {
+        if (a.labels.find(c) == std::string::npos) {
+            cols += c;
+        }
+    }
+
+    size_type m = 0;
+    size_type k = 0;
+    size_type n = 0;
+    size_type row_stride = 0;
+    size_type lhs_inner_stride = 0;
+    size_type rhs_inner_stride = 0;
+    size_type col_stride = 0;
+    if (!collapse(a, rows, m, row_stride) || !collapse(a, inner, k, lhs_inner_stride)) {
+        a = sum_to(std::move(a), batch + rows + inner);
+        collapse(a, rows, m, row_stride);
+        collapse(a, inner, k, lhs_inner_stride);
+    }
+    if (!collapse(b, inner, k, rhs_inner_stride) || !collapse(b, cols, n, col_stride)) {
+        b = sum_to(std::move(b), batch + inner + cols);
+        collapse(b, inner, k, rhs_inner_stride);
+        collapse(b, cols, n, col_stride);
+    }
+
+    std::vector<size_type> extents;
+    for (const char c : batch + rows) {
+        extents.push_back(a.extents[a.axis(c)]);
+    }
+    for (const char c : cols) {
+        extents.push_back(b.extents[b.axis(c)]);
+    }
+    auto result = einsum_operand<T>::allocate(batch + rows + cols, extents);
+
+    size_type batches = 1;
+    for (const char c : batch) {
+        batches *= a.extents[a.axis(c)];
+    }
+    std::vector<size_type> idxs(batch.size(), 0);
+    size_type lhs_offset = 0;
+    size_type rhs_offset = 0;
+    for (size_type idx = 0; idx < batches && m * n != 0; ++idx) {
+        const matrix_ref<T> lhs{a.data + lhs_offset, m, k, row_stride, lhs_inner_stride};
+        const matrix_ref<T> rhs{b.data + rhs_offset, k, n, rhs_inner_stride, col_stride};
+        gemm(lhs, rhs, result.storage.data() + idx * m * n);
+        for (size_type dim = batch.size(); dim-- > 0;) {
+            const auto lhs_axis = a.axis(batch[dim]);
+            const auto rhs_axis = b.axis(batch[dim]);
+            lhs_offset += a.strides[lhs_axis];
+            rhs_offset += b.strides[rhs_axis];
+            if (++idxs[dim] < a.extents[lhs_axis]) {
+                break;
+            }
+            lhs_offset -= a.strides[lhs_axis] * a.extents[lhs_axis];
+            rhs_offset -= b.strides[rhs_axis] * b.extents[rhs_axis];
+            idxs[dim] = 0;
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief Picks the order of pairwise contractions for the operands, given as bit sets of labels.
+ * Up to `exhaustive` operands every order is considered via dynamic programming over subsets,
+ * minimizing the number of multiply-adds and then the largest intermediate. Beyond that, the pair
+ * whose contraction is cheapest is contracted greedily.
+ * @return Pairs of node indices, where the leaves are the operands and the i-th pair creates node
+ * `operands.size() + i`.
+ */
+[[nodiscard]] inline std::vector<std::pair<size_type, size_type> > einsum_path(
+    const std::vector<std::uint64_t>& operands, const std::uint64_t output,
+    const std::array<size_type, einsum_spec::max_labels>& extents) {
+    constexpr size_type exhaustive = 10;
+    const auto n = operands.size();
+    std::vector<std::pair<size_type, size_type> > path;
+    if (n < 2) {
+        return path;
+    }
+
+    const auto volume = [&](std::uint64_t labels) {
+        double result = 1;
+        for (; labels != 0; labels &= labels - 1) {
+            const auto idx = static_cast<size_type>(std::countr_zero(labels));
+            result *= static_cast<double>(extents[idx]);
+        }
+        return result;
+    };
+
+    if (n > exhaustive) {
+        auto nodes = operands;
+        std::vector<size_type> live(n);
+        for (size_type idx = 0; idx < n; ++idx) {
+            live[idx] = idx;
+        }
+        while (live.size() > 1) {
+            auto best = std::make_pair(std::numeric_limits<double>::infinity(), 0.0);
+            size_type lhs = 0;
+            size_type rhs = 1;
+            for (size_type i = 0; i < live.size(); ++i) {
+                for (size_type j = i + 1; j < live.size(); ++j) {
+                    std::uint64_t others = output;
+                    for (size_type other = 0; other < live.size(); ++other) {
+                        if (other != i && other != j) {
+                            others |= nodes[live[other]];
+                        }
+                    }
+                    const auto both = nodes[live[i]] | nodes[live[j]];
+                    const auto cost = std::make_pair(volume(both), volume(both & others));
+                    if (cost < best) {
+                        best = cost;
+                        lhs = i;
+                        rhs = j;
+                    }
+                }
+            }
+            std::uint64_t others = output;
+            for (size_type other = 0; other < live.size(); ++other) {
+                if (other != lhs && other != rhs) {
+                    others |= nodes[live[other]];
+                }
+            }
+            path.emplace_back(live[lhs], live[rhs]);
+            nodes.push_back((nodes[live[lhs]] | nodes[live[rhs]]) & others);
+            live.erase(live.begin() + static_cast<std::ptrdiff_t>(rhs));
+            live[lhs] = nodes.size() - 1;
+        }
+        return path;
+    }
+
+    const auto full = (std::uint64_t{1} << n) - 1;
+    std::vector<std::uint64_t> labels(full + 1, 0);
+    for (std::uint64_t mask = 1; mask <= full; ++mask) {
+        const auto low = static_cast<size_type>(std::countr_zero(mask));
+        labels[mask] = labels[mask & (mask - 1)] | operands[low];
+    }
+    // Labels of the result of contracting a subset, i.e. those still needed outside of it.
+    const auto result = [&](const std::uint64_t mask) {
+        return labels[mask] & (labels[full & ~mask] | output);
+    };
+
+    std::vector<std::pair<double, double> > cost(full + 1, {0.0, 0.0});
+    std::vector<std::uint64_t> split(full + 1, 0);
+    for (std::uint64_t mask = 1; mask <= full; ++mask) {
+        if ((mask & (mask - 1)) == 0) {
+            continue;
+        }
+        cost[mask] = {std::numeric_limits<double>::infinity(), 0.0};
+        for (auto sub = (mask - 1) & mask; sub != 0; sub = (sub - 1) & mask) {
+            const auto rest = mask & ~sub;
+            if (sub < rest) {
+                continue;
+            }
+            const auto flops =
+                cost[sub].first + cost[rest].first + volume(result(sub) | result(rest));
+            const auto memory =
+                std::max({cost[sub].second, cost[rest].second, volume(result(mask))});
+            if (std::make_pair(flops, memory) < cost[mask]) {
+                cost[mask] = {flops, memory};
+                split[mask] = sub;
+            }
+        }
+    }
+
+    const auto build = [&](const auto& self, const std::uint64_t mask) -> size_type {
+        if ((mask & (mask - 1)) == 0) {
+            return static_cast<size_type>(std::countr_zero(mask));
+        }
+        const auto lhs = self(self, split[mask]);
+        const auto rhs = self(self, mask & ~split[mask]);
+        path.emplace_back(lhs, rhs);
+        return n + path.size() - 1;
+    };
+    build(build, full);
+    return path;
+}
+
+/**
+ * @brief Tensors and views of a 16-bit floating-point type.
+ */
+template <typename X>
+concept half_operand = requires { typename view_of<X>::type; } &&
+                       is_half_v<typename view_of<X>::type::value_type>;
+
+template <typename X>
+[[nodiscard]] auto einsum_input(const X& x, const std::string_view labels) {
+    const auto v = as_view(x);
+    einsum_operand<typename decltype(v)::value_type> op;
+    op.data = v.data();
+    const auto extents = v.extents();
+    const auto strides = v.strides();
+    op.extents.assign(extents.begin(), extents.end());
+    op.strides.assign(strides.begin(), strides.end());
+    op.labels = labels;
+    diagonalize(op);
+    return op;
+}
+
+}  // namespace detail
+
+/**
+ * @brief Evaluates the Einstein summation described by the subscripts, e.g. a batched matrix
+ * multiplication via `einsum<"bij,bjk->bik">(a, b)`. Every operand is a tensor or a view whose
+ * order matches the length of its term, repeated labels within a term take the diagonal, and labels
+ * missing from the output are summed over. Omitting the arrow keeps the labels appearing once in
+ * alphabetical order. Operands are contracted pairwise in the order minimizing the number of
+ * multiply-adds, and each pairwise contraction is carried out by the matrix multiplication kernel,
+ * with operands only copied if their axes can not be addressed as a strided matrix.
+ * @tparam Spec Subscripts made of ASCII letters, commas and an optional "->".
+ * @param operands Tensors or views to contract.
+ * @return A tensor holding the result, of order equal to the number of output labels.
+ */
+template <detail::fixed_string Spec, typename... Xs>
+    requires(sizeof...(Xs) > 0 && (requires { typename detail::view_of<Xs>::type; } && ...) &&
+             !(detail::half_operand<Xs> && ...))
+[[nodiscard]] auto einsum(const Xs&... operands) {
+    using spec = detail::einsum_spec;
+    constexpr auto subscripts = Spec.view();
+    static_assert(spec::valid(subscripts), "Invalid einsum subscripts.");
+    static_assert(spec::terms(subscripts) == sizeof...(Xs),
+                  "The number of einsum terms has to match the number of operands.");
+
+    using first = std::tuple_element_t<0, std::tuple<Xs...> >;
+    using T = typename detail::view_of<first>::type::value_type;
+    static_assert((std::is_same_v<typename detail::view_of<Xs>::type::value_type, T> && ...),
+                  "All einsum operands have to be of the same type.");
+
+    constexpr auto Order = spec::output(subscripts).size;
+    const auto out = std::string(spec::output(subscripts).view());
+
+    std::vector<detail::einsum_operand<T> > inputs;
+    [&]<size_type... Idxs>(std::index_sequence<Idxs...>) {
+        static_assert(((detail::view_of<Xs>::type::order == spec::term(subscripts, Idxs).size()) &&
+                       ...),
+                      "The order of every einsum operand has to match the length of its term.");
+        (inputs.push_back(detail::einsum_input(operands, spec::term(subscripts, Idxs))), ...);
+    }(std::index_sequence_for<Xs...>{});
+
+    std::array<size_type, spec::max_labels> extents{};
+    std::array<bool, spec::max_labels> known{};
+    std::vector<std::uint64_t> sets;
+    for (const auto& op : inputs) {
+        std::uint64_t set = 0;
+        for (size_type dim = 0; dim < op.labels.size(); ++dim) {
+            const auto idx = spec::index(op.labels[dim]);
+            if (known[idx] && extents[idx] != op.extents[dim]) {
+                throw std::runtime_error("Tensor dimension mismatch.");
+            }
+            known[idx] = true;
+            extents[idx] = op.extents[dim];
+            set |= std::uint64_t{1} << idx;
+        }
+        sets.push_back(set);
+    }
+    std::uint64_t output = 0;
+    for (const char c : out) {
+        output |= std::uint64_t{1} << spec::index(c);
+    }
+
+    std::vector<detail::einsum_operand<T> > nodes = std::move(inputs);
+    std::vector<bool> consumed(sets.size(), false);
+    for (const auto& [lhs, rhs] : detail::einsum_path(sets, output, extents)) {
+        consumed[lhs] = true;
+        consumed[rhs] = true;
+        std::uint64_t needed = output;
+        for (size_type idx = 0; idx < sets.size(); ++idx) {
+            if (!consumed[idx]) {
+                needed |= sets[idx];
+            }
+        }
+        std::string keep;
+        for (std::uint64_t labels = (sets[lhs] | sets[rhs]) & needed; labels != 0;
+             labels &= labels - 1) {
+            keep += spec::label(static_cast<size_type>(std::countr_zero(labels)));
+        }
+        nodes.push_back(detail::contract(std::move(nodes[lhs]), std::move(nodes[rhs]), keep));
+        sets.push_back((sets[lhs] | sets[rhs]) & needed);
+        consumed.push_back(false);
+    }
+
+    auto final = detail::sum_to(std::move(nodes.back()), out);
+    array<Order> dims{};
+    if constexpr (Order > 0) {
+        std::copy(final.extents.begin(), final.extents.end(), dims.begin());
+    }
+    auto result = tensor<T, Order>(dims);
+    std::copy(final.data, final.data + result.size(), result.data());
+    return result;
+}
+
+/**
+ * @brief Evaluates the Einstein summation of operands of a 16-bit floating-point type, see above.
+ * Operands are widened, contracted in single precision, and the result is rounded once.
+ */
+template <detail::fixed_string Spec, typename... Xs>
+    requires(sizeof...(Xs) > 0 && (detail::half_operand<Xs> && ...))
+[[nodiscard]] auto einsum(const Xs&... operands) {
+    using first = std::tuple_element_t<0, std::tuple<Xs...> >;
+    using T = typename detail::view_of<first>::type::value_type;
+    return detail::to_storage<T>(einsum<Spec>(
+        tensor<compute_t<T>, detail::view_of<Xs>::type::order>(detail::as_expr(operands))...));
+}
+
+}  // namespace core
+
+#endif  // EINSUM_HPP
@@ -0,0 +1,940 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2022 David Oniani
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef EXPR_HPP
+#define EXPR_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "core.hpp"
+
+namespace core {
+
+template <typename Op, expression E>
+class unary_expr;
+
+/**
+ * @brief Provides the handy broadcasting operations shared by every expression node.
+ * @tparam Derived The expression node deriving from the base.
+ */
+template <typename Derived>
+class expr_base {
+   public:
+    /**
+     * @brief Lazily broadcasts the power operation across the expression.
+     * @param exp Exponent.
+     * @return Expression with every value transformed via the power function.
+     */
+    [[nodiscard]] constexpr auto pow(const arithmetic auto exp) const {
+        return unary_expr<op::pow<std::remove_cvref_t<decltype(exp)> >, Derived>(self(), {exp});
+    }
+
+    /**
+     * @brief Lazily broadcasts the square operation across the expression.
+     * @return Expression with every value transformed via the square function.
+     */
+    [[nodiscard]] constexpr auto square() const {
+        return unary_expr<op::square, Derived>(self());
+    }
+
+    /**
+     * @brief Lazily broadcasts the square root operation across the expression.
+     * @return Expression with every value transformed via the square root function.
+     */
+    [[nodiscard]] constexpr auto sqrt() const {
+        return unary_expr<op::sqrt, Derived>(self());
+    }
+
+    /**
+     * @brief Lazily broadcasts the sine operation across the expression.
+     * @return Expression with every value transformed via the sine function.
+     */
+    [[nodiscard]] constexpr auto sin() const {
+        return unary_expr<op::sin, Derived>(self());
+    }
+
+    /**
+     * @brief Lazily broadcasts the cosine operation across the expression.
+     * @return Expression with every value transformed via the cosine function.
+     */
+    [[nodiscard]] constexpr auto cos() const {
+        return unary_expr<op::cos, Derived>(self());
+    }
+
+    /**
+     * @brief Lazily broadcasts the tangent operation across the expression.
+     * @return Expression with every value transformed via the tangent function.
+     */
+    [[nodiscard]] constexpr auto tan() const {
+        return unary_expr<op::tan, Derived>(self());
+    }
+
+    /**
+     * @brief Lazily broadcasts the round operation across the expression.
+     * @return Expression with every value transformed via the round function.
+     */
+    [[nodiscard]] constexpr auto round() const {
+        return unary_expr<op::round, Derived>(self());
+    }
+
+    /**
+     * @brief Lazily broadcasts the exponential operation across the expression.
+     * @return Expression with every value transformed via the exponential function.
+     */
+    [[nodiscard]] constexpr auto exp() const {
+        return unary_expr<op::exp, Derived>(self());
+    }
+
+    /**
+     * @brief Lazily broadcasts the natural logarithm operation across the expression.
+     * @return Expression with every value transformed via the natural logarithm function.
+     */
+    [[nodiscard]] constexpr auto log() const {
+        return unary_expr<op::log, Derived>(self());
+    }
+
+    /**
+     * @brief Lazily broadcasts the hyperbolic tangent operation across the expression.
+     * @return Expression with every value transformed via the hyperbolic tangent function.
+     */
+    [[nodiscard]] constexpr auto tanh() const {
+        return unary_expr<op::tanh, Derived>(self());
+    }
+
+    /**
+     * @brief Lazily broadcasts the absolute value operation across the expression.
+     * @return Expression with every value transformed via the absolute value function.
+     */
+    [[nodiscard]] constexpr auto abs() const {
+        return unary_expr<op::abs, Derived>(self());
+    }
+
+    /**
+     * @brief Lazily broadcasts the callable across the expression, fused into the same loop as the
+     * rest of the expression. Results are converted to the value type of the expression.
+     * @param func Callable taking a value, wrapped in `op::packed` if it also accepts SIMD packs.
+     * @return Expression with every value transformed via the callable.
+     */
+    template <typename F>
+    [[nodiscard]] constexpr auto map(const F func) const {
+        return unary_expr<op::map<F>, Derived>(self(), {func});
+    }
+
+    /**
+     * @brief Evaluates the expression in a single pass.
+     * @return New tensor holding the values of the expression.
+     */
+    [[nodiscard]] constexpr auto eval() const {
+        return tensor<typename Derived::value_type, Derived::order>(self());
+    }
+
+   private:
+    [[nodiscard]] constexpr const Derived& self() const noexcept {
+        return static_cast<const Derived&>(*this);
+    }
+};
+
+/**
+ * @brief Defines a leaf of an expression referring to an existing tensor. The tensor must outlive
+ * the expression.
+ * @tparam T An arithmetic type representing the type of each element in tensor.
+ * @tparam Order The NTTP representing the order of a tensor.
+ */
+template <arithmetic T, size_type Order>
+class tensor_expr : public expr_base<tensor_expr<T, Order> > {
+   private:
+    const tensor<T, Order>* m_tensor;
+
+   public:
+    using value_type = T;
+    static constexpr size_type order = Order;
+    static constexpr bool is_expression = true;
+
+    template <typename V>
+    static constexpr bool vectorizable = simd::loadable<T> && std::is_same_v<simd::lane_t<T>, V>;
+
+    /**
+     * @brief Constructs a leaf referring to the provided tensor.
+     * @param t Tensor to refer to.
+     */
+    constexpr explicit tensor_expr(const tensor<T, Order>& t) noexcept : m_tensor{&t} {}
+
+    [[nodiscard]] constexpr auto operator[](const size_type idx) const {
+        return m_tensor->data()[idx];
+    }
+
+    template <typename V>
+    [[nodiscard]] auto load(const size_type idx, const size_type count) const {
+        const auto* data = m_tensor->data() + idx;
+        return count == simd::pack<V>::width ? simd::load(data) : simd::load_partial(data, count);
+    }
+
+    [[nodiscard]] constexpr auto extents() const noexcept {
+        return m_tensor->extents();
+    }
+
+    [[nodiscard]] constexpr auto size() const noexcept {
+        return m_tensor->size();
+    }
+
+    /**
+     * @brief Returns whether evaluating reads elements in [first, last) other than the one being
+     * written, in which case a tensor owning that memory cannot be assigned in place.
+     */
+    [[nodiscard]] bool aliases(const void* /* first */, const void* /* last */) const noexcept {
+        return false;
+    }
+};
+
+/**
+ * @brief Defines a leaf of an expression holding a scalar that is broadcast to every index.
+ * @tparam S An arithmetic type representing the type of the scalar.
+ * @tparam Order The NTTP representing the order of the expression the scalar is broadcast to.
+ */
+template <arithmetic S, size_type Order>
+class scalar_expr : public expr_base<scalar_expr<S, Order> > {
+   private:
+    S m_value;
+    array<Order> m_extents;
+    size_type m_size;
+
+   public:
+    using value_type = S;
+    static constexpr size_type order = Order;
+    static constexpr bool is_expression = true;
+    static constexpr bool is_scalar = true;
+
+    template <typename V>
+    static constexpr bool vectorizable =
+        simd::supported<V> && (std::is_integral_v<S> || std::is_same_v<simd::lane_t<S>, V>);
+
+    /**
+     * @brief Constructs a leaf broadcasting the value to the provided extents.
+     * @param value Value to be broadcast.
+     * @param extents Extents to broadcast to.
+     */
+    constexpr scalar_expr(const S value, const array<Order> extents) noexcept
+        : m_value{value},
+          m_extents{extents},
+          m_size{std::reduce(extents.begin(), extents.end(), size_type{1},
+                             std::multiplies<size_type>())} {}
+
+    [[nodiscard]] constexpr auto operator[](const size_type /* idx */) const noexcept {
+        return m_value;
+    }
+
+    template <typename V>
+    [[nodiscard]] auto load(const size_type /* idx */, const size_type /* count */) const {
+        return simd::pack<V>(static_cast<V>(m_value));
+    }
+
+    [[nodiscard]] constexpr auto extents() const noexcept {
+        return m_extents;
+    }
+
+    [[nodiscard]] constexpr auto size() const noexcept {
+        return m_size;
+    }
+
+    [[nodiscard]] bool aliases(const void* /* first */, const void* /* last */) const noexcept {
+        return false;
+    }
+};
+
+namespace detail {
+
+/**
+ * @brief Walks the operand of a unary node, applying the operation to every pack.
+ */
+template <typename Op, typename C>
+class unary_cursor {
+   private:
+    const Op* m_op;
+    C m_cursor;
+
+   public:
+    constexpr unary_cursor(const Op& operation, const C& cursor) noexcept
+        : m_op{&operation}, m_cursor{cursor} {}
+
+    template <typename V>
+    [[nodiscard]] auto load(const size_type count) const {
+        return (*m_op)(m_cursor.template load<V>(count));
+    }
+
+    constexpr void advance(const size_type count) noexcept {
+        m_cursor.advance(count);
+    }
+};
+
+/**
+ * @brief Walks both operands of a binary node, combining their packs via the operation.
+ */
+template <typename Op, typename L, typename R>
+class binary_cursor {
+   private:
+    const Op* m_op;
+    L m_lhs;
+    R m_rhs;
+
+   public:
+    constexpr binary_cursor(const Op& operation, const L& lhs, const R& rhs) noexcept
+        : m_op{&operation}, m_lhs{lhs}, m_rhs{rhs} {}
+
+    template <typename V>
+    [[nodiscard]] auto load(const size_type count) const {
+        return (*m_op)(m_lhs.template load<V>(count), m_rhs.template load<V>(count));
+    }
+
+    constexpr void advance(const size_type count) noexcept {
+        m_lhs.advance(count);
+        m_rhs.advance(count);
+    }
+};
+
+}  // namespace detail
+
+/**
+ * @brief Defines a node applying an element-wise operation to an expression.
+ * @tparam Op Element-wise operation.
+ * @tparam E Operand expression.
+ */
+template <typename Op, expression E>
+class unary_expr : public expr_base<unary_expr<Op, E> > {
+   private:
+    E m_expr;
+    Op m_op;
+
+   public:
+    using value_type = typename E::value_type;
+    static constexpr size_type order = E::order;
+    static constexpr bool is_expression = true;
+
+    template <typename V>
+    static constexpr bool vectorizable = Op::vectorizable && E::template vectorizable<V>;
+
+    /**
+     * @brief Constructs a node applying the operation to the expression.
+     * @param expr Operand expression.
+     * @param operation Element-wise operation.
+     */
+    constexpr explicit unary_expr(const E& expr, const Op operation = {}) noexcept
+        : m_expr{expr}, m_op{operation} {}
+
+    [[nodiscard]] constexpr auto operator[](const size_type idx) const {
+        return static_cast<compute_t<value_type> >(m_op(m_expr[idx]));
+    }
+
+    template <typename V>
+    [[nodiscard]] auto load(const size_type idx, const size_type count) const {
+        return m_op(m_expr.template load<V>(idx, count));
+    }
+
+    [[nodiscard]] constexpr auto cursor(const size_type idx) const
+        requires kernel::detail::walkable<E>
+    {
+        return detail::unary_cursor<Op, decltype(m_expr.cursor(idx))>(m_op, m_expr.cursor(idx));
+    }
+
+    [[nodiscard]] constexpr auto extents() const noexcept {
+        return m_expr.extents();
+    }
+
+    [[nodiscard]] constexpr auto size() const noexcept {
+        return m_expr.size();
+    }
+
+    [[nodiscard]] bool aliases(const void* first, const void* last) const noexcept {
+        return m_expr.aliases(first, last);
+    }
+};
+
+/**
+ * @brief Defines a leaf of an expression whose values form an arithmetic progression along one
+ * axis, as built by `builder::arange`, `linspace`, `meshgrid` and `indices`. Each element is
+ * computed directly from its coordinate along the axis, `begin + coordinate * stride`, so that no
+ * error accumulates and nothing is materialized.
+ * @tparam T An arithmetic type representing the type each element is converted to.
+ * @tparam Order The NTTP representing the order of the expression.
+ * @tparam W Type the values are computed in.
+ */
+template <arithmetic T, size_type Order, typename W = compute_t<T> >
+class grid_expr : public expr_base<grid_expr<T, Order, W> > {
+   private:
+    W m_begin;
+    W m_stride;
+    W m_end;
+    array<Order> m_extents;
+    size_type m_size;
+    size_type m_inner;
+    size_type m_period;
+    size_type m_last;
+
+   public:
+    using value_type = T;
+    static constexpr size_type order = Order;
+    static constexpr bool is_expression = true;
+
+    template <typename V>
+    static constexpr bool vectorizable = simd::supported<V> && std::is_same_v<W, V>;
+
+    /**
+     * @brief Constructs a leaf progressing along the provided axis and repeated along the others.
+     * @param begin Value at coordinate zero.
+     * @param stride Difference between consecutive coordinates.
+     * @param extents Extents of the expression.
+     * @param axis Axis the values progress along.
+     * @param end If set, value at the last coordinate, which is then exact rather than computed.
+     */
+    constexpr grid_expr(const W begin, const W stride, const array<Order>& extents,
+                        const size_type axis = 0, const std::optional<W> end = std::nullopt)
+        : m_begin{begin},
+          m_stride{stride},
+          m_end{end.value_or(begin)},
+          m_extents{extents},
+          m_size{std::reduce(extents.begin(), extents.end(), size_type{1},
+                             std::multiplies<size_type>())},
+          m_inner{std::reduce(extents.begin() + axis + 1, extents.end(), size_type{1},
+                              std::multiplies<size_type>())},
+          m_period{extents[axis]},
+          m_last{end ? extents[axis] - 1 : extents[axis]} {}
+
+    /**
+     * @brief Spreads the progression of an order one leaf along an axis of higher order extents.
+     * @param extents Extents of the returned leaf, whose extent along the axis is kept.
+     * @param axis Axis the values progress along.
+     * @return A leaf of order `N` repeating the values along the other axes.
+     */
+    template <size_type N>
+        requires(Order == 1)
+    [[nodiscard]] constexpr auto along(array<N> extents, const size_type axis) const {
+        extents[axis] = m_period;
+        const auto end = m_last < m_period ? std::optional<W>(m_end) : std::nullopt;
+        return grid_expr<T, N, W>(m_begin, m_stride, extents, axis, end);
+    }
+
+    [[nodiscard]] constexpr W operator[](const size_type idx) const noexcept {
+        const auto coordinate = idx / m_inner % m_period;
+        return coordinate == m_last ? m_end : m_begin + static_cast<W>(coordinate) * m_stride;
+    }
+
+    /**
+     * @brief Loads `count` consecutive elements. Along the innermost axis these are the lane
+     * indices scaled and shifted, along outer axes mostly a single repeated value, so that only
+     * packs straddling rows are gathered.
+     */
+    template <typename V>
+    [[nodiscard]] auto load(const size_type idx, const size_type count) const {
+        using P = simd::pack<V>;
+        alignas(P) V buf[P::width];
+        // Order one ranges progress over every element, sparing the division.
+        const auto first = m_inner == 1 ? (m_period == m_size ? idx : idx % m_period) : 0;
+        if (m_inner == 1 && first + count <= m_period) {
+            for (size_type lane = 0; lane < P::width; ++lane) {
+                buf[lane] = static_cast<V>(lane);
+            }
+            const auto offset = static_cast<V>(static_cast<std::int64_t>(first));
+            const auto coordinates = P::load(buf) + P(offset);
+            const auto result = coordinates * P(m_stride) + P(m_begin);
+            const bool ends = m_last >= first && m_last < first + count;
+            if (!ends && count == P::width) {
+                return result;
+            }
+            result.store(buf);
+            if (ends) {
+                buf[m_last - first] = m_end;
+            }
+            // Lanes past the end hold ones, as in partial loads, so that division accepts them.
+            std::fill(buf + count, buf + P::width, V{1});
+            return P::load(buf);
+        }
+        if (idx / m_inner == (idx + count - 1) / m_inner) {
+            return P((*this)[idx]);
+        }
+        for (size_type lane = 0; lane < P::width; ++lane) {
+            buf[lane] = lane < count ? (*this)[idx + lane] : V{1};
+        }
+        return P::load(buf);
+    }
+
+    [[nodiscard]] constexpr auto extents() const noexcept {
+        return m_extents;
+    }
+
+    [[nodiscard]] constexpr auto size() const noexcept {
+        return m_size;
+    }
+
+    [[nodiscard]] bool aliases(const void* /* first */, const void* /* last */) const noexcept {
+        return false;
+    }
+};
+
+namespace detail {
+
+/**
+ * @brief Returns the extents two operands are broadcast to. As in NumPy, trailing axes are aligned,
+ * missing leading axes count as extent one, and an axis of extent one is repeated to match the
+ * other operand.
+ * @param lhs Extents of the left-hand side.
+ * @param rhs Extents of the right-hand side.
+ * @return Extents of order `max(N, M)`.
+ */
+template <size_type N, size_type M>
+[[nodiscard]] constexpr auto broadcast_extents(const array<N>& lhs, const array<M>& rhs) {
+    constexpr auto Order = std::max(N, M);
+    array<Order> result{};
+    for (size_type dim = 0; dim < Order; ++dim) {
+        const auto l = dim < Order - N ? size_type{1} : lhs[dim - (Order - N)];
+        const auto r = dim < Order - M ? size_type{1} : rhs[dim - (Order - M)];
+        if (l != r && l != 1 && r != 1) {
+            throw std::runtime_error("Tensor dimension mismatch.");
+        }
+        result[dim] = l == 1 ? r : l;
+    }
+    return result;
+}
+
+/**
+ * @brief Maps row-major indices into broadcast extents onto row-major indices into the extents of
+ * an operand. Repeated axes get a stride of zero, so that nothing is materialized.
+ * @tparam N Order of the broadcast extents.
+ */
+template <size_type N>
+class broadcast_map {
+   private:
+    array<N> m_extents;
+    array<N> m_strides;
+    size_type m_inner;
+    bool m_active;
+    bool m_repeat;
+
+   public:
+    /**
+     * @brief Constructs the map from the extents of an operand to the broadcast extents.
+     * @param from Extents of the operand.
+     * @param to Extents broadcast to.
+     */
+    template <size_type M>
+        requires(M <= N)
+    constexpr broadcast_map(const array<M>& from, const array<N>& to)
+        : m_extents{to}, m_strides{}, m_inner{1}, m_active{false}, m_repeat{false} {
+        size_type stride = 1;
+        for (size_type dim = N; dim-- > 0;) {
+            const auto extent = dim < N - M ? size_type{1} : from[dim - (N - M)];
+            if (extent == to[dim]) {
+                m_strides[dim] = stride;
+            } else if (extent != 1) {
+                throw std::runtime_error("Tensor dimension mismatch.");
+            } else {
+                m_active = true;
+            }
+            stride *= extent;
+        }
+        if constexpr (N > 0) {
+            m_inner = to[N - 1];
+            m_repeat = m_strides[N - 1] == 0;
+        }
+    }
+
+    /**
+     * @brief Returns whether any axis is repeated, otherwise indices map onto themselves.
+     */
+    [[nodiscard]] constexpr bool active() const noexcept {
+        return m_active;
+    }
+
+    [[nodiscard]] constexpr size_type operator()(size_type idx) const noexcept {
+        if (!m_active) {
+            return idx;
+        }
+        size_type result = 0;
+        for (size_type dim = N; dim-- > 0;) {
+            result += idx % m_extents[dim] * m_strides[dim];
+            idx /= m_extents[dim];
+        }
+        return result;
+    }
+
+    /**
+     * @brief Loads `count` consecutive broadcast elements of the expression. Within a row of the
+     * innermost axis, these are either a single repeated element or consecutive elements of the
+     * operand, so that only packs straddling rows are gathered.
+     */
+    template <typename V, expression E>
+    [[nodiscard]] simd::pack<V> load(const E& expr, const size_type idx,
+                                     const size_type count) const {
+        if (!m_active) {
+            return expr.template load<V>(idx, count);
+        }
+        const auto base = (*this)(idx);
+        if (idx % m_inner + count <= m_inner) {
+            if (m_repeat) {
+                return simd::pack<V>(static_cast<V>(expr[base]));
+            }
+            return expr.template load<V>(base, count);
+        }
+        alignas(simd::pack<V>) V buf[simd::pack<V>::width];
+        for (size_type lane = 0; lane < simd::pack<V>::width; ++lane) {
+            buf[lane] = lane < count ? static_cast<V>(expr[(*this)(idx + lane)]) : V{1};
+        }
+        return simd::pack<V>::load(buf);
+    }
+};
+
+/**
+ * @brief Walks an operand broadcast via the map, which steps along its own cursor unless an axis
+ * is repeated.
+ */
+template <size_type N, expression E>
+class mapped_cursor {
+   private:
+    const E* m_expr;
+    const broadcast_map<N>* m_map;
+    bool m_active;
+    size_type m_idx;
+    decltype(kernel::detail::cursor(std::declval<const E&>(), size_type{})) m_cursor;
+
+   public:
+    constexpr mapped_cursor(const E& expr, const broadcast_map<N>& map, const size_type idx)
+        : m_expr{&expr},
+          m_map{&map},
+          m_active{map.active()},
+          m_idx{idx},
+          m_cursor{kernel::detail::cursor(expr, m_active ? 0 : idx)} {}
+
+    template <typename V>
+    [[nodiscard]] auto load(const size_type count) const {
+        return m_active ? m_map->template load<V>(*m_expr, m_idx, count)
+                        : m_cursor.template load<V>(count);
+    }
+
+    constexpr void advance(const size_type count) noexcept {
+        m_idx += count;
+        if (!m_active) {
+            m_cursor.advance(count);
+        }
+    }
+};
+
+}  // namespace detail
+
+/**
+ * @brief Defines a node combining two expressions via an element-wise operation. Operands of
+ * different extents are broadcast to common extents as in NumPy, see `detail::broadcast_extents`,
+ * by reading repeated axes with a stride of zero.
+ * @tparam Op Element-wise operation.
+ * @tparam L Left-hand side expression.
+ * @tparam R Right-hand side expression.
+ */
+template <typename Op, expression L, expression R>
+class binary_expr : public expr_base<binary_expr<Op, L, R> > {
+   public:
+    using value_type = std::conditional_t<requires { L::is_scalar; }, typename R::value_type,
+                                          typename L::value_type>;
+    static constexpr size_type order = std::max(L::order, R::order);
+    static constexpr bool is_expression = true;
+
+    template <typename V>
+    static constexpr bool vectorizable =
+        Op::vectorizable && L::template vectorizable<V> && R::template vectorizable<V>;
+
+   private:
+    L m_lhs;
+    R m_rhs;
+    Op m_op;
+    array<order> m_extents;
+    size_type m_size;
+    detail::broadcast_map<order> m_lmap;
+    detail::broadcast_map<order> m_rmap;
+
+   public:
+    /**
+     * @brief Constructs a node combining both expressions.
+     * @param lhs Left-hand side expression.
+     * @param rhs Right-hand side expression.
+     * @param operation Element-wise operation.
+     */
+    constexpr binary_expr(const L& lhs, const R& rhs, const Op operation = {})
+        : m_lhs{lhs},
+          m_rhs{rhs},
+          m_op{operation},
+          m_extents{detail::broadcast_extents(lhs.extents(), rhs.extents())},
+          m_size{std::reduce(m_extents.begin(), m_extents.end(), size_type{1},
+                             std::multiplies<size_type>())},
+          m_lmap(lhs.extents(), m_extents),
+          m_rmap(rhs.extents(), m_extents) {}
+
+    [[nodiscard]] constexpr auto operator[](const size_type idx) const {
+        return static_cast<compute_t<value_type> >(m_op(m_lhs[m_lmap(idx)], m_rhs[m_rmap(idx)]));
+    }
+
+    template <typename V>
+    [[nodiscard]] auto load(const size_type idx, const size_type count) const {
+        return m_op(m_lmap.template load<V>(m_lhs, idx, count),
+                    m_rmap.template load<V>(m_rhs, idx, count));
+    }
+
+    [[nodiscard]] constexpr auto cursor(const size_type idx) const
+        requires(kernel::detail::walkable<L> || kernel::detail::walkable<R>)
+    {
+        using CL = detail::mapped_cursor<order, L>;
+        using CR = detail::mapped_cursor<order, R>;
+        return detail::binary_cursor<Op, CL, CR>(m_op, CL(m_lhs, m_lmap, idx),
+                                                 CR(m_rhs, m_rmap, idx));
+    }
+
+    [[nodiscard]] constexpr auto extents() const noexcept {
+        return m_extents;
+    }
+
+    [[nodiscard]] constexpr auto size() const noexcept {
+        return m_size;
+    }
+
+    [[nodiscard]] bool aliases(const void* first, const void* last) const noexcept {
+        return m_lhs.aliases(first, last) || m_rhs.aliases(first, last);
+    }
+};
+
+/**
+ * @brief Defines a node broadcasting an expression to larger extents, see `broadcast_to`.
+ * @tparam E Operand expression.
+ * @tparam Order Order of the extents broadcast to.
+ */
+template <expression E, size_type Order>
+class broadcast_expr : public expr_base<broadcast_expr<E, Order> > {
+   private:
+    E m_expr;
+    array<Order> m_extents;
+    size_type m_size;
+    detail::broadcast_map<Order> m_map;
+
+   public:
+    using value_type = typename E::value_type;
+    static constexpr size_type order = Order;
+    static constexpr bool is_expression = true;
+
+    template <typename V>
+    static constexpr bool vectorizable = E::template vectorizable<V>;
+
+    /**
+     * @brief Constructs a node broadcasting the expression to the provided extents.
+     * @param expr Operand expression.
+     * @param extents Extents to broadcast to.
+     */
+    constexpr broadcast_expr(const E& expr, const array<Order> extents)
+        : m_expr{expr},
+          m_extents{extents},
+          m_size{std::reduce(extents.begin(), extents.end(), size_type{1},
+                             std::multiplies<size_type>())},
+          m_map(expr.extents(), extents) {}
+
+    [[nodiscard]] constexpr auto operator[](const size_type idx) const {
+        return m_expr[m_map(idx)];
+    }
+
+    template <typename V>
+    [[nodiscard]] auto load(const size_type idx, const size_type count) const {
+        return m_map.template load<V>(m_expr, idx, count);
+    }
+
+    [[nodiscard]] constexpr auto cursor(const size_type idx) const
+        requires kernel::detail::walkable<E>
+    {
+        return detail::mapped_cursor<Order, E>(m_expr, m_map, idx);
+    }
+
+    [[nodiscard]] constexpr auto extents() const noexcept {
+        return m_extents;
+    }
+
+    [[nodiscard]] constexpr auto size() const noexcept {
+        return m_size;
+    }
+
+    [[nodiscard]] bool aliases(const void* first, const void* last) const noexcept {
+        return m_expr.aliases(first, last);
+    }
+};
+
+/**
+ * @brief Starts a lazily evaluated expression from the provided tensor. Operators applied to the
+ * returned expression build up nodes which are evaluated in a single fused loop once assigned to a
+ * tensor, e.g. `tensor2<float> r = (lazy(a) * b + c).sqrt();`. The tensors referred to have to
+ * outlive the expression.
+ * @tparam T Arithmetic type representing the type of every element in the tensor.
+ * @tparam Order Order of the tensor.
+ * @param t Tensor to start the expression from.
+ * @return A leaf expression referring to the tensor.
+ */
+template <arithmetic T, size_type Order>
+[[nodiscard]] constexpr auto lazy(const tensor<T, Order>& t) noexcept {
+    return tensor_expr<T, Order>(t);
+}
+
+template <arithmetic T, size_type Order>
+auto lazy(const tensor<T, Order>&& t) = delete;
+
+namespace detail {
+
+template <typename X>
+struct is_tensor : std::false_type {};
+
+template <arithmetic T, size_type Order>
+struct is_tensor<tensor<T, Order> > : std::true_type {};
+
+template <typename X>
+concept operand = expression<X> || is_tensor<X>::value || arithmetic<X>;
+
+/**
+ * @brief Specifies an operand which may be referred to beyond the call, i.e. anything but a
+ * temporary tensor.
+ */
+template <typename X>
+concept borrowable = operand<std::remove_cvref_t<X> > &&
+                     (!is_tensor<std::remove_cvref_t<X> >::value || std::is_lvalue_reference_v<X>);
+
+/**
+ * @brief Turns a tensor into a leaf expression and passes expressions through as they are.
+ */
+[[nodiscard]] constexpr auto as_expr(const auto& x) noexcept {
+    if constexpr (is_tensor<std::remove_cvref_t<decltype(x)> >::value) {
+        return lazy(x);
+    } else {
+        return x;
+    }
+}
+
+/**
+ * @brief Builds a binary node out of two operands at least one of which is an expression. Scalars
+ * are broadcast to the extents of the other operand.
+ */
+template <typename Op, operand L, operand R>
+[[nodiscard]] constexpr auto make_binary(const L& lhs, const R& rhs, const Op operation = {}) {
+    if constexpr (arithmetic<L>) {
+        const auto r = as_expr(rhs);
+        using S = scalar_expr<L, decltype(r)::order>;
+        return binary_expr<Op, S, decltype(r)>(S(lhs, r.extents()), r, operation);
+    } else if constexpr (arithmetic<R>) {
+        const auto l = as_expr(lhs);
+        using S = scalar_expr<R, decltype(l)::order>;
+        return binary_expr<Op, decltype(l), S>(l, S(rhs, l.extents()), operation);
+    } else {
+        const auto l = as_expr(lhs);
+        const auto r = as_expr(rhs);
+        return binary_expr<Op, decltype(l), decltype(r)>(l, r, operation);
+    }
+}
+
+}  // namespace detail
+
+/**
+ * @brief Lazily broadcasts the expression or tensor to the provided extents without copying, as in
+ * NumPy. Leading axes may be added and axes of extent one are repeated.
+ * @param x Expression or tensor, which has to outlive the returned expression.
+ * @param extents Extents to broadcast to.
+ * @return Expression of order `N`.
+ */
+template <detail::operand X, size_type N>
+    requires(!arithmetic<X>)
+[[nodiscard]] constexpr auto broadcast_to(const X& x, const array<N> extents) {
+    const auto e = detail::as_expr(x);
+    static_assert(decltype(e)::order <= N, "Broadcasting cannot remove axes.");
+    return broadcast_expr<decltype(e), N>(e, extents);
+}
+
+/**
+ * @brief Lazily combines two operands via the callable, broadcasting them as the arithmetic
+ * operators do. Tensors are referred to, hence temporaries are rejected.
+ * @param lhs Left-hand side expression, tensor or scalar.
+ * @param rhs Right-hand side expression, tensor or scalar.
+ * @param func Callable taking a value of either operand, wrapped in `op::packed` if it also
+ * accepts SIMD packs.
+ * @return Expression with the value type of the left-hand side, or of the right-hand side if the
+ * former is a scalar.
+ */
+template <detail::borrowable L, detail::borrowable R, typename F>
+    requires(!arithmetic<std::remove_cvref_t<L> > || !arithmetic<std::remove_cvref_t<R> >)
+[[nodiscard]] constexpr auto zip(L&& lhs, R&& rhs, const F func) {
+    return detail::make_binary(lhs, rhs, op::zip<F>{func});
+}
+
+/**
+ * @brief Lazily adds two operands at least one of which is an expression.
+ * @param lhs Left-hand side expression, tensor or scalar.
+ * @param rhs Right-hand side expression, tensor or scalar.
+ * @return Expression representing the addition.
+ */
+template <detail::operand L, detail::operand R>
+    requires(expression<L> || expression<R>)
+[[nodiscard]] constexpr auto operator+(const L& lhs, const R& rhs) {
+    return detail::make_binary<op::add>(lhs, rhs);
+}
+
+/**
+ * @brief Lazily subtracts two operands at least one of which is an expression.
+ * @param lhs Left-hand side expression, tensor or scalar.
+ * @param rhs Right-hand side expression, tensor or scalar.
+ * @return Expression representing the subtraction.
+ */
+template <detail::operand L, detail::operand R>
+    requires(expression<L> || expression<R>)
+[[nodiscard]] constexpr auto operator-(const L& lhs, const R& rhs) {
+    return detail::make_binary<op::sub>(lhs, rhs);
+}
+
+/**
+ * @brief Lazily multiplies two operands at least one of which is an expression.
+ * @param lhs Left-hand side expression, tensor or scalar.
+ * @param rhs Right-hand side expression, tensor or scalar.
+ * @return Expression representing the multiplication.
+ */
+template <detail::operand L, detail::operand R>
+    requires(expression<L> || expression<R>)
+[[nodiscard]] constexpr auto operator*(const L& lhs, const R& rhs) {
+    return detail::make_binary<op::mul>(lhs, rhs);
+}
+
+/**
+ * @brief Lazily divides two operands at least one of which is an expression. Division by zero
+ * throws once the expression is evaluated.
+ * @param lhs Left-hand side expression, tensor or scalar.
+ * @param rhs Right-hand side expression, tensor or scalar.
+ * @return Expression representing the division.
+ */
+template <detail::operand L, detail::operand R>
+    requires(expression<L> || expression<R>)
+[[nodiscard]] constexpr auto operator/(const L& lhs, const R& rhs) {
+    return detail::make_binary<op::div>(lhs, rhs);
+}
+
+}  // namespace core
+
+#endif  // EXPR_HPP
@@ -0,0 +1,233 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2022 David Oniani
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef FORMAT_HPP
+#define FORMAT_HPP
+
+#include <array>
+#include <atomic>
+#include <charconv>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <ostream>
+#include <string>
+#include <type_traits>
+
+#include "half.hpp"
+
+/**
+ * @brief Text representations of tensors, built in a string via `std::to_chars` and written to a
+ * stream in a single call. Tensors of more than `threshold()` elements are summarized as in NumPy:
+ * only the first and last `edge_items()` entries along every axis are shown, around `...`.
+ */
+namespace format {
+
+namespace detail {
+
+inline std::atomic<std::size_t> max_size{1000};
+inline std::atomic<std::size_t> edge_count{3};
+
+}  // namespace detail
+
+/**
+ * @brief Sets the number of elements above which tensors are summarized.
+ * @param size Maximum number of elements shown in full.
+ * @return The previous threshold.
+ */
+inline std::size_t set_threshold(const std::size_t size) noexcept {
+    return detail::max_size.exchange(size);
+}
+
+/**
+ * @brief Returns the number of elements above which tensors are summarized.
+ */
+[[nodiscard]] inline std::size_t threshold() noexcept {
+    return detail::max_size.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Sets the number of entries shown at either end of every axis of a summarized tensor.
+ * @param count Number of entries.
+ * @return The previous number.
+ */
+inline std::size_t set_edge_items(const std::size_t count) noexcept {
+    return detail::edge_count.exchange(count);
+}
+
+/**
+ * @brief Returns the number of entries shown at either end of every axis of a summarized tensor.
+ */
+[[nodiscard]] inline std::size_t edge_items() noexcept {
+    return detail::edge_count.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Appends the shortest representation of the value that reads back to the same value.
+ * Integers of character type are written as numbers.
+ * @param out String to append to.
+ * @param val Value to append.
+ */
+template <typename T>
+    requires std::is_arithmetic_v<T>
+void append(std::string& out, const T val) {
+    std::array<char, 64> buf;
+    std::to_chars_result result;
+    if constexpr (std::is_same_v<T, bool>) {
+        result = std::to_chars(buf.data(), buf.data() + buf.size(), static_cast<int>(val));
+    } else {
+        result = std::to_chars(buf.data(), buf.data() + buf.size(), val);
+    }
+    out.append(buf.data(), result.ptr);
+}
+
+/**
+ * @brief Appends the shortest representation of the 16-bit floating-point value that reads back to
+ * the same value, e.g. `0.1` rather than the `0.099975586` of the `float` it converts to.
+ * @param out String to append to.
+ * @param val Value to append.
+ */
+template <core::half_format Format>
+void append(std::string& out, const core::half<Format> val) {
+    using H = core::half<Format>;
+    auto f = static_cast<float>(val);
+    std::array<char, 64> buf;
+    if (std::isfinite(f)) {
+        // The `float` nearest to the fewest digits that identify the value prints as those digits.
+        for (int precision = 1; precision <= std::numeric_limits<H>::max_digits10; ++precision) {
+            const auto digits = std::to_chars(buf.data(), buf.data() + buf.size(), f,
+                                              std::chars_format::general, precision);
+            float parsed = 0;
+            std::from_chars(buf.data(), digits.ptr, parsed);
+            if (H(parsed).bits() == val.bits()) {
+                f = parsed;
+                break;
+            }
+        }
+    }
+    append(out, f);
+}
+
+namespace detail {
+
+template <typename T>
+void append_nested(std::string& out, const T* data, const std::size_t* extents,
+                   const std::size_t order, const bool summarize, const std::size_t edge) {
+    std::size_t inner = 1;
+    for (std::size_t dim = 1; dim < order; ++dim) {
+        inner *= extents[dim];
+    }
+    const auto count = extents[0];
+    const auto skip = summarize && count > 2 * edge;
+
+    out += '{';
+    for (std::size_t idx = 0; idx < count; ++idx) {
+        if (skip && idx == edge) {
+            out += edge == 0 ? "..." : ", ...";
+            idx = count - edge;
+            if (edge == 0) {
+                break;
+            }
+        }
+        if (idx != 0) {
+            out += ", ";
+        }
+        if (order > 1) {
+            append_nested(out, data + idx * inner, extents + 1, order - 1, summarize, edge);
+        } else {
+            append(out, data[idx]);
+        }
+    }
+    out += '}';
+}
+
+}  // namespace detail
+
+/**
+ * @brief Appends the elements of a row-major tensor as nested braces, e.g. `{{1, 2}, {3, 4}}`,
+ * summarized if it holds more than `threshold()` elements.
+ * @param out String to append to.
+ * @param data Pointer to the elements.
+ * @param extents Extents of the tensor.
+ */
+template <typename T, std::size_t Order>
+void append(std::string& out, const T* data, const std::array<std::size_t, Order>& extents) {
+    std::size_t size = 1;
+    for (const auto extent : extents) {
+        size *= extent;
+    }
+    if constexpr (Order == 0) {
+        append(out, *data);
+    } else {
+        detail::append_nested(out, data, extents.data(), Order, size > threshold(), edge_items());
+    }
+}
+
+/**
+ * @brief Appends the elements of a row-major tensor separated by spaces, e.g. `{ 1 2 3 4 }`,
+ * summarized if it holds more than `threshold()` elements.
+ * @param out String to append to.
+ * @param data Pointer to the elements.
+ * @param size Number of elements.
+ */
+template <typename T>
+void append_flat(std::string& out, const T* data, const std::size_t size) {
+    const auto edge = edge_items();
+    const auto skip = size > threshold() && size > 2 * edge;
+    out += "{ ";
+    for (std::size_t idx = 0; idx < size; ++idx) {
+        if (skip && idx == edge) {
+            out += "... ";
+            idx = size - edge;
+            if (idx == size) {
+                break;
+            }
+        }
+        append(out, data[idx]);
+        out += ' ';
+    }
+    out += '}';
+}
+
+/**
+ * @brief Returns the representation of a tensor or static tensor, see `append`.
+ * @param t Tensor to represent.
+ */
+template <typename X>
+[[nodiscard]] std::string to_string(const X& t) {
+    std::string result;
+    append(result, t.data(), t.extents());
+    return result;
+}
+
+/**
+ * @brief Writes the string to the stream in a single call.
+ */
+inline void write(std::ostream& out, const std::string& str) {
+    out.write(str.data(), static_cast<std::streamsize>(str.size()));
+}
+
+}  // namespace format
+
+#endif  // FORMAT_HPP
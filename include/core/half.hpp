@@ -0,0 +1,405 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2022 David Oniani
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef HALF_HPP
+#define HALF_HPP
+
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+namespace core {
+
+/**
+ * @brief Layouts of 16-bit floating-point numbers: IEEE 754 binary16, i.e. 5 exponent and 10
+ * mantissa bits, and bfloat16, i.e. the upper half of a binary32 with 8 exponent and 7 mantissa
+ * bits.
+ */
+enum class half_format { binary16, bfloat16 };
+
+namespace detail {
+
+/**
+ * @brief Rounds a `float` to the nearest binary16, ties to even, keeping NaN quiet.
+ */
+[[nodiscard]] constexpr std::uint16_t to_binary16(const float val) noexcept {
+    const auto bits = std::bit_cast<std::uint32_t>(val);
+    const auto sign = static_cast<std::uint16_t>((bits >> 16) & 0x8000U);
+    const auto abs = bits & 0x7FFFFFFFU;
+    if (abs > 0x7F800000U) {
+        return static_cast<std::uint16_t>(sign | 0x7E00U | ((abs >> 13) & 0x3FFU));
+    }
+    // Anything from halfway between the largest finite value and infinity upwards overflows.
+    if (abs >= 0x477FF000U) {
+        return static_cast<std::uint16_t>(sign | 0x7C00U);
+    }
+    if (abs < 0x38800000U) {
+        // Subnormal, i.e. a multiple of 2^-24, rounded explicitly.
+        const auto shift = 126 - (abs >> 23);
+        if (shift > 24) {
+            return sign;
+        }
+        const auto mantissa = (abs & 0x7FFFFFU) | 0x800000U;
+        auto result = mantissa >> shift;
+        const auto rest = mantissa & ((1U << shift) - 1);
+        const auto halfway = 1U << (shift - 1);
+        result += rest > halfway || (rest == halfway && (result & 1U) != 0) ? 1 : 0;
+        return static_cast<std::uint16_t>(sign | result);
+    }
+    const auto rounded = abs + 0xFFFU + ((abs >> 13) & 1U);
+    return static_cast<std::uint16_t>(sign | ((rounded - 0x38000000U) >> 13));
+}
+
+[[nodiscard]] constexpr float from_binary16(const std::uint16_t bits) noexcept {
+    const auto sign = static_cast<std::uint32_t>(bits & 0x8000U) << 16;
+    const auto exponent = (bits >> 10) & 0x1FU;
+    const auto mantissa = static_cast<std::uint32_t>(bits & 0x3FFU);
+    if (exponent == 0x1F) {
+        return std::bit_cast<float>(sign | 0x7F800000U | (mantissa << 13));
+    }
+    if (exponent == 0) {
+        const auto magnitude = static_cast<float>(mantissa) * 0x1p-24F;
+        return std::bit_cast<float>(sign | std::bit_cast<std::uint32_t>(magnitude));
+    }
+    return std::bit_cast<float>(sign | ((exponent + 112) << 23) | (mantissa << 13));
+}
+
+/**
+ * @brief Rounds a `float` to the nearest bfloat16, ties to even, keeping NaN quiet.
+ */
+[[nodiscard]] constexpr std::uint16_t to_bfloat16(const float val) noexcept {
+    const auto bits = std::bit_cast<std::uint32_t>(val);
+    if ((bits & 0x7FFFFFFFU) > 0x7F800000U) {
+        return static_cast<std::uint16_t>((bits >> 16) | 0x40U);
+    }
+    return static_cast<std::uint16_t>((bits + 0x7FFFU + ((bits >> 16) & 1U)) >> 16);
+}
+
+[[nodiscard]] constexpr float from_bfloat16(const std::uint16_t bits) noexcept {
+    return std::bit_cast<float>(static_cast<std::uint32_t>(bits) << 16);
+}
+
+}  // namespace detail
+
+/**
+ * @brief Defines a 16-bit floating-point number for storage. Values convert implicitly to and from
+ * `float`, in which all arithmetic is carried out, rounding to nearest even on the way back.
+ * @tparam Format Layout of the bits.
+ */
+template <half_format Format>
+class half {
+   private:
+    std::uint16_t m_bits{0};
+
+    [[nodiscard]] static constexpr std::uint16_t encode(const float val) noexcept {
+        if constexpr (Format == half_format::binary16) {
+            return detail::to_binary16(val);
+        } else {
+            return detail::to_bfloat16(val);
+        }
+    }
+
+   public:
+    static constexpr half_format format = Format;
+
+    /**
+     * @brief Constructs positive zero.
+     */
+    constexpr half() noexcept = default;
+
+    /**
+     * @brief Constructs the nearest representable value via `float`.
+     * @param val Value to round.
+     */
+    template <typename U>
+        requires std::is_arithmetic_v<U>
+    constexpr half(const U val) noexcept : m_bits{encode(static_cast<float>(val))} {}
+
+    /**
+     * @brief Constructs a value from its bit pattern.
+     * @param bits Bits of the value.
+     * @return The value.
+     */
+    [[nodiscard]] static constexpr half from_bits(const std::uint16_t bits) noexcept {
+        half result;
+        result.m_bits = bits;
+        return result;
+    }
+
+    /**
+     * @brief Returns the bit pattern of the value.
+     */
+    [[nodiscard]] constexpr std::uint16_t bits() const noexcept {
+        return m_bits;
+    }
+
+    /**
+     * @brief Converts the value to `float`, which is exact.
+     */
+    constexpr operator float() const noexcept {
+        if constexpr (Format == half_format::binary16) {
+            return detail::from_binary16(m_bits);
+        } else {
+            return detail::from_bfloat16(m_bits);
+        }
+    }
+
+    template <typename U>
+        requires std::is_arithmetic_v<U>
+    constexpr half& operator+=(const U val) noexcept {
+        return *this = static_cast<float>(*this) + val;
+    }
+
+    template <typename U>
+        requires std::is_arithmetic_v<U>
+    constexpr half& operator-=(const U val) noexcept {
+        return *this = static_cast<float>(*this) - val;
+    }
+
+    template <typename U>
+        requires std::is_arithmetic_v<U>
+    constexpr half& operator*=(const U val) noexcept {
+        return *this = static_cast<float>(*this) * val;
+    }
+
+    template <typename U>
+        requires std::is_arithmetic_v<U>
+    constexpr half& operator/=(const U val) noexcept {
+        return *this = static_cast<float>(*this) / val;
+    }
+
+    constexpr half& operator+=(const half val) noexcept {
+        return *this += static_cast<float>(val);
+    }
+
+    constexpr half& operator-=(const half val) noexcept {
+        return *this -= static_cast<float>(val);
+    }
+
+    constexpr half& operator*=(const half val) noexcept {
+        return *this *= static_cast<float>(val);
+    }
+
+    constexpr half& operator/=(const half val) noexcept {
+        return *this /= static_cast<float>(val);
+    }
+
+    // The math functions found via argument-dependent lookup compute in `float`.
+
+    [[nodiscard]] friend float sqrt(const half val) noexcept {
+        return std::sqrt(static_cast<float>(val));
+    }
+
+    [[nodiscard]] friend float sin(const half val) noexcept {
+        return std::sin(static_cast<float>(val));
+    }
+
+    [[nodiscard]] friend float cos(const half val) noexcept {
+        return std::cos(static_cast<float>(val));
+    }
+
+    [[nodiscard]] friend float tan(const half val) noexcept {
+        return std::tan(static_cast<float>(val));
+    }
+
+    [[nodiscard]] friend float exp(const half val) noexcept {
+        return std::exp(static_cast<float>(val));
+    }
+
+    [[nodiscard]] friend float log(const half val) noexcept {
+        return std::log(static_cast<float>(val));
+    }
+
+    [[nodiscard]] friend float tanh(const half val) noexcept {
+        return std::tanh(static_cast<float>(val));
+    }
+
+    [[nodiscard]] friend float round(const half val) noexcept {
+        return std::round(static_cast<float>(val));
+    }
+
+    [[nodiscard]] friend float abs(const half val) noexcept {
+        return std::abs(static_cast<float>(val));
+    }
+
+    template <typename E>
+    [[nodiscard]] friend auto pow(const half val, const E exp) noexcept {
+        return std::pow(static_cast<float>(val), exp);
+    }
+};
+
+/**
+ * @brief IEEE 754 binary16, of which the exponent spans up to 65504 and the mantissa about three
+ * decimal digits.
+ */
+using float16 = half<half_format::binary16>;
+
+/**
+ * @brief bfloat16, which has the range of `float` and a mantissa of about two decimal digits.
+ */
+using bfloat16 = half<half_format::bfloat16>;
+
+template <typename T>
+struct is_half : std::false_type {};
+
+template <half_format Format>
+struct is_half<half<Format> > : std::true_type {};
+
+/**
+ * @brief Whether the type is one of the 16-bit floating-point types, which are stored as such but
+ * computed in `float`.
+ */
+template <typename T>
+inline constexpr bool is_half_v = is_half<std::remove_cv_t<T> >::value;
+
+/**
+ * @brief Type arithmetic on elements of type `T` is carried out in, i.e. `float` for the 16-bit
+ * floating-point types and `T` otherwise.
+ */
+template <typename T>
+using compute_t = std::conditional_t<is_half_v<T>, float, std::remove_cv_t<T> >;
+
+namespace detail {
+
+/**
+ * @brief Shared properties of both 16-bit floating-point types.
+ */
+struct half_limits {
+    static constexpr bool is_specialized = true;
+    static constexpr bool is_signed = true;
+    static constexpr bool is_integer = false;
+    static constexpr bool is_exact = false;
+    static constexpr bool has_infinity = true;
+    static constexpr bool has_quiet_NaN = true;
+    static constexpr bool has_signaling_NaN = true;
+    static constexpr bool is_iec559 = false;
+    static constexpr bool is_bounded = true;
+    static constexpr bool is_modulo = false;
+    static constexpr bool traps = false;
+    static constexpr bool tinyness_before = false;
+    static constexpr int radix = 2;
+    static constexpr std::float_round_style round_style = std::round_to_nearest;
+};
+
+}  // namespace detail
+
+}  // namespace core
+
+template <>
+struct std::numeric_limits<core::float16> : core::detail::half_limits {
+    static constexpr int digits = 11;
+    static constexpr int digits10 = 3;
+    static constexpr int max_digits10 = 5;
+    static constexpr int min_exponent = -13;
+    static constexpr int min_exponent10 = -4;
+    static constexpr int max_exponent = 16;
+    static constexpr int max_exponent10 = 4;
+
+    [[nodiscard]] static constexpr core::float16 min() noexcept {
+        return core::float16::from_bits(0x0400);
+    }
+
+    [[nodiscard]] static constexpr core::float16 max() noexcept {
+        return core::float16::from_bits(0x7BFF);
+    }
+
+    [[nodiscard]] static constexpr core::float16 lowest() noexcept {
+        return core::float16::from_bits(0xFBFF);
+    }
+
+    [[nodiscard]] static constexpr core::float16 epsilon() noexcept {
+        return core::float16::from_bits(0x1400);
+    }
+
+    [[nodiscard]] static constexpr core::float16 round_error() noexcept {
+        return core::float16::from_bits(0x3800);
+    }
+
+    [[nodiscard]] static constexpr core::float16 infinity() noexcept {
+        return core::float16::from_bits(0x7C00);
+    }
+
+    [[nodiscard]] static constexpr core::float16 quiet_NaN() noexcept {
+        return core::float16::from_bits(0x7E00);
+    }
+
+    [[nodiscard]] static constexpr core::float16 signaling_NaN() noexcept {
+        return core::float16::from_bits(0x7D00);
+    }
+
+    [[nodiscard]] static constexpr core::float16 denorm_min() noexcept {
+        return core::float16::from_bits(0x0001);
+    }
+};
+
+template <>
+struct std::numeric_limits<core::bfloat16> : core::detail::half_limits {
+    static constexpr int digits = 8;
+    static constexpr int digits10 = 2;
+    static constexpr int max_digits10 = 4;
+    static constexpr int min_exponent = -125;
+    static constexpr int min_exponent10 = -37;
+    static constexpr int max_exponent = 128;
+    static constexpr int max_exponent10 = 38;
+
+    [[nodiscard]] static constexpr core::bfloat16 min() noexcept {
+        return core::bfloat16::from_bits(0x0080);
+    }
+
+    [[nodiscard]] static constexpr core::bfloat16 max() noexcept {
+        return core::bfloat16::from_bits(0x7F7F);
+    }
+
+    [[nodiscard]] static constexpr core::bfloat16 lowest() noexcept {
+        return core::bfloat16::from_bits(0xFF7F);
+    }
+
+    [[nodiscard]] static constexpr core::bfloat16 epsilon() noexcept {
+        return core::bfloat16::from_bits(0x3C00);
+    }
+
+    [[nodiscard]] static constexpr core::bfloat16 round_error() noexcept {
+        return core::bfloat16::from_bits(0x3F00);
+    }
+
+    [[nodiscard]] static constexpr core::bfloat16 infinity() noexcept {
+        return core::bfloat16::from_bits(0x7F80);
+    }
+
+    [[nodiscard]] static constexpr core::bfloat16 quiet_NaN() noexcept {
+        return core::bfloat16::from_bits(0x7FC0);
+    }
+
+    [[nodiscard]] static constexpr core::bfloat16 signaling_NaN() noexcept {
+        return core::bfloat16::from_bits(0x7FA0);
+    }
+
+    [[nodiscard]] static constexpr core::bfloat16 denorm_min() noexcept {
+        return core::bfloat16::from_bits(0x0001);
+    }
+};
+
+#endif  // HALF_HPP
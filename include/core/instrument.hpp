@@ -0,0 +1,311 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2022 David Oniani
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef INSTRUMENT_HPP
+#define INSTRUMENT_HPP
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Enables the instrumentation of tensor operations. When zero, the default, the hooks
+ * compile to nothing and the counters stay empty.
+ */
+#ifndef TENSOR_INSTRUMENT
+#define TENSOR_INSTRUMENT 0
+#endif
+
+#if TENSOR_INSTRUMENT
+#define TENSOR_RECORD(operation, elements) \
+    const instrument::scope tensor_record_scope(instrument::op::operation, elements)
+#else
+#define TENSOR_RECORD(operation, elements) static_cast<void>(0)
+#endif
+
+/**
+ * @brief Per-operation counters of tensor operations, compiled in with `TENSOR_INSTRUMENT=1`. Every
+ * operation counts its calls, the elements it processes, the bytes allocated and copied while it
+ * runs and its wall time, both in total and as a histogram over powers of two nanoseconds. Times
+ * include nested operations, e.g. the copy `operator+` starts with, while bytes are attributed to
+ * the innermost operation only. Counters are shared by all threads.
+ */
+namespace instrument {
+
+/**
+ * @brief Whether the hooks are compiled in.
+ */
+inline constexpr bool enabled = TENSOR_INSTRUMENT != 0;
+
+/**
+ * @brief Number of histogram buckets. Bucket `k` counts calls taking less than `2^k` and at least
+ * `2^(k - 1)` nanoseconds, the last one all longer ones.
+ */
+inline constexpr std::size_t buckets = 32;
+
+/**
+ * @brief Instrumented operations.
+ */
+enum class op : std::size_t {
+    construct,
+    copy,
+    copy_assign,
+    evaluate,
+    get,
+    add,
+    subtract,
+    multiply,
+    divide,
+    add_assign,
+    subtract_assign,
+    multiply_assign,
+    divide_assign,
+    compare,
+    pow,
+    square,
+    sqrt,
+    sin,
+    cos,
+    tan,
+    round,
+    exp,
+    log,
+    tanh,
+    abs,
+    transform_inplace,
+    count
+};
+
+/**
+ * @brief Returns the name of the operation as it appears in reports.
+ * @param operation Instrumented operation.
+ */
+[[nodiscard]] constexpr std::string_view name(const op operation) noexcept {
+    constexpr std::array<std::string_view, static_cast<std::size_t>(op::count)> names = {
+        "tensor(extents)", "tensor(const tensor&)", "operator=(const tensor&)", "evaluate",
+        "get",             "operator+",             "operator-",                "operator*",
+        "operator/",       "operator+=",            "operator-=",               "operator*=",
+        "operator/=",      "compare",               "pow",                      "square",
+        "sqrt",            "sin",                   "cos",                      "tan",
+        "round",           "exp",                   "log",                      "tanh",
+        "abs",             "transform_inplace"};
+    return names[static_cast<std::size_t>(operation)];
+}
+
+/**
+ * @brief Counters of an operation at the time of a snapshot.
+ */
+struct record {
+    std::string_view name;
+    std::uint64_t calls{0};
+    std::uint64_t elements{0};
+    std::uint64_t bytes_allocated{0};
+    std::uint64_t bytes_copied{0};
+    std::uint64_t nanoseconds{0};
+    std::array<std::uint64_t, buckets> histogram{};
+};
+
+namespace detail {
+
+struct counters {
+    std::atomic<std::uint64_t> calls{0};
+    std::atomic<std::uint64_t> elements{0};
+    std::atomic<std::uint64_t> bytes_allocated{0};
+    std::atomic<std::uint64_t> bytes_copied{0};
+    std::atomic<std::uint64_t> nanoseconds{0};
+    std::array<std::atomic<std::uint64_t>, buckets> histogram{};
+};
+
+inline std::array<counters, static_cast<std::size_t>(op::count)> table{};
+
+// Innermost operation running on the calling thread, which allocations and copies are charged to.
+inline thread_local counters* current = nullptr;
+
+}  // namespace detail
+
+/**
+ * @brief Counts a call of an operation for the lifetime of the scope, see `TENSOR_RECORD`.
+ */
+class scope {
+   private:
+    detail::counters* m_counters{nullptr};
+    detail::counters* m_previous{nullptr};
+    std::chrono::steady_clock::time_point m_start{};
+
+    void enter(const op operation, const std::size_t elements) noexcept {
+        m_counters = &detail::table[static_cast<std::size_t>(operation)];
+        m_counters->calls.fetch_add(1, std::memory_order_relaxed);
+        m_counters->elements.fetch_add(elements, std::memory_order_relaxed);
+        m_previous = std::exchange(detail::current, m_counters);
+        m_start = std::chrono::steady_clock::now();
+    }
+
+    void leave() noexcept {
+        const auto elapsed = std::chrono::steady_clock::now() - m_start;
+        const auto ns = static_cast<std::uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+        m_counters->nanoseconds.fetch_add(ns, std::memory_order_relaxed);
+        const auto bucket = std::min<std::size_t>(std::bit_width(ns), buckets - 1);
+        m_counters->histogram[bucket].fetch_add(1, std::memory_order_relaxed);
+        detail::current = m_previous;
+    }
+
+   public:
+    /**
+     * @brief Counts a call processing the provided number of elements. Nothing is counted during
+     * constant evaluation.
+     * @param operation Instrumented operation.
+     * @param elements Number of elements processed.
+     */
+    constexpr scope(const op operation, const std::size_t elements) noexcept {
+        if (!std::is_constant_evaluated()) {
+            enter(operation, elements);
+        }
+    }
+
+    scope(const scope&) = delete;
+    scope& operator=(const scope&) = delete;
+
+    constexpr ~scope() {
+        if (!std::is_constant_evaluated()) {
+            leave();
+        }
+    }
+};
+
+namespace detail {
+
+inline void charge(std::atomic<std::uint64_t> counters::*const counter,
+                   const std::size_t bytes) noexcept {
+    if (current != nullptr) {
+        (current->*counter).fetch_add(bytes, std::memory_order_relaxed);
+    }
+}
+
+}  // namespace detail
+
+/**
+ * @brief Charges allocated bytes to the operation running on the calling thread, if any.
+ * @param bytes Number of bytes.
+ */
+constexpr void allocated(const std::size_t bytes) noexcept {
+    if (enabled && !std::is_constant_evaluated()) {
+        detail::charge(&detail::counters::bytes_allocated, bytes);
+    }
+}
+
+/**
+ * @brief Charges copied bytes to the operation running on the calling thread, if any.
+ * @param bytes Number of bytes.
+ */
+constexpr void copied(const std::size_t bytes) noexcept {
+    if (enabled && !std::is_constant_evaluated()) {
+        detail::charge(&detail::counters::bytes_copied, bytes);
+    }
+}
+
+/**
+ * @brief Invokes the callable with the counters of every operation called at least once.
+ * @param func Callable taking a `const record&`.
+ */
+template <typename F>
+void for_each(F&& func) {
+    for (std::size_t idx = 0; idx < detail::table.size(); ++idx) {
+        const auto& counters = detail::table[idx];
+        record result;
+        result.calls = counters.calls.load(std::memory_order_relaxed);
+        if (result.calls == 0) {
+            continue;
+        }
+        result.name = name(static_cast<op>(idx));
+        result.elements = counters.elements.load(std::memory_order_relaxed);
+        result.bytes_allocated = counters.bytes_allocated.load(std::memory_order_relaxed);
+        result.bytes_copied = counters.bytes_copied.load(std::memory_order_relaxed);
+        result.nanoseconds = counters.nanoseconds.load(std::memory_order_relaxed);
+        for (std::size_t bucket = 0; bucket < buckets; ++bucket) {
+            result.histogram[bucket] = counters.histogram[bucket].load(std::memory_order_relaxed);
+        }
+        func(std::as_const(result));
+    }
+}
+
+/**
+ * @brief Returns the counters of every operation called at least once.
+ */
+[[nodiscard]] inline std::vector<record> snapshot() {
+    std::vector<record> result;
+    for_each([&result](const record& r) { result.push_back(r); });
+    return result;
+}
+
+/**
+ * @brief Writes the counters of every operation called at least once as a JSON object holding an
+ * array `operations`, with one object per operation.
+ * @param out Output stream.
+ */
+inline void write_json(std::ostream& out) {
+    out << "{\"operations\": [";
+    auto first = true;
+    for_each([&](const record& r) {
+        out << (first ? "" : ", ") << "{\"name\": \"" << r.name << "\", \"calls\": " << r.calls
+            << ", \"elements\": " << r.elements << ", \"bytes_allocated\": " << r.bytes_allocated
+            << ", \"bytes_copied\": " << r.bytes_copied << ", \"nanoseconds\": " << r.nanoseconds
+            << ", \"histogram\": [";
+        for (std::size_t bucket = 0; bucket < buckets; ++bucket) {
+            out << (bucket == 0 ? "" : ", ") << r.histogram[bucket];
+        }
+        out << "]}";
+        first = false;
+    });
+    out << "]}";
+}
+
+/**
+ * @brief Resets every counter to zero. Operations running concurrently may be partially counted.
+ */
+inline void reset() noexcept {
+    for (auto& counters : detail::table) {
+        counters.calls.store(0, std::memory_order_relaxed);
+        counters.elements.store(0, std::memory_order_relaxed);
+        counters.bytes_allocated.store(0, std::memory_order_relaxed);
+        counters.bytes_copied.store(0, std::memory_order_relaxed);
+        counters.nanoseconds.store(0, std::memory_order_relaxed);
+        for (auto& bucket : counters.histogram) {
+            bucket.store(0, std::memory_order_relaxed);
+        }
+    }
+}
+
+}  // namespace instrument
+
+#endif  // INSTRUMENT_HPP
@@ -0,0 +1,418 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2022 David Oniani
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef IO_HPP
+#define IO_HPP
+
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <istream>
+#include <memory_resource>
+#include <mutex>
+#include <numeric>
+#include <ostream>
+#include <stdexcept>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#if __has_include(<sys/mman.h>)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "core.hpp"
+
+/**
+ * @brief Binary serialization of tensors. A file starts with a 16-byte header holding the magic
+ * `TNSR`, the format version, the byte order, the kind (`b` for bool, `i` for signed and `u` for
+ * unsigned integers, `f` for floating-point and `B` for bfloat16) and size of the element type,
+ * the order and the offset of the elements. The extents and strides follow as 64-bit integers,
+ * padded with zeros so that the elements, written in row-major order, start at a multiple of
+ * `memory::alignment`. Every integer is stored in the byte order of the header.
+ */
+namespace io {
+
+namespace detail {
+
+inline constexpr char magic[4] = {'T', 'N', 'S', 'R'};
+inline constexpr std::uint8_t version = 1;
+inline constexpr std::size_t fixed_header = 16;
+
+/**
+ * @brief Returns the character identifying the kind of the element type, as in NumPy. NumPy has
+ * no bfloat16, which is identified by `B`.
+ */
+template <arithmetic T>
+[[nodiscard]] constexpr char kind() noexcept {
+    if constexpr (std::is_same_v<T, bool>) {
+        return 'b';
+    } else if constexpr (std::is_same_v<T, core::bfloat16>) {
+        return 'B';
+    } else if constexpr (std::is_floating_point_v<T> || core::is_half_v<T>) {
+        return 'f';
+    } else if constexpr (std::is_signed_v<T>) {
+        return 'i';
+    } else {
+        return 'u';
+    }
+}
+
+/**
+ * @brief Returns the character identifying the byte order of the host, as in NumPy.
+ */
+[[nodiscard]] constexpr char byte_order() noexcept {
+    return std::endian::native == std::endian::little ? '<' : '>';
+}
+
+/**
+ * @brief Rounds the number of bytes up to a multiple of the alignment of tensor buffers.
+ */
+[[nodiscard]] constexpr std::size_t aligned(const std::size_t bytes) noexcept {
+    return (bytes + memory::alignment - 1) / memory::alignment * memory::alignment;
+}
+
+/**
+ * @brief Describes the layout of a serialized tensor.
+ */
+template <size_type Order>
+struct layout {
+    array<Order> extents;
+    size_type size;
+    std::size_t offset;
+};
+
+template <typename U>
+void put(std::vector<char>& bytes, const std::size_t pos, const U val) noexcept {
+    std::memcpy(bytes.data() + pos, &val, sizeof(U));
+}
+
+template <typename U>
+[[nodiscard]] U take(const char* bytes, const std::size_t pos) noexcept {
+    U val;
+    std::memcpy(&val, bytes + pos, sizeof(U));
+    return val;
+}
+
+/**
+ * @brief Encodes the header, including the padding, of a tensor of the provided extents.
+ */
+template <arithmetic T, size_type Order>
+[[nodiscard]] std::vector<char> encode(const array<Order>& extents) {
+    const auto offset = aligned(fixed_header + 2 * Order * sizeof(std::uint64_t));
+    const auto strides = core::detail::row_major_strides(extents);
+    std::vector<char> bytes(offset, 0);
+    std::memcpy(bytes.data(), magic, sizeof(magic));
+    put(bytes, 4, version);
+    put(bytes, 5, byte_order());
+    put(bytes, 6, kind<T>());
+    put(bytes, 7, static_cast<std::uint8_t>(sizeof(T)));
+    put(bytes, 8, static_cast<std::uint32_t>(Order));
+    put(bytes, 12, static_cast<std::uint32_t>(offset));
+    for (size_type dim = 0; dim < Order; ++dim) {
+        put(bytes, fixed_header + dim * 8, static_cast<std::uint64_t>(extents[dim]));
+        put(bytes, fixed_header + (Order + dim) * 8, static_cast<std::uint64_t>(strides[dim]));
+    }
+    return bytes;
+}
+
+/**
+ * @brief Validates the fixed part of a header against the element type and order.
+ * @return Offset of the elements.
+ */
+template <arithmetic T, size_type Order>
+[[nodiscard]] std::size_t check(const char* bytes) {
+    if (std::memcmp(bytes, magic, sizeof(magic)) != 0 || take<std::uint8_t>(bytes, 4) != version) {
+        throw std::runtime_error("Invalid tensor file.");
+    }
+    if (take<char>(bytes, 5) != byte_order()) {
+        throw std::runtime_error("Unsupported byte order.");
+    }
+    if (take<char>(bytes, 6) != kind<T>() || take<std::uint8_t>(bytes, 7) != sizeof(T)) {
+        throw std::runtime_error("Tensor type mismatch.");
+    }
+    if (take<std::uint32_t>(bytes, 8) != Order) {
+        throw std::runtime_error("Tensor dimension mismatch.");
+    }
+    const auto offset = take<std::uint32_t>(bytes, 12);
+    if (offset < fixed_header + 2 * Order * sizeof(std::uint64_t)) {
+        throw std::runtime_error("Invalid tensor file.");
+    }
+    return offset;
+}
+
+/**
+ * @brief Decodes the extents and strides following the fixed part of a header. Only row-major
+ * layouts are accepted.
+ */
+template <size_type Order>
+[[nodiscard]] layout<Order> decode(const char* bytes, const std::size_t offset) {
+    layout<Order> result{{}, 1, offset};
+    array<Order> strides{};
+    for (size_type dim = 0; dim < Order; ++dim) {
+        result.extents[dim] = take<std::uint64_t>(bytes, dim * 8);
+        strides[dim] = take<std::uint64_t>(bytes, (Order + dim) * 8);
+        result.size *= result.extents[dim];
+    }
+    if (strides != core::detail::row_major_strides(result.extents)) {
+        throw std::runtime_error("Unsupported tensor layout.");
+    }
+    return result;
+}
+
+/**
+ * @brief A resource owning memory-mapped files, each of which is unmapped once the tensor
+ * holding its elements returns them. Other requests, from tensors adopting a mapping and later
+ * reassigned to a different size, are forwarded to `memory::aligned_resource()`.
+ */
+class mapping_resource final : public std::pmr::memory_resource {
+   private:
+    struct mapping {
+        void* base;
+        std::size_t length;
+    };
+
+    std::unordered_map<const void*, mapping> m_mappings;
+    std::mutex m_mutex;
+
+    void* do_allocate(const std::size_t bytes, const std::size_t align) override {
+        return memory::aligned_resource()->allocate(bytes, align);
+    }
+
+    void do_deallocate(void* const data, const std::size_t bytes,
+                       const std::size_t align) override {
+        {
+            std::lock_guard lock(m_mutex);
+            if (const auto it = m_mappings.find(data); it != m_mappings.end()) {
+#if TENSOR_HAS_MMAP
+                ::munmap(it->second.base, it->second.length);
+#endif
+                m_mappings.erase(it);
+                return;
+            }
+        }
+        memory::aligned_resource()->deallocate(data, bytes, align);
+    }
+
+    [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+
+   public:
+    /**
+     * @brief Registers a mapping whose elements start at `data`.
+     */
+    void adopt(const void* const data, void* const base, const std::size_t length) {
+        std::lock_guard lock(m_mutex);
+        m_mappings.emplace(data, mapping{base, length});
+    }
+
+    /**
+     * @brief Returns the number of files currently mapped.
+     */
+    [[nodiscard]] std::size_t mapped() {
+        std::lock_guard lock(m_mutex);
+        return m_mappings.size();
+    }
+};
+
+/**
+ * @brief Returns the resource owning every memory-mapped file.
+ */
+[[nodiscard]] inline mapping_resource& mappings() {
+    static mapping_resource resource;
+    return resource;
+}
+
+#if TENSOR_HAS_MMAP
+struct mapped_file {
+    void* base;
+    std::size_t length;
+};
+
+/**
+ * @brief Maps the whole file privately, so that writes copy the affected pages.
+ * @param path Path to the file.
+ * @param minimum Minimum length of a valid file.
+ */
+[[nodiscard]] inline mapped_file map_file(const std::filesystem::path& path,
+                                          const std::size_t minimum) {
+    const auto fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        throw std::runtime_error("Cannot open file.");
+    }
+    struct stat info {};
+    if (::fstat(fd, &info) != 0 || static_cast<std::size_t>(info.st_size) < minimum) {
+        ::close(fd);
+        throw std::runtime_error("Invalid tensor file.");
+    }
+    const auto length = static_cast<std::size_t>(info.st_size);
+    auto* const base = ::mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (base == MAP_FAILED) {
+        throw std::runtime_error("Cannot map file.");
+    }
+    return {base, length};
+}
+
+/**
+ * @brief Returns a tensor owning the mapped file whose row-major elements start at `offset`.
+ * Throws if the file is too short to hold them.
+ */
+template <arithmetic T, size_type Order>
+[[nodiscard]] core::tensor<T, Order> adopt(const mapped_file& file, const std::size_t offset,
+                                           const array<Order>& extents) {
+    const auto size = std::reduce(extents.begin(), extents.end(), size_type{1},
+                                  std::multiplies<size_type>());
+    if (file.length < offset || (file.length - offset) / sizeof(T) < size) {
+        throw std::runtime_error("Invalid tensor file.");
+    }
+    if (size == 0) {
+        ::munmap(file.base, file.length);
+        return core::tensor<T, Order>(extents);
+    }
+    auto* const data = reinterpret_cast<T*>(static_cast<char*>(file.base) + offset);
+    mappings().adopt(data, file.base, file.length);
+    return core::tensor<T, Order>(data, extents, &mappings());
+}
+#endif
+
+}  // namespace detail
+
+/**
+ * @brief Writes the tensor to the stream.
+ * @param out Stream opened in binary mode.
+ * @param t Tensor to write.
+ */
+template <arithmetic T, size_type Order>
+void write(std::ostream& out, const core::tensor<T, Order>& t) {
+    const auto header = detail::encode<T>(t.extents());
+    out.write(header.data(), static_cast<std::streamsize>(header.size()));
+    out.write(reinterpret_cast<const char*>(t.data()),
+              static_cast<std::streamsize>(t.size() * sizeof(T)));
+    if (!out) {
+        throw std::runtime_error("Failed to write tensor.");
+    }
+}
+
+/**
+ * @brief Reads a tensor from the stream, straight into the buffer of the returned tensor.
+ * @param in Stream opened in binary mode.
+ * @param resource Memory resource to allocate the elements from.
+ * @return Tensor holding the elements read.
+ */
+template <arithmetic T, size_type Order>
+[[nodiscard]] core::tensor<T, Order> read(
+    std::istream& in, std::pmr::memory_resource* const resource = memory::default_resource()) {
+    char fixed[detail::fixed_header];
+    if (!in.read(fixed, sizeof(fixed))) {
+        throw std::runtime_error("Invalid tensor file.");
+    }
+    const auto offset = detail::check<T, Order>(fixed);
+    std::vector<char> rest(offset - detail::fixed_header);
+    if (!in.read(rest.data(), static_cast<std::streamsize>(rest.size()))) {
+        throw std::runtime_error("Invalid tensor file.");
+    }
+    const auto layout = detail::decode<Order>(rest.data(), offset);
+
+    auto result = core::tensor<T, Order>(layout.extents, resource);
+    if (!in.read(reinterpret_cast<char*>(result.data()),
+                 static_cast<std::streamsize>(result.size() * sizeof(T)))) {
+        throw std::runtime_error("Invalid tensor file.");
+    }
+    return result;
+}
+
+/**
+ * @brief Writes the tensor to the file, replacing it if it exists.
+ * @param path Path to the file.
+ * @param t Tensor to write.
+ */
+template <arithmetic T, size_type Order>
+void save(const std::filesystem::path& path, const core::tensor<T, Order>& t) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        throw std::runtime_error("Cannot open file.");
+    }
+    write(out, t);
+}
+
+/**
+ * @brief Reads a tensor from the file into a newly allocated buffer.
+ * @param path Path to the file.
+ * @param resource Memory resource to allocate the elements from.
+ * @return Tensor holding the elements read.
+ */
+template <arithmetic T, size_type Order>
+[[nodiscard]] core::tensor<T, Order> load(
+    const std::filesystem::path& path,
+    std::pmr::memory_resource* const resource = memory::default_resource()) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        throw std::runtime_error("Cannot open file.");
+    }
+    return read<T, Order>(in, resource);
+}
+
+/**
+ * @brief Maps the file into memory and returns a tensor using the mapped elements in place,
+ * without reading or copying them. Pages are loaded on first access and shared with every other
+ * process mapping the same file through the page cache. The mapping is private: writes to the
+ * tensor copy the affected pages and never reach the file. The file is unmapped once the tensor
+ * is destroyed or reassigned to a different size. Falls back to `load` where memory mapping is
+ * unavailable.
+ * @param path Path to the file.
+ * @return Tensor whose elements are those of the file.
+ */
+template <arithmetic T, size_type Order>
+[[nodiscard]] core::tensor<T, Order> map(const std::filesystem::path& path) {
+#if TENSOR_HAS_MMAP
+    const auto file = detail::map_file(path, detail::fixed_header);
+    const auto* const bytes = static_cast<const char*>(file.base);
+    try {
+        const auto offset = detail::check<T, Order>(bytes);
+        if (file.length < offset) {
+            throw std::runtime_error("Invalid tensor file.");
+        }
+        const auto layout = detail::decode<Order>(bytes + detail::fixed_header, offset);
+        return detail::adopt<T>(file, offset, layout.extents);
+    } catch (...) {
+        ::munmap(file.base, file.length);
+        throw;
+    }
+#else
+    return load<T, Order>(path);
+#endif
+}
+
+}  // namespace io
+
+#endif  // IO_HPP
@@ -0,0 +1,1183 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2022 David Oniani
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef KERNEL_HPP
+#define KERNEL_HPP
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include "parallel.hpp"
+#include "simd.hpp"
+
+namespace core {
+
+/**
+ * @brief Element-wise operations shared by the eager kernels and the nodes of lazily evaluated
+ * expressions. Every operation accepts both scalars and SIMD packs, and `vectorizable` tells
+ * whether the pack overload may be used.
+ */
+namespace op {
+
+struct add {
+    static constexpr bool vectorizable = true;
+
+    constexpr auto operator()(const auto lhs, const auto rhs) const {
+        return lhs + rhs;
+    }
+};
+
+struct sub {
+    static constexpr bool vectorizable = true;
+
+    constexpr auto operator()(const auto lhs, const auto rhs) const {
+        return lhs - rhs;
+    }
+};
+
+struct mul {
+    static constexpr bool vectorizable = true;
+
+    constexpr auto operator()(const auto lhs, const auto rhs) const {
+        return lhs * rhs;
+    }
+};
+
+struct div {
+    static constexpr bool vectorizable = true;
+
+    constexpr auto operator()(const auto lhs, const auto rhs) const {
+        if (simd::any(rhs == 0)) {
+            throw std::domain_error("Division by zero.");
+        }
+        return lhs / rhs;
+    }
+};
+
+template <typename E>
+struct pow {
+    static constexpr bool vectorizable = true;
+
+    E exp;
+
+    constexpr auto operator()(const auto val) const {
+        using std::pow;
+        return pow(val, exp);
+    }
+};
+
+struct square {
+    static constexpr bool vectorizable = true;
+
+    constexpr auto operator()(const auto val) const {
+        return val * val;
+    }
+};
+
+struct sqrt {
+    static constexpr bool vectorizable = true;
+
+    constexpr auto operator()(const auto val) const {
+        using std::sqrt;
+        return sqrt(val);
+    }
+};
+
+struct sin {
+    static constexpr bool vectorizable = TENSOR_FAST_MATH != 0;
+
+    constexpr auto operator()(const auto val) const {
+        using std::sin;
+        return sin(val);
+    }
+};
+
+struct cos {
+    static constexpr bool vectorizable = TENSOR_FAST_MATH != 0;
+
+    constexpr auto operator()(const auto val) const {
+        using std::cos;
+        return cos(val);
+    }
+};
+
+struct tan {
+    static constexpr bool vectorizable = TENSOR_FAST_MATH != 0;
+
+    constexpr auto operator()(const auto val) const {
+        using std::tan;
+        return tan(val);
+    }
+};
+
+struct exp {
+    static constexpr bool vectorizable = TENSOR_FAST_MATH != 0;
+
+    constexpr auto operator()(const auto val) const {
+        using std::exp;
+        return exp(val);
+    }
+};
+
+struct log {
+    static constexpr bool vectorizable = TENSOR_FAST_MATH != 0;
+
+    constexpr auto operator()(const auto val) const {
+        using std::log;
+        return log(val);
+    }
+};
+
+struct tanh {
+    static constexpr bool vectorizable = TENSOR_FAST_MATH != 0;
+
+    constexpr auto operator()(const auto val) const {
+        using std::tanh;
+        return tanh(val);
+    }
+};
+
+struct round {
+    static constexpr bool vectorizable = true;
+
+    constexpr auto operator()(const auto val) const {
+        using std::round;
+        return round(val);
+    }
+};
+
+struct abs {
+    static constexpr bool vectorizable = true;
+
+    constexpr auto operator()(const auto val) const {
+        if constexpr (std::is_unsigned_v<decltype(val)>) {
+            return val;
+        } else {
+            using std::abs;
+            return abs(val);
+        }
+    }
+};
+
+/**
+ * @brief Marks a callable written generically over scalars and packs, e.g. via the operators and
+ * `using std::exp; return exp(x);`, so that `map` and `zip` pass it whole packs.
+ */
+template <typename F>
+struct packed {
+    F func;
+
+    constexpr auto operator()(const auto... vals) const {
+        return func(vals...);
+    }
+};
+
+template <typename F>
+packed(F) -> packed<F>;
+
+template <typename F>
+inline constexpr bool is_packed = false;
+
+template <typename F>
+inline constexpr bool is_packed<packed<F> > = true;
+
+/**
+ * @brief Applies a callable to every element. Callables wrapped in `packed` receive whole packs,
+ * others are applied lane by lane, so that the surrounding loop stays vectorized either way.
+ */
+template <typename F>
+struct map {
+    static constexpr bool vectorizable = true;
+
+    F func;
+
+    constexpr auto operator()(const auto val) const {
+        if constexpr (simd::vector<std::remove_cvref_t<decltype(val)> > && !is_packed<F>) {
+            return simd::map_lanes(val, func);
+        } else {
+            return func(val);
+        }
+    }
+};
+
+/**
+ * @brief Combines pairs of elements via a callable, see `map`.
+ */
+template <typename F>
+struct zip {
+    static constexpr bool vectorizable = true;
+
+    F func;
+
+    constexpr auto operator()(const auto lhs, const auto rhs) const {
+        if constexpr (simd::vector<std::remove_cvref_t<decltype(lhs)> > && !is_packed<F>) {
+            return simd::zip_lanes(lhs, rhs, func);
+        } else {
+            return func(lhs, rhs);
+        }
+    }
+};
+
+// Predicates yield a `bool` for scalars and a `simd::mask` for packs.
+
+struct equal {
+    static constexpr bool vectorizable = true;
+
+    constexpr auto operator()(const auto lhs, const auto rhs) const {
+        return lhs == rhs;
+    }
+};
+
+struct not_equal {
+    static constexpr bool vectorizable = true;
+
+    constexpr auto operator()(const auto lhs, const auto rhs) const {
+        return lhs != rhs;
+    }
+};
+
+struct greater {
+    static constexpr bool vectorizable = true;
+
+    constexpr auto operator()(const auto lhs, const auto rhs) const {
+        return lhs > rhs;
+    }
+};
+
+struct greater_equal {
+    static constexpr bool vectorizable = true;
+
+    constexpr auto operator()(const auto lhs, const auto rhs) const {
+        return lhs >= rhs;
+    }
+};
+
+struct less {
+    static constexpr bool vectorizable = true;
+
+    constexpr auto operator()(const auto lhs, const auto rhs) const {
+        return lhs < rhs;
+    }
+};
+
+struct less_equal {
+    static constexpr bool vectorizable = true;
+
+    constexpr auto operator()(const auto lhs, const auto rhs) const {
+        return lhs <= rhs;
+    }
+};
+
+}  // namespace op
+
+/**
+ * @brief Loops applying element-wise operations over contiguous buffers. Operations are applied to
+ * whole SIMD packs whenever both the element type and the operation allow it, with the remainder
+ * handled by a partial pack so that every element goes through the same code path. Buffers of at
+ * least `parallel::threshold()` elements are split across threads if threading is enabled. Values
+ * of the 16-bit floating-point types are computed in `float` lanes, converted on every load and
+ * store.
+ */
+namespace kernel {
+
+template <typename Op, typename T>
+concept vectorizable = simd::loadable<T> && Op::vectorizable;
+
+/**
+ * @brief Describes strided elements in row-major order, with axes of extent one dropped and
+ * adjacent axes merged wherever the outer one steps over the inner one exactly. The `dims()`
+ * remaining axes are the trailing ones, preceded by axes of extent one, so that loops run over as
+ * few axes as possible and rows along the innermost axis are as long as possible.
+ * @tparam Order Number of axes.
+ */
+template <std::size_t Order>
+class layout {
+   private:
+    std::array<std::size_t, Order> m_extents;
+    std::array<std::size_t, Order> m_strides;
+    std::size_t m_dims{0};
+    std::size_t m_size{1};
+
+   public:
+    /**
+     * @brief Collapses the axes of the provided extents and strides.
+     * @param extents Extents of the elements.
+     * @param strides Distance between consecutive elements along every axis.
+     */
+    constexpr layout(const std::array<std::size_t, Order>& extents,
+                     const std::array<std::size_t, Order>& strides) noexcept {
+        m_extents.fill(1);
+        m_strides.fill(0);
+        for (std::size_t dim = Order; dim-- > 0;) {
+            m_size *= extents[dim];
+            if (extents[dim] == 1) {
+                continue;
+            }
+            // Axes collected so far occupy [outer, Order).
+            const auto outer = Order - m_dims;
+            if (m_dims > 0 && strides[dim] == m_strides[outer] * m_extents[outer]) {
+                m_extents[outer] *= extents[dim];
+            } else {
+                ++m_dims;
+                m_extents[outer - 1] = extents[dim];
+                m_strides[outer - 1] = strides[dim];
+            }
+        }
+        if constexpr (Order > 0) {
+            if (m_dims == 0) {
+                m_strides[Order - 1] = 1;
+            }
+        }
+    }
+
+    /**
+     * @brief Returns the collapsed extents.
+     */
+    [[nodiscard]] constexpr const auto& extents() const noexcept {
+        return m_extents;
+    }
+
+    /**
+     * @brief Returns the collapsed strides.
+     */
+    [[nodiscard]] constexpr const auto& strides() const noexcept {
+        return m_strides;
+    }
+
+    /**
+     * @brief Returns the number of axes of an extent other than one.
+     */
+    [[nodiscard]] constexpr std::size_t dims() const noexcept {
+        return m_dims;
+    }
+
+    /**
+     * @brief Returns the number of elements.
+     */
+    [[nodiscard]] constexpr std::size_t size() const noexcept {
+        return m_size;
+    }
+
+    /**
+     * @brief Returns the number of elements of every row along the innermost axis.
+     */
+    [[nodiscard]] constexpr std::size_t length() const noexcept {
+        if constexpr (Order == 0) {
+            return 1;
+        } else {
+            return m_extents[Order - 1];
+        }
+    }
+
+    /**
+     * @brief Returns the distance between consecutive elements of a row.
+     */
+    [[nodiscard]] constexpr std::size_t stride() const noexcept {
+        if constexpr (Order == 0) {
+            return 1;
+        } else {
+            return m_strides[Order - 1];
+        }
+    }
+
+    /**
+     * @brief Returns whether the elements follow each other without gaps.
+     */
+    [[nodiscard]] constexpr bool is_contiguous() const noexcept {
+        return m_dims == 0 || (m_dims == 1 && stride() == 1);
+    }
+
+    /**
+     * @brief Returns the offset of the first element of the row.
+     * @param row Row-major index of the row.
+     */
+    [[nodiscard]] constexpr std::size_t row_offset(std::size_t row) const noexcept {
+        std::size_t result = 0;
+        if constexpr (Order > 1) {
+            for (std::size_t dim = Order - 1; dim-- > Order - std::max<std::size_t>(m_dims, 1);) {
+                result += row % m_extents[dim] * m_strides[dim];
+                row /= m_extents[dim];
+            }
+        }
+        return result;
+    }
+
+    /**
+     * @brief Returns the offset of the element.
+     * @param idx Row-major index of the element.
+     */
+    [[nodiscard]] constexpr std::size_t offset(const std::size_t idx) const noexcept {
+        const auto count = length();
+        return row_offset(idx / count) + idx % count * stride();
+    }
+
+    /**
+     * @brief Invokes the callable on the rows [first, last) in row-major order.
+     * @param first Index of the first row.
+     * @param last Index past the last row.
+     * @param func Callable invoked as `func(idx, offset)` with the row-major index and the offset
+     * of the first element of every row.
+     */
+    template <typename F>
+    constexpr void for_each_row(const std::size_t first, const std::size_t last, F func) const {
+        std::array<std::size_t, Order> idxs{};
+        auto offset = row_offset(first);
+        if constexpr (Order > 1) {
+            for (std::size_t dim = Order - 1, row = first; dim-- > 0;) {
+                idxs[dim] = row % m_extents[dim];
+                row /= m_extents[dim];
+            }
+        }
+        for (auto row = first; row < last; ++row) {
+            func(row * length(), offset);
+            if constexpr (Order > 1) {
+                for (std::size_t dim = Order - 1; dim-- > 0;) {
+                    offset += m_strides[dim];
+                    if (++idxs[dim] < m_extents[dim]) {
+                        break;
+                    }
+                    offset -= m_strides[dim] * m_extents[dim];
+                    idxs[dim] = 0;
+                }
+            }
+        }
+    }
+};
+
+namespace detail {
+
+template <typename T, typename Op>
+constexpr void transform(T* dst, const T* src, const std::size_t size, const Op operation) {
+    if constexpr (vectorizable<Op, T>) {
+        if (!std::is_constant_evaluated()) {
+            using P = simd::pack<simd::lane_t<T> >;
+            std::size_t idx = 0;
+            for (; idx + P::width <= size; idx += P::width) {
+                simd::store(dst + idx, operation(simd::load(src + idx)));
+            }
+            if (const auto rest = size - idx; rest != 0) {
+                simd::store_partial(dst + idx, operation(simd::load_partial(src + idx, rest)),
+                                    rest);
+            }
+            return;
+        }
+    }
+    for (std::size_t idx = 0; idx < size; ++idx) {
+        dst[idx] = static_cast<T>(operation(src[idx]));
+    }
+}
+
+template <typename T, typename Op>
+constexpr void transform(T* dst, const T* lhs, const T* rhs, const std::size_t size,
+                         const Op operation) {
+    if constexpr (vectorizable<Op, T>) {
+        if (!std::is_constant_evaluated()) {
+            using P = simd::pack<simd::lane_t<T> >;
+            std::size_t idx = 0;
+            for (; idx + P::width <= size; idx += P::width) {
+                simd::store(dst + idx, operation(simd::load(lhs + idx), simd::load(rhs + idx)));
+            }
+            if (const auto rest = size - idx; rest != 0) {
+                const auto result = operation(simd::load_partial(lhs + idx, rest),
+                                              simd::load_partial(rhs + idx, rest));
+                simd::store_partial(dst + idx, result, rest);
+            }
+            return;
+        }
+    }
+    for (std::size_t idx = 0; idx < size; ++idx) {
+        dst[idx] = static_cast<T>(operation(lhs[idx], rhs[idx]));
+    }
+}
+
+template <typename T, typename S, typename Op>
+constexpr void transform(T* dst, const T* lhs, const S rhs, const std::size_t size,
+                         const Op operation) {
+    using U = simd::lane_t<T>;
+    if constexpr (vectorizable<Op, T> &&
+                  (std::is_integral_v<S> || std::is_same_v<S, T> || std::is_same_v<S, U>)) {
+        if (!std::is_constant_evaluated()) {
+            using P = simd::pack<U>;
+            const P val = static_cast<U>(rhs);
+            std::size_t idx = 0;
+            for (; idx + P::width <= size; idx += P::width) {
+                simd::store(dst + idx, operation(simd::load(lhs + idx), val));
+            }
+            if (const auto rest = size - idx; rest != 0) {
+                simd::store_partial(dst + idx, operation(simd::load_partial(lhs + idx, rest), val),
+                                    rest);
+            }
+            return;
+        }
+    }
+    for (std::size_t idx = 0; idx < size; ++idx) {
+        dst[idx] = static_cast<T>(operation(lhs[idx], rhs));
+    }
+}
+
+template <typename T, typename U>
+void convert(U* dst, const T* src, const std::size_t size) {
+    using L = simd::lane_t<T>;
+    if constexpr (simd::loadable<T> && simd::loadable<U> && std::is_same_v<L, simd::lane_t<U> >) {
+        using P = simd::pack<L>;
+        std::size_t idx = 0;
+        for (; idx + P::width <= size; idx += P::width) {
+            simd::store(dst + idx, simd::load(src + idx));
+        }
+        if (const auto rest = size - idx; rest != 0) {
+            simd::store_partial(dst + idx, simd::load_partial(src + idx, rest), rest);
+        }
+    } else {
+        for (std::size_t idx = 0; idx < size; ++idx) {
+            dst[idx] = static_cast<U>(src[idx]);
+        }
+    }
+}
+
+template <typename T>
+void fill(T* dst, const std::size_t size, const T val) {
+    if constexpr (simd::supported<T>) {
+        using P = simd::pack<T>;
+        const P pack = val;
+        std::size_t idx = 0;
+        for (; idx + P::width <= size; idx += P::width) {
+            pack.store(dst + idx);
+        }
+        if (const auto rest = size - idx; rest != 0) {
+            simd::store_partial(dst + idx, pack, rest);
+        }
+    } else {
+        std::fill(dst, dst + size, val);
+    }
+}
+
+// Maps every byte to eight bytes holding its bits in memory order, one per byte.
+inline constexpr auto bytes_of_bits = [] {
+    std::array<std::uint64_t, 256> result{};
+    for (std::size_t val = 0; val < result.size(); ++val) {
+        for (std::size_t bit = 0; bit < 8; ++bit) {
+            const auto byte = std::endian::native == std::endian::little ? bit : 7 - bit;
+            result[val] |= static_cast<std::uint64_t>((val >> bit) & 1U) << (8 * byte);
+        }
+    }
+    return result;
+}();
+
+/**
+ * @brief Writes the lowest `count` bits to `dst`, bit `i` to element `i`.
+ */
+template <typename T>
+void spread(T* dst, const unsigned bits, const std::size_t count) {
+    std::size_t idx = 0;
+    if constexpr (sizeof(T) == 1) {
+        for (; idx + 8 <= count; idx += 8) {
+            const auto word = bytes_of_bits[(bits >> idx) & 0xFFU];
+            std::memcpy(dst + idx, &word, 8);
+        }
+    }
+    for (; idx < count; ++idx) {
+        dst[idx] = static_cast<T>((bits >> idx) & 1U);
+    }
+}
+
+/**
+ * @brief Expressions reading views, which provide a cursor walking the rows of their layouts.
+ */
+template <typename E>
+concept walkable = requires(const E& expr, const std::size_t idx) { expr.cursor(idx); };
+
+/**
+ * @brief Reads consecutive packs of an expression by index, for expressions without views.
+ */
+template <typename E>
+class index_cursor {
+   private:
+    const E* m_expr;
+    std::size_t m_idx;
+
+   public:
+    constexpr index_cursor(const E& expr, const std::size_t idx) noexcept
+        : m_expr{&expr}, m_idx{idx} {}
+
+    template <typename V>
+    [[nodiscard]] auto load(const std::size_t count) const {
+        return m_expr->template load<V>(m_idx, count);
+    }
+
+    constexpr void advance(const std::size_t count) noexcept {
+        m_idx += count;
+    }
+};
+
+/**
+ * @brief Returns a cursor reading consecutive packs of the expression from the element on, via
+ * `load<V>(count)` and `advance(count)`. Views locate their first element once and then step
+ * along their rows, rather than locating every pack from its index.
+ */
+template <typename E>
+[[nodiscard]] constexpr auto cursor(const E& expr, const std::size_t idx) {
+    if constexpr (walkable<E>) {
+        return expr.cursor(idx);
+    } else {
+        return index_cursor<E>(expr, idx);
+    }
+}
+
+/**
+ * @brief Evaluates the elements [first, first + size) of the expression into `dst`.
+ */
+template <typename T, typename E>
+constexpr void evaluate(T* dst, const E& expr, const std::size_t first, const std::size_t size) {
+    if constexpr (requires { E::is_predicate; }) {
+        // Comparisons of packs yield masks, whose bits are spread into one element per lane.
+        if constexpr (E::vectorizable_mask) {
+            if (!std::is_constant_evaluated()) {
+                using U = typename E::operand_type;
+                constexpr auto width = simd::pack<U>::width;
+                std::size_t idx = 0;
+                for (; idx + width <= size; idx += width) {
+                    spread(dst + idx, simd::bits(expr.template load_mask<U>(first + idx, width)),
+                           width);
+                }
+                if (const auto rest = size - idx; rest != 0) {
+                    spread(dst + idx, simd::bits(expr.template load_mask<U>(first + idx, rest)),
+                           rest);
+                }
+                return;
+            }
+        }
+    } else if constexpr (simd::loadable<T> && E::template vectorizable<simd::lane_t<T> >) {
+        if (!std::is_constant_evaluated()) {
+            using U = simd::lane_t<T>;
+            constexpr auto width = simd::pack<U>::width;
+            std::size_t idx = 0;
+            if constexpr (walkable<E>) {
+                auto from = expr.cursor(first);
+                for (; idx + width <= size; idx += width, from.advance(width)) {
+                    simd::store(dst + idx, from.template load<U>(width));
+                }
+                if (const auto rest = size - idx; rest != 0) {
+                    simd::store_partial(dst + idx, from.template load<U>(rest), rest);
+                }
+                return;
+            }
+            for (; idx + width <= size; idx += width) {
+                simd::store(dst + idx, expr.template load<U>(first + idx, width));
+            }
+            if (const auto rest = size - idx; rest != 0) {
+                simd::store_partial(dst + idx, expr.template load<U>(first + idx, rest), rest);
+            }
+            return;
+        }
+    }
+    for (std::size_t idx = 0; idx < size; ++idx) {
+        dst[idx] = static_cast<T>(expr[first + idx]);
+    }
+}
+
+/**
+ * @brief Combines `dst` with the elements [first, first + size) of the expression.
+ */
+template <typename T, typename E, typename Op>
+constexpr void update(T* dst, const E& expr, const std::size_t first, const std::size_t size,
+                      const Op operation) {
+    using U = simd::lane_t<T>;
+    if constexpr (vectorizable<Op, T> && E::template vectorizable<U>) {
+        if (!std::is_constant_evaluated()) {
+            using P = simd::pack<U>;
+            std::size_t idx = 0;
+            if constexpr (walkable<E>) {
+                auto from = expr.cursor(first);
+                for (; idx + P::width <= size; idx += P::width, from.advance(P::width)) {
+                    simd::store(dst + idx,
+                                operation(simd::load(dst + idx), from.template load<U>(P::width)));
+                }
+                if (const auto rest = size - idx; rest != 0) {
+                    const auto result = operation(simd::load_partial(dst + idx, rest),
+                                                  from.template load<U>(rest));
+                    simd::store_partial(dst + idx, result, rest);
+                }
+                return;
+            }
+            for (; idx + P::width <= size; idx += P::width) {
+                simd::store(dst + idx, operation(simd::load(dst + idx),
+                                                 expr.template load<U>(first + idx, P::width)));
+            }
+            if (const auto rest = size - idx; rest != 0) {
+                const auto result = operation(simd::load_partial(dst + idx, rest),
+                                              expr.template load<U>(first + idx, rest));
+                simd::store_partial(dst + idx, result, rest);
+            }
+            return;
+        }
+    }
+    for (std::size_t idx = 0; idx < size; ++idx) {
+        dst[idx] = static_cast<T>(operation(dst[idx], expr[first + idx]));
+    }
+}
+
+// Side of the square tiles strided copies are transposed in, small enough to stay in L1.
+inline constexpr std::size_t tile = 32;
+
+/**
+ * @brief Copies the strips [begin, end) of `tile` indices along the axis, each transposed tile by
+ * tile with the innermost axis.
+ */
+template <typename T, std::size_t Order>
+void copy_tiles(T* dst, const T* src, const std::array<std::size_t, Order>& extents,
+                const std::array<std::size_t, Order>& strides, const std::size_t axis,
+                const std::size_t begin, const std::size_t end) {
+    constexpr auto inner = Order - 1;
+    std::array<std::size_t, Order> dst_strides{};
+    for (std::size_t dim = Order, stride = 1; dim-- > 0;) {
+        dst_strides[dim] = stride;
+        stride *= extents[dim];
+    }
+    const auto strips = (extents[axis] + tile - 1) / tile;
+    for (auto strip = begin; strip < end; ++strip) {
+        const auto first = strip % strips * tile;
+        const auto last = std::min(first + tile, extents[axis]);
+        auto src_offset = first * strides[axis];
+        auto dst_offset = first * dst_strides[axis];
+        for (std::size_t dim = inner, rest = strip / strips; dim-- > 0;) {
+            if (dim != axis) {
+                const auto idx = rest % extents[dim];
+                rest /= extents[dim];
+                src_offset += idx * strides[dim];
+                dst_offset += idx * dst_strides[dim];
+            }
+        }
+        for (std::size_t col = 0; col < extents[inner]; col += tile) {
+            const auto cols = std::min(col + tile, extents[inner]);
+            for (auto row = first; row < last; ++row) {
+                auto* out = dst + dst_offset + (row - first) * dst_strides[axis];
+                const auto* in = src + src_offset + (row - first) * strides[axis];
+                for (auto idx = col; idx < cols; ++idx) {
+                    out[idx] = in[idx * strides[inner]];
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief Invokes the callable on every row of the layout, see `layout::for_each_row`, splitting the
+ * rows across threads for at least `parallel::threshold()` elements.
+ */
+template <std::size_t Order, typename F>
+constexpr void for_each_row(const layout<Order>& to, F func) {
+    if (to.size() == 0) {
+        return;
+    }
+    const auto rows = to.size() / to.length();
+    if (std::is_constant_evaluated()) {
+        to.for_each_row(0, rows, func);
+        return;
+    }
+    const auto tasks =
+        to.size() < parallel::threshold() ? 1 : std::min(rows, 4 * parallel::threads());
+    parallel::for_each_index(tasks, [&](const std::size_t task) {
+        to.for_each_row(rows * task / tasks, rows * (task + 1) / tasks, func);
+    });
+}
+
+}  // namespace detail
+
+/**
+ * @brief Returns a per-thread scratch buffer of at least the provided size.
+ */
+template <typename T>
+[[nodiscard]] T* scratch(const std::size_t size) {
+    thread_local std::vector<T> buffer;
+    if (buffer.size() < size) {
+        buffer.resize(size);
+    }
+    return buffer.data();
+}
+
+/**
+ * @brief Applies the unary operation to every element of `src`, writing the results to `dst`.
+ * @param dst Destination buffer, which may be the same as `src`.
+ * @param src Source buffer.
+ * @param size Number of elements.
+ * @param operation Element-wise operation.
+ */
+template <typename T, typename Op>
+constexpr void transform(T* dst, const T* src, const std::size_t size, const Op operation) {
+    if (std::is_constant_evaluated()) {
+        detail::transform(dst, src, size, operation);
+        return;
+    }
+    parallel::for_each(size, [=](const std::size_t begin, const std::size_t end) {
+        detail::transform(dst + begin, src + begin, end - begin, operation);
+    });
+}
+
+/**
+ * @brief Applies the binary operation to every pair of elements of `lhs` and `rhs`, writing the
+ * results to `dst`.
+ * @param dst Destination buffer, which may be the same as `lhs` or `rhs`.
+ * @param lhs Left-hand side buffer.
+ * @param rhs Right-hand side buffer.
+ * @param size Number of elements.
+ * @param operation Element-wise operation.
+ */
+template <typename T, typename Op>
+constexpr void transform(T* dst, const T* lhs, const T* rhs, const std::size_t size,
+                         const Op operation) {
+    if (std::is_constant_evaluated()) {
+        detail::transform(dst, lhs, rhs, size, operation);
+        return;
+    }
+    parallel::for_each(size, [=](const std::size_t begin, const std::size_t end) {
+        detail::transform(dst + begin, lhs + begin, rhs + begin, end - begin, operation);
+    });
+}
+
+/**
+ * @brief Applies the binary operation to every element of `lhs` and the scalar, writing the results
+ * to `dst`. Scalars of a different floating-point type are not vectorized, as the scalar loop
+ * computes in the wider type.
+ * @param dst Destination buffer, which may be the same as `lhs`.
+ * @param lhs Left-hand side buffer.
+ * @param rhs Scalar right-hand side.
+ * @param size Number of elements.
+ * @param operation Element-wise operation.
+ */
+template <typename T, typename S, typename Op>
+    requires(std::is_arithmetic_v<S> || is_half_v<S>)
+constexpr void transform(T* dst, const T* lhs, const S rhs, const std::size_t size,
+                         const Op operation) {
+    if (std::is_constant_evaluated()) {
+        detail::transform(dst, lhs, rhs, size, operation);
+        return;
+    }
+    parallel::for_each(size, [=](const std::size_t begin, const std::size_t end) {
+        detail::transform(dst + begin, lhs + begin, rhs, end - begin, operation);
+    });
+}
+
+/**
+ * @brief Evaluates the expression into `dst` in a single pass.
+ * @param dst Destination buffer.
+ * @param expr Lazily evaluated expression.
+ * @param size Number of elements.
+ */
+template <typename T, typename E>
+constexpr void evaluate(T* dst, const E& expr, const std::size_t size) {
+    if (std::is_constant_evaluated()) {
+        detail::evaluate(dst, expr, 0, size);
+        return;
+    }
+    parallel::for_each(size, [&](const std::size_t begin, const std::size_t end) {
+        detail::evaluate(dst + begin, expr, begin, end - begin);
+    });
+}
+
+/**
+ * @brief Combines every element of `dst` with the corresponding value of the expression in a single
+ * pass, writing the results back to `dst`.
+ * @param dst Destination buffer, which the expression may only read at the index being written.
+ * @param expr Lazily evaluated expression.
+ * @param size Number of elements.
+ * @param operation Element-wise operation.
+ */
+template <typename T, typename E, typename Op>
+constexpr void update(T* dst, const E& expr, const std::size_t size, const Op operation) {
+    if (std::is_constant_evaluated()) {
+        detail::update(dst, expr, 0, size, operation);
+        return;
+    }
+    parallel::for_each(size, [&](const std::size_t begin, const std::size_t end) {
+        detail::update(dst + begin, expr, begin, end - begin, operation);
+    });
+}
+
+/**
+ * @brief Converts every element of `src` to the element type of `dst`. Conversions between `float`
+ * and the 16-bit floating-point types go through SIMD packs.
+ * @param dst Destination buffer.
+ * @param src Source buffer.
+ * @param size Number of elements.
+ */
+template <typename T, typename U>
+constexpr void convert(U* dst, const T* src, const std::size_t size) {
+    if (std::is_constant_evaluated()) {
+        for (std::size_t idx = 0; idx < size; ++idx) {
+            dst[idx] = static_cast<U>(src[idx]);
+        }
+        return;
+    }
+    parallel::for_each(size, [=](const std::size_t begin, const std::size_t end) {
+        detail::convert(dst + begin, src + begin, end - begin);
+    });
+}
+
+/**
+ * @brief Sets every element of `dst` to the value.
+ * @param dst Destination buffer.
+ * @param size Number of elements.
+ * @param val Value to assign.
+ */
+template <typename T>
+constexpr void fill(T* dst, const std::size_t size, const T val) {
+    if (std::is_constant_evaluated()) {
+        std::fill_n(dst, size, val);
+        return;
+    }
+    parallel::for_each(size, [=](const std::size_t begin, const std::size_t end) {
+        detail::fill(dst + begin, end - begin, val);
+    });
+}
+
+/**
+ * @brief Evaluates the expression into strided elements in a single pass, row by row along the
+ * innermost axis of the layout. Rows of unit stride go through SIMD packs as contiguous buffers do.
+ * @param dst Pointer to the first element.
+ * @param to Layout of the elements.
+ * @param expr Lazily evaluated expression of as many elements.
+ */
+template <typename T, std::size_t Order, typename E>
+constexpr void evaluate(T* dst, const layout<Order>& to, const E& expr) {
+    if (to.is_contiguous()) {
+        evaluate(dst, expr, to.size());
+        return;
+    }
+    const auto length = to.length();
+    const auto stride = to.stride();
+    detail::for_each_row(to, [&](const std::size_t idx, const std::size_t offset) {
+        if (stride == 1) {
+            detail::evaluate(dst + offset, expr, idx, length);
+            return;
+        }
+        for (std::size_t col = 0; col < length; ++col) {
+            dst[offset + col * stride] = static_cast<T>(expr[idx + col]);
+        }
+    });
+}
+
+/**
+ * @brief Combines every strided element with the corresponding value of the expression in a
+ * single pass, row by row along the innermost axis of the layout.
+ * @param dst Pointer to the first element, which the expression may only read at the element being
+ * written.
+ * @param to Layout of the elements.
+ * @param expr Lazily evaluated expression of as many elements.
+ * @param operation Element-wise operation.
+ */
+template <typename T, std::size_t Order, typename E, typename Op>
+constexpr void update(T* dst, const layout<Order>& to, const E& expr, const Op operation) {
+    if (to.is_contiguous()) {
+        update(dst, expr, to.size(), operation);
+        return;
+    }
+    const auto length = to.length();
+    const auto stride = to.stride();
+    detail::for_each_row(to, [&](const std::size_t idx, const std::size_t offset) {
+        if (stride == 1) {
+            detail::update(dst + offset, expr, idx, length, operation);
+            return;
+        }
+        for (std::size_t col = 0; col < length; ++col) {
+            auto& element = dst[offset + col * stride];
+            element = static_cast<T>(operation(element, expr[idx + col]));
+        }
+    });
+}
+
+/**
+ * @brief Sets every strided element to the value, row by row along the innermost axis of the
+ * layout.
+ * @param dst Pointer to the first element.
+ * @param to Layout of the elements.
+ * @param val Value to assign.
+ */
+template <typename T, std::size_t Order>
+constexpr void fill(T* dst, const layout<Order>& to, const T val) {
+    if (to.is_contiguous()) {
+        fill(dst, to.size(), val);
+        return;
+    }
+    const auto length = to.length();
+    const auto stride = to.stride();
+    detail::for_each_row(to, [&](const std::size_t, const std::size_t offset) {
+        if (stride == 1 && !std::is_constant_evaluated()) {
+            detail::fill(dst + offset, length, val);
+            return;
+        }
+        for (std::size_t col = 0; col < length; ++col) {
+            dst[offset + col * stride] = val;
+        }
+    });
+}
+
+/**
+ * @brief Combines every strided element with the value in place, row by row along the innermost
+ * axis of the layout.
+ * @param dst Pointer to the first element.
+ * @param to Layout of the elements.
+ * @param val Right-hand side of the operation.
+ * @param operation Element-wise operation.
+ */
+template <typename T, std::size_t Order, typename S, typename Op>
+    requires(std::is_arithmetic_v<S> || is_half_v<S>)
+constexpr void transform(T* dst, const layout<Order>& to, const S val, const Op operation) {
+    if (to.is_contiguous()) {
+        transform(dst, dst, val, to.size(), operation);
+        return;
+    }
+    const auto length = to.length();
+    const auto stride = to.stride();
+    detail::for_each_row(to, [&](const std::size_t, const std::size_t offset) {
+        if (stride == 1) {
+            detail::transform(dst + offset, dst + offset, val, length, operation);
+            return;
+        }
+        for (std::size_t col = 0; col < length; ++col) {
+            auto& element = dst[offset + col * stride];
+            element = static_cast<T>(operation(element, val));
+        }
+    });
+}
+
+/**
+ * @brief Copies strided elements into `dst` in row-major order. Rows are copied as they are if
+ * the innermost axis has the smallest stride. Otherwise the elements are transposed in square
+ * tiles, read along the axis of smallest stride and written along the innermost one, so that
+ * neither side strides through memory more than a tile apart.
+ * @param dst Destination buffer of as many elements as the extents describe.
+ * @param src Pointer to the first element.
+ * @param extents Extents of the elements.
+ * @param strides Distance between consecutive elements along every axis.
+ */
+template <typename T, std::size_t Order>
+constexpr void copy(T* dst, const T* src, const std::array<std::size_t, Order>& extents,
+                    const std::array<std::size_t, Order>& strides) {
+    const layout<Order> from(extents, strides);
+    if (from.is_contiguous()) {
+        std::copy(src, src + from.size(), dst);
+        return;
+    }
+    if constexpr (Order > 0) {
+        constexpr auto inner = Order - 1;
+        const auto& collapsed = from.extents();
+        const auto& steps = from.strides();
+        const auto stride = from.stride();
+        const auto copy_rows = [&](const std::size_t first, const std::size_t last) {
+            from.for_each_row(first, last, [&](const std::size_t idx, const std::size_t offset) {
+                for (std::size_t col = 0; col < from.length(); ++col) {
+                    dst[idx + col] = src[offset + col * stride];
+                }
+            });
+        };
+        if (from.size() == 0) {
+            return;
+        }
+        if (std::is_constant_evaluated()) {
+            copy_rows(0, from.size() / from.length());
+            return;
+        }
+
+        auto axis = inner;
+        for (auto dim = Order - from.dims(); dim < inner; ++dim) {
+            if (steps[dim] < steps[axis]) {
+                axis = dim;
+            }
+        }
+        const auto units = axis == inner
+                               ? from.size() / from.length()
+                               : from.size() / collapsed[axis] / from.length() *
+                                     ((collapsed[axis] + detail::tile - 1) / detail::tile);
+        const auto tasks =
+            from.size() < parallel::threshold() ? 1 : std::min(units, 4 * parallel::threads());
+        parallel::for_each_index(tasks, [&](const std::size_t task) {
+            const auto begin = units * task / tasks;
+            const auto end = units * (task + 1) / tasks;
+            if (axis == inner) {
+                copy_rows(begin, end);
+            } else {
+                detail::copy_tiles(dst, src, collapsed, steps, axis, begin, end);
+            }
+        });
+    }
+}
+
+/**
+ * @brief Returns whether the predicate holds for every pair of elements of `lhs` and `rhs`,
+ * stopping at the first pair for which it does not. Predicates from `op` compare whole SIMD packs
+ * at a time.
+ * @param lhs Left-hand side buffer.
+ * @param rhs Right-hand side buffer.
+ * @param size Number of elements.
+ * @param pred Element-wise predicate.
+ * @return True if the predicate holds for all pairs.
+ */
+template <typename T, typename Pred>
+[[nodiscard]] constexpr bool all_of(const T* lhs, const T* rhs, const std::size_t size,
+                                    const Pred pred) {
+    const auto check = [=](const std::size_t begin, const std::size_t end) {
+        std::size_t idx = begin;
+        if constexpr (vectorizable<Pred, T>) {
+            if (!std::is_constant_evaluated()) {
+                using P = simd::pack<simd::lane_t<T> >;
+                for (; idx + P::width <= end; idx += P::width) {
+                    if (!simd::all(pred(simd::load(lhs + idx), simd::load(rhs + idx)))) {
+                        return false;
+                    }
+                }
+                if (const auto rest = end - idx; rest != 0) {
+                    const auto lanes = (1U << rest) - 1;
+                    const auto hits = simd::bits(pred(simd::load_partial(lhs + idx, rest),
+                                                      simd::load_partial(rhs + idx, rest)));
+                    return (hits & lanes) == lanes;
+                }
+                return true;
+            }
+        }
+        for (; idx < end; ++idx) {
+            if (!pred(lhs[idx], rhs[idx])) {
+                return false;
+            }
+        }
+        return true;
+    };
+    if (std::is_constant_evaluated()) {
+        return check(0, size);
+    }
+    return parallel::for_each_until(size, check);
+}
+
+}  // namespace kernel
+
+}  // namespace core
+
+#endif  // KERNEL_HPP
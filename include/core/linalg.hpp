@@ -0,0 +1,341 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2022 David Oniani
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef LINALG_HPP
+#define LINALG_HPP
+
+#include <algorithm>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "view.hpp"
+
+namespace core {
+
+namespace detail {
+
+/**
+ * @brief Blocking parameters of the matrix multiplication. The micro-kernel keeps an `mr` by `nr`
+ * block of the result in registers, a `kc` by `nr` panel of B stays in L1 and an `mc` by `kc`
+ * block of A in L2 while a `kc` by `nc` block of B is reused from L3.
+ */
+template <typename T>
+struct gemm_blocking {
+    static constexpr size_type nr = [] {
+        if constexpr (simd::supported<T>) {
+            return 2 * simd::pack<T>::width;
+        } else {
+            return size_type{8};
+        }
+    }();
+    static constexpr size_type mr = simd::supported<T> ? 6 : 4;
+    static constexpr size_type kc = 256;
+    static constexpr size_type mc = 120;
+    static constexpr size_type nc = 128 * nr;
+
+    // Width of the columns of a block of B handled by one task when splitting across threads.
+    static constexpr size_type jc = 16 * nr;
+};
+
+/**
+ * @brief Refers to a strided matrix, e.g. a row-major tensor or a transposed view.
+ */
+template <typename T>
+struct matrix_ref {
+    const T* data;
+    size_type rows;
+    size_type cols;
+    size_type row_stride;
+    size_type col_stride;
+
+    [[nodiscard]] constexpr T operator()(const size_type row, const size_type col) const noexcept {
+        return data[row * row_stride + col * col_stride];
+    }
+};
+
+/**
+ * @brief Copies an `mc` by `kc` block of A into panels of `mr` rows stored column by column,
+ * padding the last panel with zeros. Elements are converted to the type computed in.
+ */
+template <typename T, typename S>
+void pack_a(const matrix_ref<S>& a, const size_type row, const size_type mc, const size_type col,
+            const size_type kc, T* dst) {
+    constexpr auto mr = gemm_blocking<T>::mr;
+    for (size_type ir = 0; ir < mc; ir += mr) {
+        const auto rows = std::min(mr, mc - ir);
+        for (size_type p = 0; p < kc; ++p) {
+            for (size_type i = 0; i < mr; ++i) {
+                *dst++ = i < rows ? static_cast<T>(a(row + ir + i, col + p)) : T{0};
+            }
+        }
+    }
+}
+
+/**
+ * @brief Copies a `kc` by `nc` block of B into panels of `nr` columns stored row by row, padding
+ * the last panel with zeros. Elements are converted to the type computed in.
+ */
+template <typename T, typename S>
+void pack_b(const matrix_ref<S>& b, const size_type row, const size_type kc, const size_type col,
+            const size_type nc, T* dst) {
+    constexpr auto nr = gemm_blocking<T>::nr;
+    for (size_type jr = 0; jr < nc; jr += nr) {
+        const auto cols = std::min(nr, nc - jr);
+        for (size_type p = 0; p < kc; ++p) {
+            for (size_type j = 0; j < nr; ++j) {
+                *dst++ = j < cols ? static_cast<T>(b(row + p, col + jr + j)) : T{0};
+            }
+        }
+    }
+}
+
+/**
+ * @brief Accumulates the product of a packed panel of A and a packed panel of B into the `rows` by
+ * `cols` block of C starting at `c`.
+ */
+template <typename T>
+void micro_kernel(const size_type kc, const T* a, const T* b, T* c, const size_type ldc,
+                  const size_type rows, const size_type cols) {
+    constexpr auto mr = gemm_blocking<T>::mr;
+    constexpr auto nr = gemm_blocking<T>::nr;
+    if constexpr (simd::supported<T>) {
+        using P = simd::pack<T>;
+        constexpr auto nv = nr / P::width;
+        P acc[mr][nv];
+        for (size_type i = 0; i < mr; ++i) {
+            for (size_type v = 0; v < nv; ++v) {
+                acc[i][v] = P(T{0});
+            }
+        }
+        for (size_type p = 0; p < kc; ++p, a += mr, b += nr) {
+            P row[nv];
+            for (size_type v = 0; v < nv; ++v) {
+                row[v] = P::load(b + v * P::width);
+            }
+            for (size_type i = 0; i < mr; ++i) {
+                const P val(a[i]);
+                for (size_type v = 0; v < nv; ++v) {
+                    acc[i][v] = simd::fma(val, row[v], acc[i][v]);
+                }
+            }
+        }
+        if (rows == mr && cols == nr) {
+            for (size_type i = 0; i < mr; ++i) {
+                for (size_type v = 0; v < nv; ++v) {
+                    auto* dst = c + i * ldc + v * P::width;
+                    (P::load(dst) + acc[i][v]).store(dst);
+                }
+            }
+            return;
+        }
+        T buf[mr * nr];
+        for (size_type i = 0; i < mr; ++i) {
+            for (size_type v = 0; v < nv; ++v) {
+                acc[i][v].store(buf + i * nr + v * P::width);
+            }
+        }
+        for (size_type i = 0; i < rows; ++i) {
+            for (size_type j = 0; j < cols; ++j) {
+                c[i * ldc + j] += buf[i * nr + j];
+            }
+        }
+    } else {
+        T acc[mr][nr]{};
+        for (size_type p = 0; p < kc; ++p, a += mr, b += nr) {
+            for (size_type i = 0; i < mr; ++i) {
+                for (size_type j = 0; j < nr; ++j) {
+                    acc[i][j] += a[i] * b[j];
+                }
+            }
+        }
+        for (size_type i = 0; i < rows; ++i) {
+            for (size_type j = 0; j < cols; ++j) {
+                c[i * ldc + j] += acc[i][j];
+            }
+        }
+    }
+}
+
+/**
+ * @brief Accumulates the product of A and B into the row-major matrix C, which has to hold
+ * `a.rows` by `b.cols` elements. Every `mc` by `kc` block of A is packed once and reused for all
+ * the blocks of B it multiplies. Blocks of C are split across threads once C holds at least
+ * `parallel::threshold()` elements. The 16-bit floating-point types are widened while packing, so
+ * that C accumulates in single precision.
+ */
+template <typename S>
+void gemm(const matrix_ref<S>& a, const matrix_ref<S>& b, compute_t<S>* c) {
+    using T = compute_t<S>;
+    using blocking = gemm_blocking<T>;
+    const auto m = a.rows;
+    const auto n = b.cols;
+    const auto k = a.cols;
+    const auto row_blocks = (m + blocking::mc - 1) / blocking::mc;
+    const auto run = [&](const size_type count, const auto& task) {
+        if (m * n < parallel::threshold()) {
+            for (size_type idx = 0; idx < count; ++idx) {
+                task(idx);
+            }
+        } else {
+            parallel::for_each_index(count, task);
+        }
+    };
+    std::vector<T> packed_a;
+    std::vector<T> packed_b;
+
+    for (size_type pc = 0; pc < k; pc += blocking::kc) {
+        const auto kc = std::min(blocking::kc, k - pc);
+        const auto block_a = (blocking::mc + blocking::mr - 1) / blocking::mr * blocking::mr * kc;
+        packed_a.resize(row_blocks * block_a);
+        run(row_blocks, [&](const size_type idx) {
+            const auto ic = idx * blocking::mc;
+            pack_a(a, ic, std::min(blocking::mc, m - ic), pc, kc, packed_a.data() + idx * block_a);
+        });
+
+        for (size_type jc = 0; jc < n; jc += blocking::nc) {
+            const auto nc = std::min(blocking::nc, n - jc);
+            const auto col_blocks = (nc + blocking::jc - 1) / blocking::jc;
+            packed_b.resize((nc + blocking::nr - 1) / blocking::nr * blocking::nr * kc);
+            pack_b(b, pc, kc, jc, nc, packed_b.data());
+
+            run(row_blocks * col_blocks, [&](const size_type idx) {
+                const auto ic = idx / col_blocks * blocking::mc;
+                const auto mc = std::min(blocking::mc, m - ic);
+                const auto first = idx % col_blocks * blocking::jc;
+                const auto last = std::min(first + blocking::jc, nc);
+                const auto* block = packed_a.data() + idx / col_blocks * block_a;
+                for (size_type jr = first; jr < last; jr += blocking::nr) {
+                    for (size_type ir = 0; ir < mc; ir += blocking::mr) {
+                        micro_kernel(kc, block + ir * kc, packed_b.data() + jr * kc,
+                                     c + (ic + ir) * n + jc + jr, n,
+                                     std::min(blocking::mr, mc - ir),
+                                     std::min(blocking::nr, nc - jr));
+                    }
+                }
+            });
+        }
+    }
+}
+
+template <typename X>
+struct view_of;
+
+template <arithmetic T, size_type Order>
+struct view_of<tensor<T, Order> > {
+    using type = tensor_view<const T, Order>;
+};
+
+template <typename T, size_type Order>
+struct view_of<tensor_view<T, Order> > {
+    using type = tensor_view<const std::remove_const_t<T>, Order>;
+};
+
+/**
+ * @brief Tensors and views of order two or three that can be multiplied.
+ */
+template <typename X>
+concept matrix_operand = requires { typename view_of<X>::type; } &&
+                         (view_of<X>::type::order == 2 || view_of<X>::type::order == 3);
+
+/**
+ * @brief Returns a read-only view of a tensor or a view.
+ */
+template <typename X>
+[[nodiscard]] constexpr typename view_of<X>::type as_view(const X& x) noexcept {
+    if constexpr (is_tensor<X>::value) {
+        return x.view();
+    } else {
+        return x;
+    }
+}
+
+template <typename T>
+[[nodiscard]] constexpr matrix_ref<T> as_matrix(const tensor_view<const T, 2>& v) noexcept {
+    return {v.data(), v.extents()[0], v.extents()[1], v.strides()[0], v.strides()[1]};
+}
+
+/**
+ * @brief Rounds a result accumulated in single precision to the 16-bit floating-point type `S`,
+ * and passes results of other types through.
+ */
+template <typename S, typename T, size_type Order>
+[[nodiscard]] auto to_storage(tensor<T, Order>&& t) {
+    if constexpr (std::is_same_v<S, T>) {
+        return std::move(t).take();
+    } else {
+        auto result = tensor<S, Order>(t.extents());
+        kernel::convert(result.data(), t.data(), t.size());
+        return std::move(result).take();
+    }
+}
+
+}  // namespace detail
+
+/**
+ * @brief Multiplies two matrices, or two batches of matrices of the same length when both operands
+ * are of order three. Operands may be tensors or views of arbitrary strides, e.g. transposed views,
+ * which are read in place rather than copied. Products of the 16-bit floating-point types are
+ * accumulated in single precision and rounded once.
+ * @param lhs Left-hand side of extents {m, k}, or {batch, m, k}.
+ * @param rhs Right-hand side of extents {k, n}, or {batch, k, n}.
+ * @return A tensor of extents {m, n}, or {batch, m, n}.
+ */
+template <detail::matrix_operand L, detail::matrix_operand R>
+    requires std::is_same_v<typename detail::view_of<L>::type, typename detail::view_of<R>::type>
+[[nodiscard]] auto matmul(const L& lhs, const R& rhs) {
+    using S = typename detail::view_of<L>::type::value_type;
+    using T = compute_t<S>;
+    constexpr auto Order = detail::view_of<L>::type::order;
+    const auto a = detail::as_view(lhs);
+    const auto b = detail::as_view(rhs);
+    const auto ae = a.extents();
+    const auto be = b.extents();
+
+    if constexpr (Order == 2) {
+        if (ae[1] != be[0]) {
+            throw std::runtime_error("Tensor dimension mismatch.");
+        }
+        auto result = tensor<T, 2>(array<2>{ae[0], be[1]});
+        kernel::fill(result.data(), result.size(), T{0});
+        detail::gemm(detail::as_matrix(a), detail::as_matrix(b), result.data());
+        return detail::to_storage<S>(std::move(result));
+    } else {
+        if (ae[0] != be[0] || ae[2] != be[1]) {
+            throw std::runtime_error("Tensor dimension mismatch.");
+        }
+        auto result = tensor<T, 3>(array<3>{ae[0], ae[1], be[2]});
+        kernel::fill(result.data(), result.size(), T{0});
+        for (size_type batch = 0; batch < ae[0]; ++batch) {
+            const auto lhs_batch = detail::as_matrix(a.template get<1>({batch}));
+            const auto rhs_batch = detail::as_matrix(b.template get<1>({batch}));
+            detail::gemm(lhs_batch, rhs_batch, result.data() + batch * ae[1] * be[2]);
+        }
+        return detail::to_storage<S>(std::move(result));
+    }
+}
+
+}  // namespace core
+
+#endif  // LINALG_HPP
@@ -0,0 +1,407 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2022 David Oniani
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef MEMORY_HPP
+#define MEMORY_HPP
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstring>
+#include <memory_resource>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+#if __has_include(<sys/mman.h>)
+#include <sys/mman.h>
+#define TENSOR_HAS_MMAP 1
+#else
+#define TENSOR_HAS_MMAP 0
+#endif
+
+#include "instrument.hpp"
+
+/**
+ * @brief Storage of tensors. Every tensor allocates its buffer from a `std::pmr::memory_resource`,
+ * aligned to `alignment` bytes, which is the one passed to its constructor or else the default
+ * resource at the time of construction. The buffer is returned to the same resource.
+ */
+namespace memory {
+
+/**
+ * @brief Alignment of every tensor buffer, covering a full AVX-512 register and a cache line.
+ */
+inline constexpr std::size_t alignment = 64;
+
+/**
+ * @brief Returns the resource allocating directly via aligned `operator new`.
+ */
+[[nodiscard]] inline std::pmr::memory_resource* aligned_resource() noexcept {
+    return std::pmr::new_delete_resource();
+}
+
+namespace detail {
+
+inline std::atomic<std::pmr::memory_resource*> resource{nullptr};
+
+// Innermost arena opened on the calling thread, see `tensor_arena`.
+inline thread_local std::pmr::memory_resource* scope{nullptr};
+
+}  // namespace detail
+
+/**
+ * @brief Returns the resource used by tensors constructed without one, i.e. the innermost
+ * `tensor_arena` open on the calling thread, or else `aligned_resource()` unless changed via
+ * `set_default_resource`.
+ */
+[[nodiscard]] inline std::pmr::memory_resource* default_resource() noexcept {
+    if (detail::scope != nullptr) {
+        return detail::scope;
+    }
+    auto* result = detail::resource.load(std::memory_order_acquire);
+    return result != nullptr ? result : aligned_resource();
+}
+
+/**
+ * @brief Sets the resource used by tensors constructed without one, on threads without an open
+ * `tensor_arena`. The resource has to outlive every tensor allocated from it.
+ * @param resource Resource to use, `nullptr` restores `aligned_resource()`.
+ * @return The previous default resource.
+ */
+inline std::pmr::memory_resource* set_default_resource(
+    std::pmr::memory_resource* const resource) noexcept {
+    auto* previous = detail::resource.exchange(resource, std::memory_order_acq_rel);
+    return previous != nullptr ? previous : aligned_resource();
+}
+
+/**
+ * @brief A scope within which tensors constructed on the calling thread bump-allocate from a region
+ * reserved up front instead of the default resource. Freeing is a no-op and the region is returned
+ * as a whole once the scope ends, so temporaries cost neither locks nor bookkeeping. Requests
+ * beyond the region take further regions from the resource that was the default when the scope
+ * opened, so that nested arenas carve their regions out of the enclosing one.
+ *
+ * Tensors allocated within the scope must not outlive it. Moving never takes over a buffer from an
+ * open arena: move assignment copies it into the resource of the tensor assigned to unless both
+ * share the arena, and move construction copies it into the resource that was the default when
+ * the arena opened, so that every move construction within the scope that is not elided copies
+ * the buffer, whereas `tensor::take` hands it over for results staying within the scope. As the
+ * copy may throw, moves of tensors are not `noexcept`, and standard containers copy tensors as they
+ * grow. Copy elision bypasses the copy, hence results are kept by assigning them to tensors
+ * constructed before the scope.
+ *
+ * Arenas serve the thread that opened them and close in reverse order of opening, as scopes do.
+ */
+class tensor_arena final : public std::pmr::memory_resource {
+   private:
+    std::pmr::memory_resource* m_previous;
+    std::pmr::monotonic_buffer_resource m_region;
+    std::size_t m_used{0};
+
+    void* do_allocate(const std::size_t bytes, const std::size_t align) override {
+        auto* result = m_region.allocate(bytes, align);
+        m_used += bytes;
+        return result;
+    }
+
+    void do_deallocate(void* const /* data */, const std::size_t /* bytes */,
+                       const std::size_t /* align */) override {}
+
+    [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+
+   public:
+    /**
+     * @brief Opens the scope, making the arena the default resource of the calling thread.
+     * @param bytes Size of the first region, allocated on first use.
+     */
+    explicit tensor_arena(const std::size_t bytes)
+        : m_previous{detail::scope}, m_region{std::max(bytes, alignment), default_resource()} {
+        detail::scope = this;
+    }
+
+    tensor_arena(const tensor_arena&) = delete;
+    tensor_arena& operator=(const tensor_arena&) = delete;
+
+    /**
+     * @brief Closes the scope, restoring the previous default resource and releasing every region.
+     */
+    ~tensor_arena() override {
+        detail::scope = m_previous;
+    }
+
+    /**
+     * @brief Returns whether the resource is an arena open on the calling thread.
+     */
+    [[nodiscard]] static bool is_open(const std::pmr::memory_resource* const resource) noexcept {
+        for (auto* arena = detail::scope; arena != nullptr;
+             arena = static_cast<const tensor_arena*>(arena)->m_previous) {
+            if (arena == resource) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief Returns the resource that was the default when the arena opened if the resource is an
+     * arena open on the calling thread, otherwise the resource itself.
+     */
+    [[nodiscard]] static std::pmr::memory_resource* upstream(
+        std::pmr::memory_resource* const resource) noexcept {
+        for (auto* arena = detail::scope; arena != nullptr;
+             arena = static_cast<const tensor_arena*>(arena)->m_previous) {
+            if (arena == resource) {
+                return static_cast<const tensor_arena*>(arena)->m_region.upstream_resource();
+            }
+        }
+        return resource;
+    }
+
+    /**
+     * @brief Returns the number of bytes handed out since the scope opened.
+     */
+    [[nodiscard]] std::size_t used() const noexcept {
+        return m_used;
+    }
+};
+
+/**
+ * @brief Allocates storage for `size` elements from the resource. During constant evaluation,
+ * where memory resources are unavailable, `new[]` is used instead and the resource is ignored.
+ * @param size Number of elements.
+ * @param resource Resource to allocate from.
+ * @return Pointer to the storage, `nullptr` for zero elements.
+ */
+template <typename T>
+[[nodiscard]] constexpr T* allocate(const std::size_t size,
+                                    std::pmr::memory_resource* const resource) {
+    if (std::is_constant_evaluated()) {
+        return new T[size];
+    }
+    if (size == 0) {
+        return nullptr;
+    }
+    instrument::allocated(size * sizeof(T));
+    return static_cast<T*>(
+        resource->allocate(size * sizeof(T), std::max(alignment, alignof(T))));
+}
+
+/**
+ * @brief Returns storage obtained from `allocate` to the resource.
+ * @param data Pointer to the storage.
+ * @param size Number of elements it was allocated for.
+ * @param resource Resource it was allocated from.
+ */
+template <typename T>
+constexpr void deallocate(T* const data, const std::size_t size,
+                          std::pmr::memory_resource* const resource) noexcept {
+    if (std::is_constant_evaluated()) {
+        delete[] data;
+        return;
+    }
+    if (data != nullptr) {
+        resource->deallocate(data, size * sizeof(T), std::max(alignment, alignof(T)));
+    }
+}
+
+/**
+ * @brief Returns the default resource, or `nullptr` during constant evaluation.
+ */
+[[nodiscard]] constexpr std::pmr::memory_resource* current_resource() noexcept {
+    if (std::is_constant_evaluated()) {
+        return nullptr;
+    }
+    return default_resource();
+}
+
+/**
+ * @brief A resource handing out zero-filled blocks. Blocks of at least `threshold` bytes are
+ * anonymous memory mappings, whose pages are zero-filled by the kernel on first access, so that
+ * pages never written cost neither time nor memory. Smaller blocks come from `aligned_resource()`
+ * and are cleared. Blocks are only ever returned to the resource they came from, so the size
+ * passed to `deallocate` tells the two kinds apart.
+ */
+class zeroed_resource final : public std::pmr::memory_resource {
+   private:
+    void* do_allocate(const std::size_t bytes, const std::size_t align) override {
+#if TENSOR_HAS_MMAP
+        if (bytes >= threshold) {
+            auto* result =
+                ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (result == MAP_FAILED) {
+                throw std::bad_alloc();
+            }
+            return result;
+        }
+#endif
+        auto* result = aligned_resource()->allocate(bytes, align);
+        std::memset(result, 0, bytes);
+        return result;
+    }
+
+    void do_deallocate(void* const data, const std::size_t bytes,
+                       const std::size_t align) override {
+#if TENSOR_HAS_MMAP
+        if (bytes >= threshold) {
+            ::munmap(data, bytes);
+            return;
+        }
+#endif
+        aligned_resource()->deallocate(data, bytes, align);
+    }
+
+    [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+
+   public:
+    /**
+     * @brief Size in bytes from which blocks are memory mappings, a multiple of the page size.
+     */
+    static constexpr std::size_t threshold = std::size_t{1} << 18;
+
+    /**
+     * @brief Returns the process-wide instance.
+     */
+    [[nodiscard]] static zeroed_resource* instance() noexcept {
+        static zeroed_resource result;
+        return &result;
+    }
+};
+
+/**
+ * @brief A resource recycling freed blocks. Requests are rounded up to a power of two, and freed
+ * blocks are kept in a free list per size until `max_cached` bytes are held, after which they are
+ * returned upstream. This turns the result buffers of operators on tensors of recurring extents
+ * into a free list lookup. Blocks are allocated at `alignment`, so that any cached block serves any
+ * request of its size, while requests for a stricter alignment bypass the free lists. Safe to use
+ * from multiple threads.
+ */
+class buffer_pool final : public std::pmr::memory_resource {
+   private:
+    static constexpr std::size_t buckets = 64;
+
+    std::pmr::memory_resource* m_upstream;
+    std::size_t m_max_cached;
+    std::size_t m_cached{0};
+    std::array<std::vector<void*>, buckets> m_free;
+    mutable std::mutex m_mutex;
+
+    [[nodiscard]] static std::size_t rounded(const std::size_t bytes) noexcept {
+        return std::bit_ceil(std::max(bytes, alignment));
+    }
+
+    void* do_allocate(const std::size_t bytes, const std::size_t align) override {
+        if (align > alignment) {
+            return m_upstream->allocate(bytes, align);
+        }
+        const auto size = rounded(bytes);
+        {
+            std::lock_guard lock(m_mutex);
+            auto& list = m_free[static_cast<std::size_t>(std::countr_zero(size))];
+            if (!list.empty()) {
+                auto* result = list.back();
+                list.pop_back();
+                m_cached -= size;
+                return result;
+            }
+        }
+        return m_upstream->allocate(size, alignment);
+    }
+
+    void do_deallocate(void* const data, const std::size_t bytes,
+                       const std::size_t align) override {
+        if (align > alignment) {
+            m_upstream->deallocate(data, bytes, align);
+            return;
+        }
+        const auto size = rounded(bytes);
+        {
+            std::lock_guard lock(m_mutex);
+            if (m_cached + size <= m_max_cached) {
+                // Growing the free list may fail, in which case the block goes upstream instead.
+                try {
+                    m_free[static_cast<std::size_t>(std::countr_zero(size))].push_back(data);
+                    m_cached += size;
+                    return;
+                } catch (const std::bad_alloc&) {
+                }
+            }
+        }
+        m_upstream->deallocate(data, size, alignment);
+    }
+
+    [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+
+   public:
+    /**
+     * @brief Constructs an empty pool.
+     * @param max_cached Maximum number of bytes held in the free lists.
+     * @param upstream Resource the blocks are allocated from.
+     */
+    explicit buffer_pool(const std::size_t max_cached = std::size_t{1} << 30,
+                         std::pmr::memory_resource* const upstream = aligned_resource()) noexcept
+        : m_upstream{upstream}, m_max_cached{max_cached} {}
+
+    buffer_pool(const buffer_pool&) = delete;
+    buffer_pool& operator=(const buffer_pool&) = delete;
+
+    ~buffer_pool() override {
+        release();
+    }
+
+    /**
+     * @brief Returns every cached block upstream. Blocks in use are unaffected.
+     */
+    void release() noexcept {
+        std::lock_guard lock(m_mutex);
+        for (std::size_t idx = 0; idx < buckets; ++idx) {
+            for (auto* data : m_free[idx]) {
+                m_upstream->deallocate(data, std::size_t{1} << idx, alignment);
+            }
+            m_free[idx].clear();
+        }
+        m_cached = 0;
+    }
+
+    /**
+     * @brief Returns the number of bytes held in the free lists.
+     */
+    [[nodiscard]] std::size_t cached() const noexcept {
+        std::lock_guard lock(m_mutex);
+        return m_cached;
+    }
+};
+
+}  // namespace memory
+
+#endif  // MEMORY_HPP
@@ -0,0 +1,825 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2022 David Oniani
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef NPY_HPP
+#define NPY_HPP
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "io.hpp"
+#include "view.hpp"
+
+namespace io {
+
+namespace detail {
+
+inline constexpr char npy_magic[6] = {'\x93', 'N', 'U', 'M', 'P', 'Y'};
+
+/**
+ * @brief Holds the dictionary of a `.npy` header along with the offset of the elements.
+ */
+struct npy_header {
+    std::string descr;
+    bool fortran_order;
+    std::vector<size_type> shape;
+    std::size_t offset;
+};
+
+/**
+ * @brief Returns the `descr` of the element type in the byte order of the host.
+ */
+template <arithmetic T>
+[[nodiscard]] std::string npy_descr() {
+    static_assert(!std::is_same_v<T, core::bfloat16>, "NumPy has no bfloat16.");
+    return (sizeof(T) == 1 ? '|' : byte_order()) + (kind<T>() + std::to_string(sizeof(T)));
+}
+
+/**
+ * @brief Returns the text following the key and a colon in the dictionary, without leading
+ * whitespace.
+ */
+[[nodiscard]] inline std::string_view npy_value(std::string_view dict, const std::string_view key) {
+    auto pos = dict.find(key);
+    if (pos == std::string_view::npos || (pos = dict.find(':', pos + key.size())) == dict.npos) {
+        throw std::runtime_error("Invalid npy header.");
+    }
+    dict.remove_prefix(pos + 1);
+    dict.remove_prefix(std::min(dict.find_first_not_of(" \t"), dict.size()));
+    return dict;
+}
+
+/**
+ * @brief Parses the dictionary of a header, e.g. `{'descr': '<f4', 'fortran_order': False,
+ * 'shape': (3, 4), }`.
+ */
+[[nodiscard]] inline npy_header parse_npy(const std::string_view dict, const std::size_t offset) {
+    npy_header result{{}, false, {}, offset};
+
+    const auto descr = npy_value(dict, "'descr'");
+    const auto end = descr.find(descr.empty() ? '\'' : descr[0], 1);
+    if (descr.empty() || (descr[0] != '\'' && descr[0] != '"') || end == descr.npos) {
+        throw std::runtime_error("Invalid npy header.");
+    }
+    result.descr = descr.substr(1, end - 1);
+
+    const auto fortran_order = npy_value(dict, "'fortran_order'");
+    if (fortran_order.starts_with("True")) {
+        result.fortran_order = true;
+    } else if (!fortran_order.starts_with("False")) {
+        throw std::runtime_error("Invalid npy header.");
+    }
+
+    auto shape = npy_value(dict, "'shape'");
+    if (shape.empty() || shape[0] != '(' || shape.find(')') == shape.npos) {
+        throw std::runtime_error("Invalid npy header.");
+    }
+    shape = shape.substr(1, shape.find(')') - 1);
+    while (!shape.empty()) {
+        shape.remove_prefix(std::min(shape.find_first_not_of(" ,"), shape.size()));
+        if (shape.empty()) {
+            break;
+        }
+        size_type extent = 0;
+        const auto [ptr, ec] = std::from_chars(shape.data(), shape.data() + shape.size(), extent);
+        if (ec != std::errc{}) {
+            throw std::runtime_error("Invalid npy header.");
+        }
+        result.shape.push_back(extent);
+        shape.remove_prefix(static_cast<std::size_t>(ptr - shape.data()));
+    }
+    return result;
+}
+
+/**
+ * @brief Returns the number of bytes preceding the dictionary, validating the magic and version of
+ * the first eight bytes of a `.npy` file.
+ */
+[[nodiscard]] inline std::size_t npy_prefix(const char* bytes) {
+    if (std::memcmp(bytes, npy_magic, sizeof(npy_magic)) != 0) {
+        throw std::runtime_error("Invalid npy file.");
+    }
+    switch (bytes[6]) {
+        case 1:
+            return 10;
+        case 2:
+        case 3:
+            return 12;
+        default:
+            throw std::runtime_error("Unsupported npy version.");
+    }
+}
+
+/**
+ * @brief Returns the length of the dictionary, stored little-endian after the version.
+ */
+[[nodiscard]] inline std::size_t npy_dict_length(const char* bytes, const std::size_t prefix) {
+    std::size_t result = 0;
+    for (std::size_t idx = prefix; idx-- > 8;) {
+        result = result << 8 | static_cast<unsigned char>(bytes[idx]);
+    }
+    return result;
+}
+
+/**
+ * @brief Reads the header from the stream, leaving it positioned at the first element.
+ */
+[[nodiscard]] inline npy_header read_npy_header(std::istream& in) {
+    char prefix[12];
+    if (!in.read(prefix, 8)) {
+        throw std::runtime_error("Invalid npy file.");
+    }
+    const auto length = npy_prefix(prefix);
+    if (!in.read(prefix + 8, static_cast<std::streamsize>(length - 8))) {
+        throw std::runtime_error("Invalid npy file.");
+    }
+    std::string dict(npy_dict_length(prefix, length), '\0');
+    if (!in.read(dict.data(), static_cast<std::streamsize>(dict.size()))) {
+        throw std::runtime_error("Invalid npy file.");
+    }
+    return parse_npy(dict, length + dict.size());
+}
+
+/**
+ * @brief Checks the header against the element type and order.
+ * @param header Parsed header.
+ * @param swap Set to whether elements are stored in the opposite byte order.
+ * @return Extents of the tensor, which are those of the transpose for Fortran order.
+ */
+template <arithmetic T, size_type Order>
+[[nodiscard]] array<Order> npy_extents(const npy_header& header, bool& swap) {
+    static_assert(!std::is_same_v<T, core::bfloat16>, "NumPy has no bfloat16.");
+    const auto& descr = header.descr;
+    const auto type = kind<T>() + std::to_string(sizeof(T));
+    if (descr.size() < 2 || std::string_view(descr).substr(1) != type ||
+        (descr[0] != '<' && descr[0] != '>' && descr[0] != '|' && descr[0] != '=')) {
+        throw std::runtime_error("Tensor type mismatch.");
+    }
+    swap = sizeof(T) > 1 && (descr[0] == '<' || descr[0] == '>') && descr[0] != byte_order();
+    if (header.shape.size() != Order) {
+        throw std::runtime_error("Tensor dimension mismatch.");
+    }
+    array<Order> extents{};
+    std::copy(header.shape.begin(), header.shape.end(), extents.begin());
+    if (header.fortran_order) {
+        std::reverse(extents.begin(), extents.end());
+    }
+    return extents;
+}
+
+/**
+ * @brief Reverses the bytes of every element.
+ */
+template <typename T>
+void byteswap(T* const data, const size_type size) noexcept {
+    auto* bytes = reinterpret_cast<unsigned char*>(data);
+    for (size_type idx = 0; idx < size; ++idx, bytes += sizeof(T)) {
+        std::reverse(bytes, bytes + sizeof(T));
+    }
+}
+
+/**
+ * @brief Encodes the magic, version and dictionary of a C-order `.npy` file of the element type
+ * and extents, padded with spaces so that the elements start at a multiple of 64 bytes.
+ */
+template <arithmetic T, size_type Order>
+[[nodiscard]] std::string encode_npy(const array<Order>& extents) {
+    std::string dict = "{'descr': '" + npy_descr<T>() + "', 'fortran_order': False, 'shape': (";
+    for (size_type dim = 0; dim < Order; ++dim) {
+        dict += std::to_string(extents[dim]) + (Order == 1 || dim + 1 < Order ? "," : "");
+        dict += dim + 1 < Order ? " " : "";
+    }
+    dict += "), }";
+
+    // Version 1.0 stores the length of the dictionary in two bytes, version 2.0 in four.
+    std::size_t prefix = 10;
+    auto length = aligned(prefix + dict.size() + 1) - prefix;
+    if (length > 0xFFFF) {
+        prefix = 12;
+        length = aligned(prefix + dict.size() + 1) - prefix;
+    }
+    dict.resize(length - 1, ' ');
+    dict += '\n';
+
+    std::string result(npy_magic, sizeof(npy_magic));
+    result += static_cast<char>(prefix == 10 ? 1 : 2);
+    result += '\0';
+    for (std::size_t idx = 8; idx < prefix; ++idx) {
+        result += static_cast<char>(length >> (8 * (idx - 8)) & 0xFF);
+    }
+    return result + dict;
+}
+
+/**
+ * @brief Reads the elements following a header into a new tensor, fixing their byte order and
+ * layout.
+ */
+template <arithmetic T, size_type Order>
+[[nodiscard]] core::tensor<T, Order> read_npy_data(std::istream& in, const npy_header& header,
+                                                   std::pmr::memory_resource* const resource) {
+    bool swap = false;
+    const auto extents = npy_extents<T, Order>(header, swap);
+    auto result = core::tensor<T, Order>(extents, resource);
+    if (!in.read(reinterpret_cast<char*>(result.data()),
+                 static_cast<std::streamsize>(result.size() * sizeof(T)))) {
+        throw std::runtime_error("Invalid npy file.");
+    }
+    if (swap) {
+        byteswap(result.data(), result.size());
+    }
+    if (header.fortran_order && Order > 1) {
+        const auto view = result.view().transpose();
+        auto transposed = core::tensor<T, Order>(view.extents(), resource);
+        core::kernel::copy(transposed.data(), view.data(), view.extents(), view.strides());
+        return std::move(transposed).take();
+    }
+    return std::move(result).take();
+}
+
+/**
+ * @brief Computes CRC-32 checksums as used by ZIP archives, eight bytes at a time.
+ */
+class crc32 {
+   private:
+    static constexpr auto tables = [] {
+        std::array<std::array<std::uint32_t, 256>, 8> result{};
+        for (std::uint32_t idx = 0; idx < 256; ++idx) {
+            auto crc = idx;
+            for (int bit = 0; bit < 8; ++bit) {
+                crc = (crc >> 1) ^ (0xEDB88320U & (0U - (crc & 1U)));
+            }
+            result[0][idx] = crc;
+        }
+        for (std::size_t table = 1; table < 8; ++table) {
+            for (std::size_t idx = 0; idx < 256; ++idx) {
+                const auto prev = result[table - 1][idx];
+                result[table][idx] = (prev >> 8) ^ result[0][prev & 0xFF];
+            }
+        }
+        return result;
+    }();
+
+    std::uint32_t m_crc{0xFFFFFFFFU};
+
+   public:
+    /**
+     * @brief Adds the bytes to the checksum.
+     */
+    void update(const void* const data, std::size_t size) noexcept {
+        const auto* bytes = static_cast<const unsigned char*>(data);
+        auto crc = m_crc;
+        for (; size >= 8; size -= 8, bytes += 8) {
+            const std::uint32_t lo = (bytes[0] | bytes[1] << 8 | bytes[2] << 16 |
+                                      static_cast<std::uint32_t>(bytes[3]) << 24) ^
+                                     crc;
+            crc = tables[7][lo & 0xFF] ^ tables[6][lo >> 8 & 0xFF] ^ tables[5][lo >> 16 & 0xFF] ^
+                  tables[4][lo >> 24] ^ tables[3][bytes[4]] ^ tables[2][bytes[5]] ^
+                  tables[1][bytes[6]] ^ tables[0][bytes[7]];
+        }
+        for (; size > 0; --size, ++bytes) {
+            crc = (crc >> 8) ^ tables[0][(crc ^ *bytes) & 0xFF];
+        }
+        m_crc = crc;
+    }
+
+    /**
+     * @brief Returns the checksum of the bytes added so far.
+     */
+    [[nodiscard]] std::uint32_t value() const noexcept {
+        return m_crc ^ 0xFFFFFFFFU;
+    }
+};
+
+inline constexpr std::uint64_t zip_limit = 0xFFFFFFFFU;
+
+/**
+ * @brief Appends the lowest `bytes` bytes of the value in little-endian order.
+ */
+inline void put_le(std::string& out, const std::uint64_t val, const int bytes) {
+    for (int idx = 0; idx < bytes; ++idx) {
+        out += static_cast<char>(val >> (8 * idx) & 0xFF);
+    }
+}
+
+/**
+ * @brief Reads `bytes` bytes at the position as a little-endian value.
+ */
+[[nodiscard]] inline std::uint64_t get_le(const char* data, const std::size_t pos,
+                                          const std::size_t bytes) noexcept {
+    std::uint64_t result = 0;
+    for (auto idx = bytes; idx-- > 0;) {
+        result = result << 8 | static_cast<unsigned char>(data[pos + idx]);
+    }
+    return result;
+}
+
+}  // namespace detail
+
+/**
+ * @brief Writes the tensor to the stream in the `.npy` format.
+ * @param out Stream opened in binary mode.
+ * @param t Tensor to write.
+ */
+template <arithmetic T, size_type Order>
+void write_npy(std::ostream& out, const core::tensor<T, Order>& t) {
+    const auto header = detail::encode_npy<T>(t.extents());
+    out.write(header.data(), static_cast<std::streamsize>(header.size()));
+    out.write(reinterpret_cast<const char*>(t.data()),
+              static_cast<std::streamsize>(t.size() * sizeof(T)));
+    if (!out) {
+        throw std::runtime_error("Failed to write tensor.");
+    }
+}
+
+/**
+ * @brief Reads a tensor in the `.npy` format from the stream, straight into the buffer of the
+ * returned tensor. Elements in the opposite byte order are swapped, and those in Fortran order
+ * are transposed.
+ * @param in Stream opened in binary mode.
+ * @param resource Memory resource to allocate the elements from.
+ * @return Tensor holding the elements read.
+ */
+template <arithmetic T, size_type Order>
+[[nodiscard]] core::tensor<T, Order> read_npy(
+    std::istream& in, std::pmr::memory_resource* const resource = memory::default_resource()) {
+    return detail::read_npy_data<T, Order>(in, detail::read_npy_header(in), resource);
+}
+
+/**
+ * @brief Writes the tensor to the `.npy` file, replacing it if it exists.
+ * @param path Path to the file.
+ * @param t Tensor to write.
+ */
+template <arithmetic T, size_type Order>
+void save_npy(const std::filesystem::path& path, const core::tensor<T, Order>& t) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        throw std::runtime_error("Cannot open file.");
+    }
+    write_npy(out, t);
+}
+
+/**
+ * @brief Reads a tensor from the `.npy` file into a newly allocated buffer, see `read_npy`.
+ * @param path Path to the file.
+ * @param resource Memory resource to allocate the elements from.
+ * @return Tensor holding the elements read.
+ */
+template <arithmetic T, size_type Order>
+[[nodiscard]] core::tensor<T, Order> load_npy(
+    const std::filesystem::path& path,
+    std::pmr::memory_resource* const resource = memory::default_resource()) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        throw std::runtime_error("Cannot open file.");
+    }
+    return read_npy<T, Order>(in, resource);
+}
+
+/**
+ * @brief Maps the `.npy` file into memory and returns a tensor using the mapped elements in place,
+ * as `map` does. Files whose elements need swapping, transposing or are misaligned are loaded
+ * instead.
+ * @param path Path to the file.
+ * @return Tensor whose elements are those of the file.
+ */
+template <arithmetic T, size_type Order>
+[[nodiscard]] core::tensor<T, Order> map_npy(const std::filesystem::path& path) {
+#if TENSOR_HAS_MMAP
+    const auto file = detail::map_file(path, 12);
+    const auto* const bytes = static_cast<const char*>(file.base);
+    try {
+        const auto prefix = detail::npy_prefix(bytes);
+        const auto length = detail::npy_dict_length(bytes, prefix);
+        if (file.length < prefix + length) {
+            throw std::runtime_error("Invalid npy file.");
+        }
+        const auto header =
+            detail::parse_npy(std::string_view(bytes + prefix, length), prefix + length);
+        bool swap = false;
+        const auto extents = detail::npy_extents<T, Order>(header, swap);
+        if (!swap && !(header.fortran_order && Order > 1) && header.offset % alignof(T) == 0) {
+            return detail::adopt<T>(file, header.offset, extents);
+        }
+    } catch (...) {
+        ::munmap(file.base, file.length);
+        throw;
+    }
+    ::munmap(file.base, file.length);
+#endif
+    return load_npy<T, Order>(path);
+}
+
+/**
+ * @brief Reads a C-order `.npy` file in chunks of sub-tensors along the first axis, so that files
+ * larger than memory can be processed piece by piece. Each chunk is read straight into its
+ * buffer.
+ * @tparam T Arithmetic type representing the type of every element in the file.
+ * @tparam Order Order of the tensor stored in the file.
+ */
+template <arithmetic T, size_type Order>
+    requires(Order > 0)
+class npy_reader {
+   private:
+    std::ifstream m_in;
+    array<Order> m_extents;
+    size_type m_next{0};
+    bool m_swap{false};
+
+   public:
+    /**
+     * @brief Opens the file and reads its header.
+     * @param path Path to the file.
+     */
+    explicit npy_reader(const std::filesystem::path& path) : m_in(path, std::ios::binary) {
+        if (!m_in) {
+            throw std::runtime_error("Cannot open file.");
+        }
+        const auto header = detail::read_npy_header(m_in);
+        m_extents = detail::npy_extents<T, Order>(header, m_swap);
+        if (header.fortran_order && Order > 1) {
+            throw std::runtime_error("Unsupported tensor layout.");
+        }
+    }
+
+    /**
+     * @brief Returns the extents of the whole tensor in the file.
+     */
+    [[nodiscard]] auto extents() const noexcept {
+        return m_extents;
+    }
+
+    /**
+     * @brief Returns the number of sub-tensors along the first axis not read yet.
+     */
+    [[nodiscard]] size_type remaining() const noexcept {
+        return m_extents[0] - m_next;
+    }
+
+    /**
+     * @brief Reads the next sub-tensors along the first axis.
+     * @param count Maximum number of sub-tensors to read.
+     * @param resource Memory resource to allocate the elements from.
+     * @return Tensor whose first extent is the number of sub-tensors read, zero at the end.
+     */
+    [[nodiscard]] core::tensor<T, Order> read(
+        const size_type count,
+        std::pmr::memory_resource* const resource = memory::default_resource()) {
+        auto extents = m_extents;
+        extents[0] = std::min(count, remaining());
+        auto result = core::tensor<T, Order>(extents, resource);
+        if (!m_in.read(reinterpret_cast<char*>(result.data()),
+                       static_cast<std::streamsize>(result.size() * sizeof(T)))) {
+            throw std::runtime_error("Invalid npy file.");
+        }
+        if (m_swap) {
+            detail::byteswap(result.data(), result.size());
+        }
+        m_next += extents[0];
+        return result;
+    }
+};
+
+/**
+ * @brief Writes tensors into a `.npz` archive, as NumPy's `savez` does: every tensor is stored
+ * uncompressed as a `.npy` entry. ZIP64 records are written as needed for large archives.
+ */
+class npz_writer {
+   private:
+    struct entry {
+        std::string name;
+        std::uint32_t crc;
+        std::uint64_t size;
+        std::uint64_t offset;
+    };
+
+    std::ofstream m_out;
+    std::vector<entry> m_entries;
+    std::uint64_t m_offset{0};
+    bool m_closed{false};
+
+    // Version 4.5 is required for ZIP64, 2.0 otherwise. Dates are 1980-01-01 in MS-DOS format.
+    static constexpr std::uint16_t version_zip64 = 45;
+    static constexpr std::uint16_t version_plain = 20;
+    static constexpr std::uint16_t dos_date = 0x21;
+
+    void write(const std::string& bytes) {
+        m_out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+        m_offset += bytes.size();
+    }
+
+   public:
+    /**
+     * @brief Creates the archive, replacing the file if it exists.
+     * @param path Path to the file.
+     */
+    explicit npz_writer(const std::filesystem::path& path)
+        : m_out(path, std::ios::binary | std::ios::trunc) {
+        if (!m_out) {
+            throw std::runtime_error("Cannot open file.");
+        }
+    }
+
+    npz_writer(const npz_writer&) = delete;
+    npz_writer& operator=(const npz_writer&) = delete;
+
+    /**
+     * @brief Finishes the archive unless `close` was called.
+     */
+    ~npz_writer() {
+        try {
+            close();
+        } catch (...) {
+        }
+    }
+
+    /**
+     * @brief Adds the tensor to the archive as the entry `name.npy`.
+     * @param name Name of the tensor, as used by `npz_reader::get`.
+     * @param t Tensor to add.
+     */
+    template <arithmetic T, size_type Order>
+    void add(const std::string& name, const core::tensor<T, Order>& t) {
+        const auto header = detail::encode_npy<T>(t.extents());
+        const auto bytes = t.size() * sizeof(T);
+        detail::crc32 crc;
+        crc.update(header.data(), header.size());
+        crc.update(t.data(), bytes);
+
+        entry e{name + ".npy", crc.value(), header.size() + bytes, m_offset};
+        const auto zip64 = e.size >= detail::zip_limit;
+        std::string local;
+        detail::put_le(local, 0x04034b50, 4);
+        detail::put_le(local, zip64 ? version_zip64 : version_plain, 2);
+        detail::put_le(local, 0, 4);  // Flags and method, which is stored.
+        detail::put_le(local, 0, 2);
+        detail::put_le(local, dos_date, 2);
+        detail::put_le(local, e.crc, 4);
+        detail::put_le(local, zip64 ? detail::zip_limit : e.size, 4);
+        detail::put_le(local, zip64 ? detail::zip_limit : e.size, 4);
+        detail::put_le(local, e.name.size(), 2);
+        detail::put_le(local, zip64 ? 20 : 0, 2);
+        local += e.name;
+        if (zip64) {
+            detail::put_le(local, 0x0001, 2);
+            detail::put_le(local, 16, 2);
+            detail::put_le(local, e.size, 8);
+            detail::put_le(local, e.size, 8);
+        }
+        write(local);
+        write(header);
+        m_out.write(reinterpret_cast<const char*>(t.data()), static_cast<std::streamsize>(bytes));
+        m_offset += bytes;
+        if (!m_out) {
+            throw std::runtime_error("Failed to write tensor.");
+        }
+        m_entries.push_back(std::move(e));
+    }
+
+    /**
+     * @brief Writes the central directory, after which no tensors can be added.
+     */
+    void close() {
+        if (m_closed) {
+            return;
+        }
+        m_closed = true;
+        const auto start = m_offset;
+        for (const auto& e : m_entries) {
+            const auto large = e.size >= detail::zip_limit;
+            const auto far = e.offset >= detail::zip_limit;
+            std::string extra;
+            if (large || far) {
+                detail::put_le(extra, 0x0001, 2);
+                detail::put_le(extra, (large ? 16 : 0) + (far ? 8 : 0), 2);
+                if (large) {
+                    detail::put_le(extra, e.size, 8);
+                    detail::put_le(extra, e.size, 8);
+                }
+                if (far) {
+                    detail::put_le(extra, e.offset, 8);
+                }
+            }
+            std::string central;
+            detail::put_le(central, 0x02014b50, 4);
+            detail::put_le(central, version_zip64, 2);
+            detail::put_le(central, large || far ? version_zip64 : version_plain, 2);
+            detail::put_le(central, 0, 4);
+            detail::put_le(central, 0, 2);
+            detail::put_le(central, dos_date, 2);
+            detail::put_le(central, e.crc, 4);
+            detail::put_le(central, large ? detail::zip_limit : e.size, 4);
+            detail::put_le(central, large ? detail::zip_limit : e.size, 4);
+            detail::put_le(central, e.name.size(), 2);
+            detail::put_le(central, extra.size(), 2);
+            detail::put_le(central, 0, 6);  // Comment length, disk and attributes.
+            detail::put_le(central, 0, 4);
+            detail::put_le(central, far ? detail::zip_limit : e.offset, 4);
+            write(central + e.name + extra);
+        }
+
+        const auto size = m_offset - start;
+        const auto count = static_cast<std::uint64_t>(m_entries.size());
+        std::string end;
+        if (count >= 0xFFFF || size >= detail::zip_limit || start >= detail::zip_limit) {
+            const auto record = m_offset;
+            detail::put_le(end, 0x06064b50, 4);
+            detail::put_le(end, 44, 8);
+            detail::put_le(end, version_zip64, 2);
+            detail::put_le(end, version_zip64, 2);
+            detail::put_le(end, 0, 8);  // Number of this disk and of the directory's.
+            detail::put_le(end, count, 8);
+            detail::put_le(end, count, 8);
+            detail::put_le(end, size, 8);
+            detail::put_le(end, start, 8);
+            detail::put_le(end, 0x07064b50, 4);
+            detail::put_le(end, 0, 4);
+            detail::put_le(end, record, 8);
+            detail::put_le(end, 1, 4);
+        }
+        detail::put_le(end, 0x06054b50, 4);
+        detail::put_le(end, 0, 4);
+        detail::put_le(end, std::min<std::uint64_t>(count, 0xFFFF), 2);
+        detail::put_le(end, std::min<std::uint64_t>(count, 0xFFFF), 2);
+        detail::put_le(end, std::min(size, detail::zip_limit), 4);
+        detail::put_le(end, std::min(start, detail::zip_limit), 4);
+        detail::put_le(end, 0, 2);
+        write(end);
+        m_out.close();
+        if (!m_out) {
+            throw std::runtime_error("Failed to write tensor.");
+        }
+    }
+};
+
+/**
+ * @brief Reads tensors from a `.npz` archive as written by NumPy's `savez` or `npz_writer`. Only
+ * uncompressed entries are supported, those of `savez_compressed` throw.
+ */
+class npz_reader {
+   private:
+    struct entry {
+        std::uint64_t offset;
+        std::uint16_t method;
+    };
+
+    mutable std::ifstream m_in;
+    std::unordered_map<std::string, entry> m_entries;
+    std::vector<std::string> m_names;
+
+    /**
+     * @brief Reads `size` bytes at the position.
+     */
+    [[nodiscard]] std::string bytes_at(const std::uint64_t pos, const std::size_t size) const {
+        std::string result(size, '\0');
+        m_in.seekg(static_cast<std::streamoff>(pos));
+        if (!m_in.read(result.data(), static_cast<std::streamsize>(size))) {
+            throw std::runtime_error("Invalid npz file.");
+        }
+        return result;
+    }
+
+   public:
+    /**
+     * @brief Opens the archive and reads its central directory.
+     * @param path Path to the file.
+     */
+    explicit npz_reader(const std::filesystem::path& path) : m_in(path, std::ios::binary) {
+        if (!m_in) {
+            throw std::runtime_error("Cannot open file.");
+        }
+        const auto length = static_cast<std::uint64_t>(std::filesystem::file_size(path));
+        if (length < 22) {
+            throw std::runtime_error("Invalid npz file.");
+        }
+
+        // The end of central directory record is followed by a comment of at most 65535 bytes.
+        const auto tail_size = static_cast<std::size_t>(std::min<std::uint64_t>(length, 65557));
+        const auto tail = bytes_at(length - tail_size, tail_size);
+        auto pos = tail.rfind(std::string("PK\x05\x06", 4));
+        if (pos == std::string::npos || pos + 22 > tail.size()) {
+            throw std::runtime_error("Invalid npz file.");
+        }
+        auto count = detail::get_le(tail.data(), pos + 10, 2);
+        auto start = detail::get_le(tail.data(), pos + 16, 4);
+        if (count == 0xFFFF || start == detail::zip_limit) {
+            const auto locator = length - tail_size + pos - 20;
+            const auto bytes = bytes_at(locator, 20);
+            if (detail::get_le(bytes.data(), 0, 4) != 0x07064b50) {
+                throw std::runtime_error("Invalid npz file.");
+            }
+            const auto record = bytes_at(detail::get_le(bytes.data(), 8, 8), 56);
+            count = detail::get_le(record.data(), 32, 8);
+            start = detail::get_le(record.data(), 48, 8);
+        }
+
+        pos = 0;
+        for (std::uint64_t idx = 0; idx < count; ++idx) {
+            const auto fixed = bytes_at(start + pos, 46);
+            if (detail::get_le(fixed.data(), 0, 4) != 0x02014b50) {
+                throw std::runtime_error("Invalid npz file.");
+            }
+            const auto method = static_cast<std::uint16_t>(detail::get_le(fixed.data(), 10, 2));
+            const auto size = detail::get_le(fixed.data(), 24, 4);
+            const auto name_length = detail::get_le(fixed.data(), 28, 2);
+            const auto extra_length = detail::get_le(fixed.data(), 30, 2);
+            const auto comment_length = detail::get_le(fixed.data(), 32, 2);
+            auto offset = detail::get_le(fixed.data(), 42, 4);
+            const auto rest = bytes_at(start + pos + 46, name_length + extra_length);
+
+            // The ZIP64 extra field holds those of the sizes and offset which overflowed, in order.
+            if (offset == detail::zip_limit) {
+                for (std::size_t field = name_length; field + 4 <= rest.size();) {
+                    const auto id = detail::get_le(rest.data(), field, 2);
+                    const auto field_length = detail::get_le(rest.data(), field + 2, 2);
+                    if (id == 0x0001) {
+                        const auto skip = size == detail::zip_limit ? 16 : 0;
+                        offset = detail::get_le(rest.data(), field + 4 + skip, 8);
+                        break;
+                    }
+                    field += 4 + field_length;
+                }
+            }
+
+            auto name = rest.substr(0, name_length);
+            if (name.ends_with(".npy")) {
+                name.resize(name.size() - 4);
+            }
+            m_names.push_back(name);
+            m_entries.emplace(std::move(name), entry{offset, method});
+            pos += 46 + name_length + extra_length + comment_length;
+        }
+    }
+
+    /**
+     * @brief Returns the names of the tensors in the archive, in the order they are stored.
+     */
+    [[nodiscard]] const std::vector<std::string>& names() const noexcept {
+        return m_names;
+    }
+
+    /**
+     * @brief Reads the tensor of the provided name straight into the buffer of the returned tensor.
+     * @param name Name of the tensor, without the `.npy` extension.
+     * @param resource Memory resource to allocate the elements from.
+     * @return Tensor holding the elements read.
+     */
+    template <arithmetic T, size_type Order>
+    [[nodiscard]] core::tensor<T, Order> get(
+        const std::string& name,
+        std::pmr::memory_resource* const resource = memory::default_resource()) const {
+        const auto it = m_entries.find(name);
+        if (it == m_entries.end()) {
+            throw std::out_of_range("No tensor of that name.");
+        }
+        if (it->second.method != 0) {
+            throw std::runtime_error("Unsupported compression.");
+        }
+        const auto local = bytes_at(it->second.offset, 30);
+        if (detail::get_le(local.data(), 0, 4) != 0x04034b50) {
+            throw std::runtime_error("Invalid npz file.");
+        }
+        m_in.seekg(static_cast<std::streamoff>(it->second.offset + 30 +
+                                               detail::get_le(local.data(), 26, 2) +
+                                               detail::get_le(local.data(), 28, 2)));
+        return read_npy<T, Order>(m_in, resource);
+    }
+};
+
+}  // namespace io
+
+#endif  // NPY_HPP
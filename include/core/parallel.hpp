@@ -0,0 +1,276 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2022 David Oniani
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef PARALLEL_HPP
+#define PARALLEL_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Opt-in multithreaded execution of the element-wise kernels. Everything runs on the calling
+ * thread until `set_threads` is called with more than one thread, and even then only buffers of at
+ * least `threshold()` elements are split into chunks, as smaller ones do not amortize the hand-off.
+ */
+namespace parallel {
+
+namespace detail {
+
+inline std::atomic<std::size_t> num_threads{1};
+inline std::atomic<std::size_t> min_size{std::size_t{1} << 16};
+
+// Chunks are a multiple of this many elements so that only the last one ends in a partial pack.
+inline constexpr std::size_t alignment = 64;
+
+// Set on the threads of the pool, so that kernels invoked from within a chunk run serially rather
+// than waiting on the pool they occupy.
+inline thread_local bool is_worker = false;
+
+/**
+ * @brief A fixed set of worker threads executing jobs in submission order.
+ */
+class pool {
+   private:
+    std::vector<std::thread> m_workers;
+    std::deque<std::function<void()> > m_jobs;
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    bool m_stop{false};
+
+    void work() {
+        is_worker = true;
+        while (true) {
+            std::function<void()> job;
+            {
+                std::unique_lock lock(m_mutex);
+                m_cv.wait(lock, [this] { return m_stop || !m_jobs.empty(); });
+                if (m_jobs.empty()) {
+                    return;
+                }
+                job = std::move(m_jobs.front());
+                m_jobs.pop_front();
+            }
+            job();
+        }
+    }
+
+   public:
+    pool() = default;
+    pool(const pool&) = delete;
+    pool& operator=(const pool&) = delete;
+
+    ~pool() {
+        {
+            std::lock_guard lock(m_mutex);
+            m_stop = true;
+        }
+        m_cv.notify_all();
+        for (auto& worker : m_workers) {
+            worker.join();
+        }
+    }
+
+    /**
+     * @brief Queues the job, starting workers until there are at least `workers` of them.
+     * @param workers Number of workers the caller expects to be available.
+     * @param job Job to execute.
+     */
+    void submit(const std::size_t workers, std::function<void()> job) {
+        {
+            std::lock_guard lock(m_mutex);
+            while (m_workers.size() < workers) {
+                m_workers.emplace_back([this] { work(); });
+            }
+            m_jobs.push_back(std::move(job));
+        }
+        m_cv.notify_one();
+    }
+};
+
+inline pool& instance() {
+    static pool p;
+    return p;
+}
+
+/**
+ * @brief Hands out chunks of [0, size) to `count - 1` workers and the calling thread until all are
+ * processed or one of them fails.
+ */
+template <typename F>
+bool run(const std::size_t size, const std::size_t chunk, const std::size_t count, F&& func) {
+    const auto chunks = (size + chunk - 1) / chunk;
+    const auto helpers = std::min(count, chunks) - 1;
+
+    struct state {
+        std::atomic<std::size_t> next{0};
+        std::atomic<bool> stop{false};
+        std::exception_ptr error;
+        std::mutex mutex;
+        std::condition_variable cv;
+        std::size_t pending;
+    } shared;
+    shared.pending = helpers;
+
+    const auto drain = [&] {
+        while (!shared.stop.load(std::memory_order_relaxed)) {
+            const auto idx = shared.next.fetch_add(1, std::memory_order_relaxed);
+            if (idx >= chunks) {
+                return;
+            }
+            try {
+                if (!func(idx * chunk, std::min(size, (idx + 1) * chunk))) {
+                    shared.stop = true;
+                }
+            } catch (...) {
+                std::lock_guard lock(shared.mutex);
+                if (!shared.error) {
+                    shared.error = std::current_exception();
+                }
+                shared.stop = true;
+            }
+        }
+    };
+
+    for (std::size_t idx = 0; idx < helpers; ++idx) {
+        instance().submit(count - 1, [&] {
+            drain();
+            std::lock_guard lock(shared.mutex);
+            if (--shared.pending == 0) {
+                shared.cv.notify_one();
+            }
+        });
+    }
+    drain();
+
+    std::unique_lock lock(shared.mutex);
+    shared.cv.wait(lock, [&] { return shared.pending == 0; });
+    if (shared.error) {
+        std::rethrow_exception(shared.error);
+    }
+    return !shared.stop;
+}
+
+}  // namespace detail
+
+/**
+ * @brief Sets the number of threads used by the kernels, one (the default) disables threading.
+ * @param count Number of threads including the calling one, zero selects the hardware concurrency.
+ * @return The previous number of threads.
+ */
+inline std::size_t set_threads(std::size_t count) noexcept {
+    if (count == 0) {
+        count = std::max(std::thread::hardware_concurrency(), 1U);
+    }
+    return detail::num_threads.exchange(count);
+}
+
+/**
+ * @brief Returns the number of threads used by the kernels.
+ */
+[[nodiscard]] inline std::size_t threads() noexcept {
+    return detail::num_threads.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Sets the number of elements below which kernels run on the calling thread.
+ * @param size Minimum number of elements to split across threads.
+ * @return The previous threshold.
+ */
+inline std::size_t set_threshold(const std::size_t size) noexcept {
+    return detail::min_size.exchange(size);
+}
+
+/**
+ * @brief Returns the number of elements below which kernels run on the calling thread.
+ */
+[[nodiscard]] inline std::size_t threshold() noexcept {
+    return detail::min_size.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Splits [0, size) into chunks processed concurrently by the calling thread and the pool.
+ * Chunks stop being handed out once `func` returns false or throws, in which case the first
+ * exception is rethrown on the calling thread.
+ * @param size Number of elements.
+ * @param func Callable invoked as `func(begin, end)`, returning whether to continue.
+ * @return Whether every chunk returned true.
+ */
+template <typename F>
+bool for_each_until(const std::size_t size, F&& func) {
+    const auto count = threads();
+    if (count <= 1 || size < std::max<std::size_t>(threshold(), 1) || detail::is_worker) {
+        return func(std::size_t{0}, size);
+    }
+
+    // Several chunks per thread balance uneven progress, as chunks are claimed dynamically.
+    const auto per_chunk = (size + 4 * count - 1) / (4 * count);
+    const auto chunk = (per_chunk + detail::alignment - 1) / detail::alignment * detail::alignment;
+    return detail::run(size, chunk, count, func);
+}
+
+/**
+ * @brief Splits [0, size) into chunks processed concurrently by the calling thread and the pool.
+ * @param size Number of elements.
+ * @param func Callable invoked as `func(begin, end)`.
+ */
+template <typename F>
+void for_each(const std::size_t size, F&& func) {
+    for_each_until(size, [&](const std::size_t begin, const std::size_t end) {
+        func(begin, end);
+        return true;
+    });
+}
+
+/**
+ * @brief Processes the tasks [0, count) concurrently by the calling thread and the pool, one at a
+ * time. Unlike `for_each`, no threshold applies, as tasks are expected to be coarse.
+ * @param count Number of tasks.
+ * @param func Callable invoked as `func(idx)`.
+ */
+template <typename F>
+void for_each_index(const std::size_t count, F&& func) {
+    const auto body = [&](const std::size_t begin, const std::size_t end) {
+        for (auto idx = begin; idx < end; ++idx) {
+            func(idx);
+        }
+        return true;
+    };
+    if (threads() <= 1 || count <= 1 || detail::is_worker) {
+        body(std::size_t{0}, count);
+        return;
+    }
+    detail::run(count, 1, threads(), body);
+}
+
+}  // namespace parallel
+
+#endif  // PARALLEL_HPP
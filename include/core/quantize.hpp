@@ -0,0 +1,338 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2022 David Oniani
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef QUANTIZE_HPP
+#define QUANTIZE_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <numeric>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "reduce.hpp"
+
+namespace core {
+
+/**
+ * @brief Holds 8-bit integers along with the affine parameters mapping them back to real numbers,
+ * `real = scale * (value - zero_point)`. The parameters are either shared by every element, or by
+ * the elements sharing an index along `axis`, e.g. the output channels of a weight.
+ * @tparam Order The NTTP representing the order of the tensor.
+ */
+template <size_type Order>
+struct quantized {
+    tensor<std::int8_t, Order> values;
+    tensor<float, 1> scales;
+    tensor<std::int8_t, 1> zero_points;
+    std::optional<size_type> axis;
+};
+
+namespace detail {
+
+/**
+ * @brief Loads the pack of parameters for `count` elements from `offset` on, which either vary
+ * along the elements or are shared by all of them.
+ */
+template <bool Varying, typename P>
+[[nodiscard]] P param(const float* p, const size_type offset, const size_type count) noexcept {
+    if constexpr (Varying) {
+        return count == P::width ? P::load(p + offset) : simd::load_partial(p + offset, count);
+    } else {
+        return P(*p);
+    }
+}
+
+/**
+ * @brief Quantizes `size` elements, which share the parameters `*inv_scale` and `*zero`, or, if
+ * `Varying` is set, take parameter `idx` for element `idx`. Values are rounded to nearest even and
+ * saturated, as in `simd::narrow`.
+ */
+template <bool Varying, typename T>
+void quantize_range(std::int8_t* dst, const T* src, const size_type size, const float* inv_scale,
+                    const float* zero) {
+    size_type idx = 0;
+    if constexpr (simd::loadable<T> && std::is_same_v<simd::lane_t<T>, float>) {
+        using P = simd::pack<float>;
+        const auto affine = [&](const P x, const size_type count) {
+            const auto inv = param<Varying, P>(inv_scale, idx, count);
+            return x * inv + param<Varying, P>(zero, idx, count);
+        };
+        for (; idx + P::width <= size; idx += P::width) {
+            simd::narrow(dst + idx, affine(simd::load(src + idx), P::width));
+        }
+        if (const auto rest = size - idx; rest != 0) {
+            const auto x = simd::load_partial(src + idx, rest);
+            simd::narrow_partial(dst + idx, affine(x, rest), rest);
+            return;
+        }
+    }
+    for (; idx < size; ++idx) {
+        const auto k = Varying ? idx : 0;
+        const auto x = static_cast<float>(src[idx]);
+        dst[idx] = simd::narrow_cast<std::int8_t>(x * inv_scale[k] + zero[k]);
+    }
+}
+
+/**
+ * @brief Dequantizes `size` elements, with parameters as in `quantize_range`.
+ */
+template <bool Varying, typename T>
+void dequantize_range(T* dst, const std::int8_t* src, const size_type size, const float* scale,
+                      const float* zero) {
+    size_type idx = 0;
+    if constexpr (simd::loadable<T> && std::is_same_v<simd::lane_t<T>, float>) {
+        using P = simd::pack<float>;
+        const auto affine = [&](const P q, const size_type count) {
+            return (q - param<Varying, P>(zero, idx, count)) * param<Varying, P>(scale, idx, count);
+        };
+        for (; idx + P::width <= size; idx += P::width) {
+            simd::store(dst + idx, affine(simd::widen(src + idx), P::width));
+        }
+        if (const auto rest = size - idx; rest != 0) {
+            const auto q = simd::widen_partial(src + idx, rest);
+            simd::store_partial(dst + idx, affine(q, rest), rest);
+            return;
+        }
+    }
+    for (; idx < size; ++idx) {
+        const auto k = Varying ? idx : 0;
+        dst[idx] = static_cast<T>((static_cast<float>(src[idx]) - zero[k]) * scale[k]);
+    }
+}
+
+/**
+ * @brief Splits the elements [0, size) across threads into runs sharing a channel, i.e. an index
+ * along the quantization axis, and invokes `func(begin, end, channel, varying)` on each. If the
+ * channels are innermost, runs go along a row of channels instead, and `varying` is set.
+ * @param size Number of elements.
+ * @param count Number of channels.
+ * @param inner Number of consecutive elements sharing a channel.
+ * @param func Function processing a run.
+ */
+template <typename F>
+void for_each_run(const size_type size, const size_type count, const size_type inner, F&& func) {
+    parallel::for_each(size, [&](const size_type begin, const size_type end) {
+        for (auto idx = begin; idx < end;) {
+            if (inner == 1 && count > 1) {
+                const auto channel = idx % count;
+                const auto last = std::min(end, idx - channel + count);
+                func(idx, last, channel, true);
+                idx = last;
+            } else {
+                const auto channel = idx / inner % count;
+                const auto last = std::min(end, (idx / inner + 1) * inner);
+                func(idx, last, channel, false);
+                idx = last;
+            }
+        }
+    });
+}
+
+/**
+ * @brief Returns the extents split around the axis, or all elements as a single channel.
+ */
+template <size_type Order>
+[[nodiscard]] std::array<size_type, 3> channels(const array<Order>& extents,
+                                                const std::optional<size_type> axis) {
+    if (axis) {
+        if (*axis >= Order) {
+            throw std::out_of_range("Index out of bounds.");
+        }
+        return split(extents, *axis);
+    }
+    const auto size = std::reduce(extents.begin(), extents.end(), size_type{1},
+                                  std::multiplies<size_type>());
+    return {1, 1, size};
+}
+
+/**
+ * @brief Quantizes the tensor with the provided parameters, one per channel.
+ */
+template <arithmetic T, size_type Order>
+[[nodiscard]] quantized<Order> quantize_with(const tensor<T, Order>& t, tensor<float, 1> scales,
+                                             tensor<std::int8_t, 1> zero_points,
+                                             const std::optional<size_type> axis) {
+    const auto [outer, count, inner] = channels(t.extents(), axis);
+    std::vector<float> inv_scales(count);
+    std::vector<float> zeros(count);
+    for (size_type channel = 0; channel < count; ++channel) {
+        if (!(scales[channel] > 0)) {
+            throw std::domain_error("Quantization scale must be positive.");
+        }
+        inv_scales[channel] = 1 / scales[channel];
+        zeros[channel] = zero_points[channel];
+    }
+    auto values = tensor<std::int8_t, Order>(t.extents());
+    auto* dst = values.data();
+    const auto* src = t.data();
+    for_each_run(t.size(), count, inner,
+                 [&](const size_type begin, const size_type end, const size_type channel,
+                     const bool varying) {
+                     const auto* inv = inv_scales.data() + channel;
+                     const auto* zero = zeros.data() + channel;
+                     if (varying) {
+                         quantize_range<true>(dst + begin, src + begin, end - begin, inv, zero);
+                     } else {
+                         quantize_range<false>(dst + begin, src + begin, end - begin, inv, zero);
+                     }
+                 });
+    return {std::move(values).take(), std::move(scales).take(), std::move(zero_points).take(),
+            axis};
+}
+
+/**
+ * @brief Quantizes the tensor, choosing per channel the parameters that map the range of values,
+ * extended to include zero, onto [-128, 127], so that zero is represented exactly.
+ */
+template <arithmetic T, size_type Order>
+[[nodiscard]] quantized<Order> quantize_range_of(const tensor<T, Order>& t,
+                                                 const std::optional<size_type> axis) {
+    using A = compute_t<T>;
+    const auto [outer, count, inner] = channels(t.extents(), axis);
+    const auto e = lazy(t);
+    auto scales = tensor<float, 1>(array<1>{count});
+    auto zero_points = tensor<std::int8_t, 1>(array<1>{count});
+    run_tasks(count, t.size(), [&](const size_type channel) {
+        A lo = 0;
+        A hi = 0;
+        for (size_type idx = 0; idx < outer; ++idx) {
+            const auto begin = (idx * count + channel) * inner;
+            lo = min_op{}(lo, reduce_range<A>(e, begin, begin + inner, min_op{}, identity_fn{}));
+            hi = max_op{}(hi, reduce_range<A>(e, begin, begin + inner, max_op{}, identity_fn{}));
+        }
+        const auto scale = static_cast<float>((hi - lo) / 255);
+        scales[channel] = scale > 0 ? scale : 1.0F;
+        zero_points[channel] =
+            simd::narrow_cast<std::int8_t>(-128.0F - static_cast<float>(lo) / scales[channel]);
+    });
+    return quantize_with(t, std::move(scales).take(), std::move(zero_points).take(), axis);
+}
+
+}  // namespace detail
+
+/**
+ * @brief Quantizes the tensor to 8-bit integers with a scale and zero point shared by every
+ * element, mapping the range of values, extended to include zero, onto [-128, 127]. Zero is
+ * represented exactly, while the smallest and largest values, like all others, are rounded to
+ * within half a scale. Elements are converted by SIMD packs and split across threads.
+ * @param t Tensor of a floating-point type.
+ * @return Quantized tensor.
+ */
+template <arithmetic T, size_type Order>
+    requires std::is_floating_point_v<compute_t<T> >
+[[nodiscard]] quantized<Order> quantize(const tensor<T, Order>& t) {
+    return detail::quantize_range_of(t, std::nullopt);
+}
+
+/**
+ * @brief Quantizes the tensor to 8-bit integers with a scale and zero point per index along the
+ * axis, e.g. per output channel of a weight.
+ * @param t Tensor of a floating-point type.
+ * @param axis Axis the parameters vary along.
+ * @return Quantized tensor.
+ */
+template <arithmetic T, size_type Order>
+    requires(std::is_floating_point_v<compute_t<T> > && Order > 0)
+[[nodiscard]] quantized<Order> quantize(const tensor<T, Order>& t, const size_type axis) {
+    return detail::quantize_range_of(t, axis);
+}
+
+/**
+ * @brief Quantizes the tensor to 8-bit integers with the provided parameters, rounding to nearest
+ * even and saturating values outside of the range.
+ * @param t Tensor of a floating-point type.
+ * @param scale Positive distance between consecutive quantized values, any other value throwing
+ * `std::domain_error`.
+ * @param zero_point Quantized value representing zero.
+ * @return Quantized tensor.
+ */
+template <arithmetic T, size_type Order>
+    requires std::is_floating_point_v<compute_t<T> >
+[[nodiscard]] quantized<Order> quantize(const tensor<T, Order>& t, const float scale,
+                                        const std::int8_t zero_point) {
+    auto scales = tensor<float, 1>(array<1>{1});
+    auto zero_points = tensor<std::int8_t, 1>(array<1>{1});
+    scales[0] = scale;
+    zero_points[0] = zero_point;
+    return detail::quantize_with(t, std::move(scales).take(), std::move(zero_points).take(),
+                                 std::nullopt);
+}
+
+/**
+ * @brief Maps quantized values back to real numbers, by SIMD packs split across threads.
+ * @tparam T Floating-point type of the result, e.g. `float16`.
+ * @param q Quantized tensor.
+ * @return Tensor of the same extents.
+ */
+template <arithmetic T = float, size_type Order>
+    requires std::is_floating_point_v<compute_t<T> >
+[[nodiscard]] tensor<T, Order> dequantize(const quantized<Order>& q) {
+    const auto [outer, count, inner] = detail::channels(q.values.extents(), q.axis);
+    if (q.scales.size() != count || q.zero_points.size() != count) {
+        throw std::runtime_error("Tensor dimension mismatch.");
+    }
+    std::vector<float> zeros(q.zero_points.data(), q.zero_points.data() + count);
+    auto result = tensor<T, Order>(q.values.extents());
+    auto* dst = result.data();
+    const auto* src = q.values.data();
+    detail::for_each_run(result.size(), count, inner,
+                         [&](const size_type begin, const size_type end, const size_type channel,
+                             const bool varying) {
+                             const auto* scale = q.scales.data() + channel;
+                             const auto* zero = zeros.data() + channel;
+                             const auto n = end - begin;
+                             if (varying) {
+                                 detail::dequantize_range<true>(dst + begin, src + begin, n, scale,
+                                                                zero);
+                             } else {
+                                 detail::dequantize_range<false>(dst + begin, src + begin, n,
+                                                                 scale, zero);
+                             }
+                         });
+    return result;
+}
+
+/**
+ * @brief Converts the elements of a tensor, view or expression to another type, as by
+ * `static_cast`. Conversions between `float` and the 16-bit floating-point types go through SIMD
+ * packs.
+ * @tparam U Element type of the result.
+ * @param x Tensor, view or expression.
+ * @return A new tensor of the same extents.
+ */
+template <arithmetic U, detail::reducible X>
+[[nodiscard]] auto convert(const X& x) {
+    const auto e = detail::as_expr(x);
+    return tensor<U, decltype(e)::order>(e);
+}
+
+}  // namespace core
+
+#endif  // QUANTIZE_HPP
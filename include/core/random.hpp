@@ -0,0 +1,310 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2022 David Oniani
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef RANDOM_HPP
+#define RANDOM_HPP
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <numbers>
+#include <type_traits>
+
+#include "core.hpp"
+
+namespace builder {
+
+namespace detail {
+
+/**
+ * @brief Elements drawn together from consecutive counters. Chunks handed to threads start at a
+ * multiple of it, so that every element is computed the same way for any number of threads.
+ */
+inline constexpr size_type block = 64;
+
+static_assert(parallel::detail::alignment % block == 0);
+
+/**
+ * @brief The Philox4x32-10 counter-based generator of Salmon et al., which maps a 128-bit counter
+ * and a 64-bit key, i.e. the seed, to four independent 32-bit words. Invoking it for `Count`
+ * consecutive counters at once, one per lane, lets the compiler vectorize the rounds.
+ * @param counter First counter, whose upper 64 bits are zero.
+ * @param seed Key of the generator.
+ * @param words Receives word `idx % 4` of counter `counter + idx / 4` at index `idx`.
+ */
+template <size_type Count>
+void philox(const std::uint64_t counter, const std::uint64_t seed,
+            std::uint32_t (&words)[4 * Count]) noexcept {
+    constexpr std::uint64_t m0 = 0xD2511F53;
+    constexpr std::uint64_t m1 = 0xCD9E8D57;
+    std::uint32_t x0[Count];
+    std::uint32_t x1[Count];
+    std::uint32_t x2[Count];
+    std::uint32_t x3[Count];
+    for (size_type lane = 0; lane < Count; ++lane) {
+        x0[lane] = static_cast<std::uint32_t>(counter + lane);
+        x1[lane] = static_cast<std::uint32_t>((counter + lane) >> 32);
+        x2[lane] = 0;
+        x3[lane] = 0;
+    }
+    auto k0 = static_cast<std::uint32_t>(seed);
+    auto k1 = static_cast<std::uint32_t>(seed >> 32);
+    for (int round = 0; round < 10; ++round) {
+        for (size_type lane = 0; lane < Count; ++lane) {
+            const auto p0 = m0 * x0[lane];
+            const auto p1 = m1 * x2[lane];
+            x0[lane] = static_cast<std::uint32_t>(p1 >> 32) ^ x1[lane] ^ k0;
+            x1[lane] = static_cast<std::uint32_t>(p1);
+            x2[lane] = static_cast<std::uint32_t>(p0 >> 32) ^ x3[lane] ^ k1;
+            x3[lane] = static_cast<std::uint32_t>(p0);
+        }
+        k0 += 0x9E3779B9;
+        k1 += 0xBB67AE85;
+    }
+    for (size_type lane = 0; lane < Count; ++lane) {
+        words[4 * lane] = x0[lane];
+        words[4 * lane + 1] = x1[lane];
+        words[4 * lane + 2] = x2[lane];
+        words[4 * lane + 3] = x3[lane];
+    }
+}
+
+/**
+ * @brief Draws the `block` uniform numbers in [0, 1) of the block starting at element `first`,
+ * from 24 random bits for `float` and 53 for `double`. If `Open` is set, they lie in (0, 1]
+ * instead, so that their logarithm is finite.
+ */
+template <typename U, bool Open = false>
+void uniform_block(const size_type first, const std::uint64_t seed, U (&out)[block]) noexcept {
+    if constexpr (std::is_same_v<U, float>) {
+        std::uint32_t words[block];
+        philox<block / 4>(first / 4, seed, words);
+        for (size_type idx = 0; idx < block; ++idx) {
+            out[idx] = static_cast<float>((words[idx] >> 8) + (Open ? 1 : 0)) * 0x1p-24F;
+        }
+    } else {
+        std::uint32_t words[2 * block];
+        philox<block / 2>(first / 2, seed, words);
+        for (size_type idx = 0; idx < block; ++idx) {
+            const auto bits = (std::uint64_t{words[2 * idx]} << 32 | words[2 * idx + 1]) >> 11;
+            out[idx] = static_cast<double>(bits + (Open ? 1 : 0)) * 0x1p-53;
+        }
+    }
+}
+
+/**
+ * @brief Draws the `block` standard normal numbers of the block starting at element `first` via
+ * the Box-Muller transform, which turns the uniform numbers `u` and `v` at indices `idx` and
+ * `idx + block / 2` into `sqrt(-2 log(u))` times the cosine and the sine of `2 pi v - pi`.
+ */
+template <typename U>
+void normal_block(const size_type first, const std::uint64_t seed, U (&out)[block]) noexcept {
+    U u[block];
+    uniform_block<U, true>(first, seed, u);
+    constexpr auto half = block / 2;
+    constexpr auto two_pi = 2 * std::numbers::pi_v<U>;
+    constexpr auto pi = std::numbers::pi_v<U>;
+    size_type idx = 0;
+    if constexpr (simd::supported<U>) {
+        using P = simd::pack<U>;
+        for (; idx < half; idx += P::width) {
+            const auto radius = simd::sqrt(simd::log(P::load(u + idx)) * P(U{-2}));
+            const auto angle = simd::fma(P::load(u + half + idx), P(two_pi), P(-pi));
+            (radius * simd::cos(angle)).store(out + idx);
+            (radius * simd::sin(angle)).store(out + half + idx);
+        }
+    }
+    for (; idx < half; ++idx) {
+        const auto radius = std::sqrt(U{-2} * std::log(u[idx]));
+        const auto angle = u[half + idx] * two_pi - pi;
+        out[idx] = radius * std::cos(angle);
+        out[half + idx] = radius * std::sin(angle);
+    }
+}
+
+/**
+ * @brief Fills the tensor block by block, in parallel across threads, converting the values drawn
+ * by `draw(first, values)` for the block starting at element `first` to the element type.
+ */
+template <typename U, arithmetic T, size_type Order, typename F>
+void fill_blocks(core::tensor<T, Order>& t, F&& draw) {
+    auto* const data = t.data();
+    const auto size = t.size();
+    parallel::for_each(size, [&](const size_type begin, const size_type end) {
+        U values[block];
+        for (auto first = begin; first < end; first += block) {
+            draw(first, values);
+            const auto count = std::min(block, end - first);
+            for (size_type idx = 0; idx < count; ++idx) {
+                data[first + idx] = static_cast<T>(values[idx]);
+            }
+        }
+    });
+}
+
+/**
+ * @brief Type random numbers are drawn in, `double` for `double` and `float` otherwise.
+ */
+template <typename T>
+using draw_t = std::conditional_t<std::is_same_v<T, double>, double, float>;
+
+template <typename T>
+concept real = std::is_floating_point_v<T> || core::is_half_v<T>;
+
+}  // namespace detail
+
+/**
+ * @brief Constructs a tensor of numbers drawn uniformly between `low` and `high`. Element `idx` is
+ * computed from the counter `idx` of a Philox generator keyed by the seed, so the result only
+ * depends on the seed and the extents, never on the number of threads.
+ * @tparam T Floating-point type representing the type of every element in the returned tensor.
+ * @tparam Order Order of the tensor.
+ * @param extents Extents of the tensor.
+ * @param low Lower bound.
+ * @param high Upper bound, excluded unless rounding reaches it.
+ * @param seed Seed of the generator.
+ * @return A tensor of uniformly distributed numbers.
+ */
+template <detail::real T, size_type Order>
+[[nodiscard]] auto uniform(const array<Order>& extents, const T low = T{0}, const T high = T{1},
+                           const std::uint64_t seed = 0) {
+    using U = detail::draw_t<T>;
+    auto result = core::tensor<T, Order>(extents);
+    const auto offset = static_cast<U>(low);
+    const auto scale = static_cast<U>(high) - offset;
+    detail::fill_blocks<U>(result, [&](const size_type first, U (&values)[detail::block]) {
+        detail::uniform_block(first, seed, values);
+        for (auto& value : values) {
+            value = offset + scale * value;
+        }
+    });
+    return result;
+}
+
+/**
+ * @brief Constructs a tensor of normally distributed numbers, drawn as in `uniform`.
+ * @tparam T Floating-point type representing the type of every element in the returned tensor.
+ * @tparam Order Order of the tensor.
+ * @param extents Extents of the tensor.
+ * @param mean Mean of the distribution.
+ * @param stddev Standard deviation of the distribution.
+ * @param seed Seed of the generator.
+ * @return A tensor of normally distributed numbers.
+ */
+template <detail::real T, size_type Order>
+[[nodiscard]] auto normal(const array<Order>& extents, const T mean = T{0}, const T stddev = T{1},
+                          const std::uint64_t seed = 0) {
+    using U = detail::draw_t<T>;
+    auto result = core::tensor<T, Order>(extents);
+    const auto offset = static_cast<U>(mean);
+    const auto scale = static_cast<U>(stddev);
+    detail::fill_blocks<U>(result, [&](const size_type first, U (&values)[detail::block]) {
+        detail::normal_block(first, seed, values);
+        for (auto& value : values) {
+            value = offset + scale * value;
+        }
+    });
+    return result;
+}
+
+/**
+ * @brief Constructs a tensor of ones with probability `p` and zeros otherwise, drawn as in
+ * `uniform`. Each element compares 32 random bits against `p`.
+ * @tparam T Arithmetic type representing the type of every element in the returned tensor.
+ * @tparam Order Order of the tensor.
+ * @param extents Extents of the tensor.
+ * @param p Probability of a one, clamped to [0, 1].
+ * @param seed Seed of the generator.
+ * @return A tensor of zeros and ones.
+ */
+template <arithmetic T, size_type Order>
+[[nodiscard]] auto bernoulli(const array<Order>& extents, const double p,
+                             const std::uint64_t seed = 0) {
+    auto result = core::tensor<T, Order>(extents);
+    const auto threshold = static_cast<std::uint64_t>(std::clamp(p, 0.0, 1.0) * 0x1p32);
+    detail::fill_blocks<std::uint8_t>(
+        result, [&](const size_type first, std::uint8_t (&values)[detail::block]) {
+            std::uint32_t words[detail::block];
+            detail::philox<detail::block / 4>(first / 4, seed, words);
+            for (size_type idx = 0; idx < detail::block; ++idx) {
+                values[idx] = words[idx] < threshold ? 1 : 0;
+            }
+        });
+    return result;
+}
+
+/**
+ * @brief Constructs a tensor of uniformly distributed numbers with the extents of the provided
+ * tensor, see `uniform`.
+ * @tparam T Floating-point type representing the type of every element in the returned tensor.
+ * @tparam Order Order of the tensor.
+ * @param t Tensor to match the extents against.
+ * @param low Lower bound.
+ * @param high Upper bound.
+ * @param seed Seed of the generator.
+ * @return A tensor of uniformly distributed numbers with the extents of the provided tensor.
+ */
+template <detail::real T, size_type Order>
+[[nodiscard]] auto uniform_like(const core::tensor<T, Order>& t, const T low = T{0},
+                                const T high = T{1}, const std::uint64_t seed = 0) {
+    return uniform<T, Order>(t.extents(), low, high, seed);
+}
+
+/**
+ * @brief Constructs a tensor of normally distributed numbers with the extents of the provided
+ * tensor, see `normal`.
+ * @tparam T Floating-point type representing the type of every element in the returned tensor.
+ * @tparam Order Order of the tensor.
+ * @param t Tensor to match the extents against.
+ * @param mean Mean of the distribution.
+ * @param stddev Standard deviation of the distribution.
+ * @param seed Seed of the generator.
+ * @return A tensor of normally distributed numbers with the extents of the provided tensor.
+ */
+template <detail::real T, size_type Order>
+[[nodiscard]] auto normal_like(const core::tensor<T, Order>& t, const T mean = T{0},
+                               const T stddev = T{1}, const std::uint64_t seed = 0) {
+    return normal<T, Order>(t.extents(), mean, stddev, seed);
+}
+
+/**
+ * @brief Constructs a tensor of zeros and ones with the extents of the provided tensor, see
+ * `bernoulli`.
+ * @tparam T Arithmetic type representing the type of every element in the returned tensor.
+ * @tparam Order Order of the tensor.
+ * @param t Tensor to match the extents against.
+ * @param p Probability of a one.
+ * @param seed Seed of the generator.
+ * @return A tensor of zeros and ones with the extents of the provided tensor.
+ */
+template <arithmetic T, size_type Order>
+[[nodiscard]] auto bernoulli_like(const core::tensor<T, Order>& t, const double p,
+                                  const std::uint64_t seed = 0) {
+    return bernoulli<T, Order>(t.extents(), p, seed);
+}
+
+}  // namespace builder
+
+#endif  // RANDOM_HPP
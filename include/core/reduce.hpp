@@ -0,0 +1,728 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2022 David Oniani
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef REDUCE_HPP
+#define REDUCE_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <cmath>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "view.hpp"
+
+namespace core {
+
+namespace detail {
+
+/**
+ * @brief Type of means, variances and norms, which are computed in double precision for integers
+ * and in single precision for the 16-bit floating-point types.
+ */
+template <typename T>
+using real_t = std::conditional_t<std::is_floating_point_v<compute_t<T> >, compute_t<T>, double>;
+
+/**
+ * @brief Type of sums and products, which are accumulated in 64 bits for integers, signed unless
+ * the type is unsigned, as in NumPy, so that small integer types do not wrap and masks are counted.
+ */
+template <typename T>
+using accumulate_t = std::conditional_t<
+    std::is_floating_point_v<compute_t<T> >, compute_t<T>,
+    std::conditional_t<std::is_unsigned_v<T> && !std::is_same_v<T, bool>, std::uint64_t,
+                       std::int64_t> >;
+
+/**
+ * @brief Associative operations reductions are built from. Each combines either two scalars or two
+ * SIMD packs, starting from `identity`.
+ */
+struct sum_op {
+    template <typename A>
+    [[nodiscard]] static constexpr A identity() noexcept {
+        return A{0};
+    }
+
+    template <typename X>
+    [[nodiscard]] constexpr X operator()(const X a, const X b) const noexcept {
+        return a + b;
+    }
+};
+
+struct prod_op {
+    template <typename A>
+    [[nodiscard]] static constexpr A identity() noexcept {
+        return A{1};
+    }
+
+    template <typename X>
+    [[nodiscard]] constexpr X operator()(const X a, const X b) const noexcept {
+        return a * b;
+    }
+};
+
+// Comparisons keep the left-hand side unless the right-hand side compares less (greater), so NaN
+// never replaces an accumulated value.
+struct min_op {
+    template <typename A>
+    [[nodiscard]] static constexpr A identity() noexcept {
+        if constexpr (std::numeric_limits<A>::has_infinity) {
+            return std::numeric_limits<A>::infinity();
+        } else {
+            return std::numeric_limits<A>::max();
+        }
+    }
+
+    template <typename X>
+    [[nodiscard]] constexpr X operator()(const X a, const X b) const noexcept {
+        if constexpr (arithmetic<X>) {
+            return b < a ? b : a;
+        } else {
+            return simd::min(a, b);
+        }
+    }
+};
+
+struct max_op {
+    template <typename A>
+    [[nodiscard]] static constexpr A identity() noexcept {
+        if constexpr (std::numeric_limits<A>::has_infinity) {
+            return -std::numeric_limits<A>::infinity();
+        } else {
+            return std::numeric_limits<A>::lowest();
+        }
+    }
+
+    template <typename X>
+    [[nodiscard]] constexpr X operator()(const X a, const X b) const noexcept {
+        if constexpr (arithmetic<X>) {
+            return a < b ? b : a;
+        } else {
+            return simd::max(a, b);
+        }
+    }
+};
+
+/**
+ * @brief Transformations applied to every element before it is reduced.
+ */
+struct identity_fn {
+    template <typename X>
+    [[nodiscard]] constexpr X operator()(const X x) const noexcept {
+        return x;
+    }
+};
+
+struct square_fn {
+    template <typename X>
+    [[nodiscard]] constexpr X operator()(const X x) const noexcept {
+        return x * x;
+    }
+};
+
+template <typename A>
+struct deviation_fn {
+    A mean;
+
+    template <typename X>
+    [[nodiscard]] constexpr X operator()(const X x) const noexcept {
+        const auto d = x - X(mean);
+        return d * d;
+    }
+};
+
+template <typename X>
+using expr_t = std::remove_cvref_t<decltype(as_expr(std::declval<const X&>()))>;
+
+/**
+ * @brief Returns the operand as an expression for reductions independent of the order of the
+ * elements, where views are read in the order of memory, see `tensor_view::memory_order`.
+ */
+template <typename X>
+[[nodiscard]] constexpr auto memory_ordered(const X& x) {
+    if constexpr (requires { x.memory_order(); }) {
+        return x.memory_order();
+    } else {
+        return as_expr(x);
+    }
+}
+
+/**
+ * @brief Tensors, views and expressions that can be reduced.
+ */
+template <typename X>
+concept reducible = operand<X> && !arithmetic<X>;
+
+// Ranges up to this many elements are reduced by SIMD accumulators, longer ones are split in
+// halves, so that the rounding error grows with the logarithm of the size.
+inline constexpr size_type leaf_size = 256;
+
+// Number of consecutive elements along the innermost axes reduced by one task.
+inline constexpr size_type column_block = 1024;
+
+template <typename A, typename E>
+inline constexpr bool vectorized_reduction =
+    std::is_same_v<A, compute_t<typename E::value_type> > && E::template vectorizable<A>;
+
+/**
+ * @brief Reduces the transformed elements [begin, end) of the expression by pairwise summation.
+ */
+template <typename A, typename E, typename Op, typename F>
+[[nodiscard]] A reduce_range(const E& expr, const size_type begin, const size_type end,
+                             const Op operation, const F transform) {
+    if (end - begin > leaf_size) {
+        const auto half = ((end - begin) / 2 + 63) / 64 * 64;
+        return operation(reduce_range<A>(expr, begin, begin + half, operation, transform),
+                         reduce_range<A>(expr, begin + half, end, operation, transform));
+    }
+    auto result = Op::template identity<A>();
+    auto idx = begin;
+    if constexpr (vectorized_reduction<A, E>) {
+        using P = simd::pack<A>;
+        constexpr auto width = P::width;
+        P acc[4] = {P(result), P(result), P(result), P(result)};
+        for (; idx + 4 * width <= end; idx += 4 * width) {
+            for (size_type k = 0; k < 4; ++k) {
+                acc[k] =
+                    operation(acc[k], transform(expr.template load<A>(idx + k * width, width)));
+            }
+        }
+        for (; idx + width <= end; idx += width) {
+            acc[0] = operation(acc[0], transform(expr.template load<A>(idx, width)));
+        }
+        result = simd::reduce(operation(operation(acc[0], acc[1]), operation(acc[2], acc[3])),
+                              operation);
+    }
+    for (; idx < end; ++idx) {
+        result = operation(result, transform(static_cast<A>(expr[idx])));
+    }
+    return result;
+}
+
+/**
+ * @brief Combines the partial results of consecutive chunks pairwise.
+ */
+template <typename A, typename Op>
+[[nodiscard]] A combine(const std::pair<size_type, A>* partials, const size_type count,
+                        const Op operation) {
+    if (count == 1) {
+        return partials->second;
+    }
+    const auto half = count / 2;
+    return operation(combine(partials, half, operation),
+                     combine(partials + half, count - half, operation));
+}
+
+/**
+ * @brief Reduces every transformed element of the expression. Chunks are reduced concurrently for
+ * at least `parallel::threshold()` elements, and their partial results are combined in order, so
+ * that the result only depends on the number of threads.
+ */
+template <typename A, typename E, typename Op, typename F>
+[[nodiscard]] A reduce_all(const E& expr, const Op operation, const F transform) {
+    std::vector<std::pair<size_type, A> > partials;
+    std::mutex mutex;
+    parallel::for_each(expr.size(), [&](const size_type begin, const size_type end) {
+        const auto value = reduce_range<A>(expr, begin, end, operation, transform);
+        std::lock_guard lock(mutex);
+        partials.emplace_back(begin, value);
+    });
+    std::sort(partials.begin(), partials.end(),
+              [](const auto& lhs, const auto& rhs) { return lhs.first < rhs.first; });
+    return combine(partials.data(), partials.size(), operation);
+}
+
+/**
+ * @brief Returns the product of the extents before the axis, the extent of the axis and the product
+ * of the extents after it.
+ */
+template <size_type Order>
+[[nodiscard]] constexpr std::array<size_type, 3> split(const array<Order>& extents,
+                                                       const size_type axis) {
+    std::array<size_type, 3> result{1, extents[axis], 1};
+    for (size_type dim = 0; dim < Order; ++dim) {
+        if (dim < axis) {
+            result[0] *= extents[dim];
+        } else if (dim > axis) {
+            result[2] *= extents[dim];
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief Returns the extents without the axis.
+ */
+template <size_type Order>
+[[nodiscard]] constexpr array<Order - 1> reduced_extents(const array<Order>& extents,
+                                                         const size_type axis) {
+    if (axis >= Order) {
+        throw std::out_of_range("Index out of bounds.");
+    }
+    array<Order - 1> result{};
+    for (size_type dim = 0, idx = 0; dim < Order; ++dim) {
+        if (dim != axis) {
+            result[idx++] = extents[dim];
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief Runs the tasks concurrently if they process at least `parallel::threshold()` elements.
+ */
+template <typename F>
+void run_tasks(const size_type count, const size_type work, F&& func) {
+    if (work < parallel::threshold()) {
+        for (size_type idx = 0; idx < count; ++idx) {
+            func(idx);
+        }
+    } else {
+        parallel::for_each_index(count, func);
+    }
+}
+
+/**
+ * @brief Combines `width` transformed elements of the expression starting at `offset` into `dst`,
+ * or copies them if `init` is set.
+ */
+template <typename A, typename E, typename Op, typename F>
+void accumulate(const E& expr, const size_type offset, const size_type width, A* dst,
+                const bool init, const Op operation, const F transform) {
+    size_type idx = 0;
+    if constexpr (vectorized_reduction<A, E>) {
+        using P = simd::pack<A>;
+        for (; idx + P::width <= width; idx += P::width) {
+            const auto x = transform(expr.template load<A>(offset + idx, P::width));
+            (init ? x : operation(P::load(dst + idx), x)).store(dst + idx);
+        }
+    }
+    for (; idx < width; ++idx) {
+        const auto x = transform(static_cast<A>(expr[offset + idx]));
+        dst[idx] = init ? x : operation(dst[idx], x);
+    }
+}
+
+/**
+ * @brief Reduces the rows [first, last) of `width` elements each, where row `a` starts at
+ * `base + a * stride`, into `dst` by pairwise combination. `scratch` holds `width` elements per
+ * level of recursion.
+ */
+template <typename A, typename E, typename Op, typename F>
+void reduce_rows(const E& expr, const size_type base, const size_type stride,
+                 const size_type first, const size_type last, const size_type width, A* dst,
+                 A* scratch, const Op operation, const F transform) {
+    if (last - first > 8) {
+        const auto mid = first + (last - first) / 2;
+        reduce_rows(expr, base, stride, first, mid, width, dst, scratch + width, operation,
+                    transform);
+        reduce_rows(expr, base, stride, mid, last, width, scratch, scratch + width, operation,
+                    transform);
+        size_type idx = 0;
+        if constexpr (simd::supported<A>) {
+            using P = simd::pack<A>;
+            for (; idx + P::width <= width; idx += P::width) {
+                operation(P::load(dst + idx), P::load(scratch + idx)).store(dst + idx);
+            }
+        }
+        for (; idx < width; ++idx) {
+            dst[idx] = operation(dst[idx], scratch[idx]);
+        }
+        return;
+    }
+    for (auto row = first; row < last; ++row) {
+        accumulate(expr, base + row * stride, width, dst, row == first, operation, transform);
+    }
+}
+
+/**
+ * @brief Reduces the transformed elements of the expression along the axis into `dst`, which holds
+ * the elements of the reduced extents in row-major order.
+ */
+template <typename A, typename E, typename Op, typename F>
+void reduce_axis(const E& expr, const size_type axis, A* dst, const Op operation,
+                 const F transform) {
+    const auto [outer, count, inner] = split(expr.extents(), axis);
+    if (count == 0) {
+        std::fill_n(dst, outer * inner, Op::template identity<A>());
+        return;
+    }
+    if (inner == 1) {
+        // Every result is the reduction of a contiguous row, several of which make up a task.
+        const auto rows = std::max<size_type>(1, 4096 / count);
+        run_tasks((outer + rows - 1) / rows, outer * count, [&](const size_type task) {
+            for (auto row = task * rows; row < std::min(outer, (task + 1) * rows); ++row) {
+                dst[row] = reduce_range<A>(expr, row * count, (row + 1) * count, operation,
+                                           transform);
+            }
+        });
+        return;
+    }
+    // Otherwise blocks of the innermost axes are accumulated row by row, which keeps loads
+    // contiguous.
+    size_type levels = 1;
+    for (auto rows = count; rows > 8; rows = (rows + 1) / 2) {
+        ++levels;
+    }
+    const auto blocks = (inner + column_block - 1) / column_block;
+    run_tasks(outer * blocks, outer * count * inner, [&](const size_type task) {
+        const auto idx = task / blocks;
+        const auto first = task % blocks * column_block;
+        const auto width = std::min(column_block, inner - first);
+        auto* scratch = kernel::scratch<A>(width * levels);
+        reduce_rows(expr, idx * count * inner + first, inner, 0, count, width,
+                    dst + idx * inner + first, scratch, operation, transform);
+    });
+}
+
+/**
+ * @brief Returns the index of the first maximum among the elements [begin, end) relative to
+ * `begin`, ignoring NaN.
+ */
+template <typename E>
+[[nodiscard]] size_type argmax_range(const E& expr, const size_type begin, const size_type end) {
+    using T = compute_t<typename E::value_type>;
+    const auto best = reduce_range<T>(expr, begin, end, max_op{}, identity_fn{});
+    for (auto idx = begin; idx < end; ++idx) {
+        if (expr[idx] == best) {
+            return idx - begin;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Throws if an empty range is to be reduced via an operation without identity.
+ */
+inline void require_elements(const size_type count) {
+    if (count == 0) {
+        throw std::domain_error("Reduction of an empty tensor.");
+    }
+}
+
+/**
+ * @brief Reduces along the axis into a new tensor of the reduced extents.
+ */
+template <typename A, typename X, typename Op, typename F>
+[[nodiscard]] auto reduce(const X& x, const size_type axis, const Op operation,
+                          const F transform) {
+    const auto e = as_expr(x);
+    constexpr auto Order = expr_t<X>::order;
+    auto result = tensor<A, Order - 1>(reduced_extents(e.extents(), axis));
+    reduce_axis<A>(e, axis, result.data(), operation, transform);
+    return result;
+}
+
+}  // namespace detail
+
+/**
+ * @brief Sums every element of a tensor, view or expression. Floating-point values are summed
+ * pairwise by SIMD accumulators, so that the rounding error grows logarithmically with the size.
+ * Like every reduction, values of the 16-bit floating-point types are accumulated and returned in
+ * single precision, while integers and booleans are accumulated and returned as 64-bit integers.
+ * Reductions of every element read views in the order of memory.
+ * @param x Tensor, view or expression.
+ * @return The sum.
+ */
+template <detail::reducible X>
+[[nodiscard]] auto sum(const X& x) {
+    using T = detail::accumulate_t<typename detail::expr_t<X>::value_type>;
+    return detail::reduce_all<T>(detail::memory_ordered(x), detail::sum_op{},
+                                 detail::identity_fn{});
+}
+
+/**
+ * @brief Sums the elements along the axis.
+ * @param x Tensor, view or expression.
+ * @param axis Axis to reduce.
+ * @return A tensor of one order less holding the sums.
+ */
+template <detail::reducible X>
+    requires(detail::expr_t<X>::order > 0)
+[[nodiscard]] auto sum(const X& x, const size_type axis) {
+    using T = detail::accumulate_t<typename detail::expr_t<X>::value_type>;
+    return detail::reduce<T>(x, axis, detail::sum_op{}, detail::identity_fn{});
+}
+
+/**
+ * @brief Multiplies every element of a tensor, view or expression, accumulating as `sum` does.
+ * @param x Tensor, view or expression.
+ * @return The product.
+ */
+template <detail::reducible X>
+[[nodiscard]] auto prod(const X& x) {
+    using T = detail::accumulate_t<typename detail::expr_t<X>::value_type>;
+    return detail::reduce_all<T>(detail::memory_ordered(x), detail::prod_op{},
+                                 detail::identity_fn{});
+}
+
+/**
+ * @brief Multiplies the elements along the axis.
+ * @param x Tensor, view or expression.
+ * @param axis Axis to reduce.
+ * @return A tensor of one order less holding the products.
+ */
+template <detail::reducible X>
+    requires(detail::expr_t<X>::order > 0)
+[[nodiscard]] auto prod(const X& x, const size_type axis) {
+    using T = detail::accumulate_t<typename detail::expr_t<X>::value_type>;
+    return detail::reduce<T>(x, axis, detail::prod_op{}, detail::identity_fn{});
+}
+
+/**
+ * @brief Returns the arithmetic mean, computed in double precision for integers.
+ * @param x Tensor, view or expression.
+ * @return The mean, NaN if there are no elements.
+ */
+template <detail::reducible X>
+[[nodiscard]] auto mean(const X& x) {
+    using R = detail::real_t<typename detail::expr_t<X>::value_type>;
+    const auto e = detail::memory_ordered(x);
+    return detail::reduce_all<R>(e, detail::sum_op{}, detail::identity_fn{}) /
+           static_cast<R>(e.size());
+}
+
+/**
+ * @brief Returns the arithmetic means along the axis, computed in double precision for integers.
+ * @param x Tensor, view or expression.
+ * @param axis Axis to reduce.
+ * @return A tensor of one order less holding the means, NaN if the axis is empty.
+ */
+template <detail::reducible X>
+    requires(detail::expr_t<X>::order > 0)
+[[nodiscard]] auto mean(const X& x, const size_type axis) {
+    using R = detail::real_t<typename detail::expr_t<X>::value_type>;
+    auto result = detail::reduce<R>(x, axis, detail::sum_op{}, detail::identity_fn{});
+    const auto count = detail::as_expr(x).extents()[axis];
+    if (count == 0) {
+        kernel::fill(result.data(), result.size(), std::numeric_limits<R>::quiet_NaN());
+    } else {
+        result /= static_cast<R>(count);
+    }
+    return result;
+}
+
+/**
+ * @brief Returns the smallest element, ignoring NaN.
+ * @param x Tensor, view or expression holding at least one element.
+ * @return The minimum.
+ */
+template <detail::reducible X>
+[[nodiscard]] auto min(const X& x) {
+    using T = compute_t<typename detail::expr_t<X>::value_type>;
+    const auto e = detail::memory_ordered(x);
+    detail::require_elements(e.size());
+    return detail::reduce_all<T>(e, detail::min_op{}, detail::identity_fn{});
+}
+
+/**
+ * @brief Returns the smallest elements along the axis, ignoring NaN.
+ * @param x Tensor, view or expression with a non-empty axis.
+ * @param axis Axis to reduce.
+ * @return A tensor of one order less holding the minima.
+ */
+template <detail::reducible X>
+    requires(detail::expr_t<X>::order > 0)
+[[nodiscard]] auto min(const X& x, const size_type axis) {
+    using T = compute_t<typename detail::expr_t<X>::value_type>;
+    auto result = detail::reduce<T>(x, axis, detail::min_op{}, detail::identity_fn{});
+    detail::require_elements(result.size() == 0 ? 1 : detail::as_expr(x).extents()[axis]);
+    return result;
+}
+
+/**
+ * @brief Returns the largest element, ignoring NaN.
+ * @param x Tensor, view or expression holding at least one element.
+ * @return The maximum.
+ */
+template <detail::reducible X>
+[[nodiscard]] auto max(const X& x) {
+    using T = compute_t<typename detail::expr_t<X>::value_type>;
+    const auto e = detail::memory_ordered(x);
+    detail::require_elements(e.size());
+    return detail::reduce_all<T>(e, detail::max_op{}, detail::identity_fn{});
+}
+
+/**
+ * @brief Returns the largest elements along the axis, ignoring NaN.
+ * @param x Tensor, view or expression with a non-empty axis.
+ * @param axis Axis to reduce.
+ * @return A tensor of one order less holding the maxima.
+ */
+template <detail::reducible X>
+    requires(detail::expr_t<X>::order > 0)
+[[nodiscard]] auto max(const X& x, const size_type axis) {
+    using T = compute_t<typename detail::expr_t<X>::value_type>;
+    auto result = detail::reduce<T>(x, axis, detail::max_op{}, detail::identity_fn{});
+    detail::require_elements(result.size() == 0 ? 1 : detail::as_expr(x).extents()[axis]);
+    return result;
+}
+
+/**
+ * @brief Returns the row-major index of the first largest element, ignoring NaN.
+ * @param x Tensor, view or expression holding at least one element.
+ * @return The index of the maximum.
+ */
+template <detail::reducible X>
+[[nodiscard]] size_type argmax(const X& x) {
+    using T = compute_t<typename detail::expr_t<X>::value_type>;
+    const auto e = detail::as_expr(x);
+    detail::require_elements(e.size());
+    const auto best = detail::reduce_all<T>(e, detail::max_op{}, detail::identity_fn{});
+    for (size_type idx = 0; idx < e.size(); ++idx) {
+        if (e[idx] == best) {
+            return idx;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Returns the indices of the first largest elements along the axis, ignoring NaN.
+ * @param x Tensor, view or expression with a non-empty axis.
+ * @param axis Axis to reduce.
+ * @return A tensor of one order less holding the indices along the axis.
+ */
+template <detail::reducible X>
+    requires(detail::expr_t<X>::order > 0)
+[[nodiscard]] auto argmax(const X& x, const size_type axis) {
+    using T = compute_t<typename detail::expr_t<X>::value_type>;
+    constexpr auto Order = detail::expr_t<X>::order;
+    const auto e = detail::as_expr(x);
+    auto result = tensor<size_type, Order - 1>(detail::reduced_extents(e.extents(), axis));
+    const auto [outer, count, inner] = detail::split(e.extents(), axis);
+    detail::require_elements(result.size() == 0 ? 1 : count);
+    auto* dst = result.data();
+
+    if (inner == 1) {
+        const auto rows = std::max<size_type>(1, 4096 / count);
+        detail::run_tasks((outer + rows - 1) / rows, outer * count, [&](const size_type task) {
+            for (auto row = task * rows; row < std::min(outer, (task + 1) * rows); ++row) {
+                dst[row] = detail::argmax_range(e, row * count, (row + 1) * count);
+            }
+        });
+        return result;
+    }
+    const auto blocks = (inner + detail::column_block - 1) / detail::column_block;
+    detail::run_tasks(outer * blocks, outer * count * inner, [&](const size_type task) {
+        const auto idx = task / blocks;
+        const auto first = task % blocks * detail::column_block;
+        const auto width = std::min(detail::column_block, inner - first);
+        auto* best = kernel::scratch<T>(width);
+        auto* index = dst + idx * inner + first;
+        for (size_type row = 0; row < count; ++row) {
+            const auto offset = (idx * count + row) * inner + first;
+            for (size_type col = 0; col < width; ++col) {
+                const auto value = static_cast<T>(e[offset + col]);
+                // NaN is only kept as long as no number follows.
+                if (row == 0 || best[col] < value || (best[col] != best[col] && value == value)) {
+                    best[col] = value;
+                    index[col] = row;
+                }
+            }
+        }
+    });
+    return result;
+}
+
+/**
+ * @brief Returns the Euclidean norm, computed in double precision for integers.
+ * @param x Tensor, view or expression.
+ * @return The square root of the sum of squares.
+ */
+template <detail::reducible X>
+[[nodiscard]] auto norm(const X& x) {
+    using R = detail::real_t<typename detail::expr_t<X>::value_type>;
+    return std::sqrt(
+        detail::reduce_all<R>(detail::memory_ordered(x), detail::sum_op{}, detail::square_fn{}));
+}
+
+/**
+ * @brief Returns the Euclidean norms along the axis, computed in double precision for integers.
+ * @param x Tensor, view or expression.
+ * @param axis Axis to reduce.
+ * @return A tensor of one order less holding the norms.
+ */
+template <detail::reducible X>
+    requires(detail::expr_t<X>::order > 0)
+[[nodiscard]] auto norm(const X& x, const size_type axis) {
+    using R = detail::real_t<typename detail::expr_t<X>::value_type>;
+    auto result = detail::reduce<R>(x, axis, detail::sum_op{}, detail::square_fn{});
+    kernel::transform(result.data(), result.data(), result.size(), op::sqrt{});
+    return result;
+}
+
+/**
+ * @brief Returns the population variance via two passes, the first computing the mean, computed in
+ * double precision for integers.
+ * @param x Tensor, view or expression.
+ * @return The mean of the squared deviations from the mean, NaN if there are no elements.
+ */
+template <detail::reducible X>
+[[nodiscard]] auto var(const X& x) {
+    using R = detail::real_t<typename detail::expr_t<X>::value_type>;
+    const auto e = detail::memory_ordered(x);
+    const detail::deviation_fn<R> deviation{mean(x)};
+    return detail::reduce_all<R>(e, detail::sum_op{}, deviation) / static_cast<R>(e.size());
+}
+
+/**
+ * @brief Returns the population variances along the axis via two passes, computed in double
+ * precision for integers.
+ * @param x Tensor, view or expression.
+ * @param axis Axis to reduce.
+ * @return A tensor of one order less holding the variances, NaN if the axis is empty.
+ */
+template <detail::reducible X>
+    requires(detail::expr_t<X>::order > 0)
+[[nodiscard]] auto var(const X& x, const size_type axis) {
+    using T = compute_t<typename detail::expr_t<X>::value_type>;
+    using R = detail::real_t<T>;
+    constexpr auto Order = detail::expr_t<X>::order;
+    const auto e = detail::as_expr(x);
+
+    if constexpr (!std::is_same_v<T, R>) {
+        auto converted = tensor<R, Order>(e.extents());
+        for (size_type idx = 0; idx < e.size(); ++idx) {
+            converted[idx] = static_cast<R>(e[idx]);
+        }
+        return var(converted, axis);
+    } else {
+        // The means are broadcast back along the reduced axis, which gets extent one.
+        const auto means = mean(e, axis);
+        auto extents = e.extents();
+        extents[axis] = 1;
+        const auto centered = tensor_view<const R, Order>(means.data(), extents,
+                                                          detail::row_major_strides(extents));
+        return mean((e - centered).square(), axis);
+    }
+}
+
+}  // namespace core
+
+#endif  // REDUCE_HPP
@@ -0,0 +1,1815 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2022 David Oniani
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef SIMD_HPP
+#define SIMD_HPP
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+#include "half.hpp"
+
+#if defined(__AVX512F__)
+#include <immintrin.h>
+#define TENSOR_SIMD_AVX512 1
+#elif defined(__AVX__)
+#include <immintrin.h>
+#define TENSOR_SIMD_AVX 1
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#if defined(__SSE4_1__)
+#include <smmintrin.h>
+#endif
+#define TENSOR_SIMD_SSE 1
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define TENSOR_SIMD_NEON 1
+#endif
+
+/**
+ * Enables the vectorized polynomial approximations of the transcendental functions. These are not
+ * correctly rounded, hence they are opt-in. Within the reduction range, i.e. |x| < 8192 for `float`
+ * (|x| < 64 on targets without FMA) and |x| < 1e9 for `double`, `sin` and `cos` stay within 2 ULP
+ * and `tan` within 4 ULP of the correctly rounded result. Larger or non-finite arguments are passed
+ * to the `std::` functions. `exp`, `log` and `tanh` stay within 2 ULP wherever their arguments and
+ * results are normal, the others being passed to the `std::` functions as well. Integral exponents
+ * of `pow` are evaluated via repeated squaring, adding up to 1 ULP per multiplication.
+ */
+#ifndef TENSOR_FAST_MATH
+#define TENSOR_FAST_MATH 0
+#endif
+
+/**
+ * @brief Defines thin wrappers around the native vector registers of the target. The instruction
+ * set is chosen at compile time, i.e. AVX-512, AVX, SSE2 or NEON, depending on the flags the code
+ * is compiled with. Types without a specialization are processed by scalar loops. Comparing packs
+ * yields masks, which `any` and `all` reduce and `bits` packs into an integer, one bit per lane.
+ */
+namespace simd {
+
+template <typename T>
+struct pack;
+
+template <typename T>
+struct mask;
+
+/**
+ * @brief Specifies a type having a native vector register on the target.
+ */
+template <typename T>
+concept supported = requires { pack<T>::width; };
+
+/**
+ * @brief Specifies a pack, as opposed to a scalar.
+ */
+template <typename P>
+concept vector =
+    supported<typename P::value_type> && std::is_same_v<P, pack<typename P::value_type> >;
+
+/**
+ * @brief Returns the scalar as is, which allows generic code to test both scalars and masks.
+ */
+[[nodiscard]] constexpr bool any(const bool m) noexcept {
+    return m;
+}
+
+#if defined(TENSOR_SIMD_AVX) || defined(TENSOR_SIMD_SSE)
+
+namespace detail {
+
+// Conversions of four lanes shared by AVX and SSE, which lack the conversions of AVX-512.
+
+// Rounds to bfloat16, ties to even, returning the bits sign-extended to 32 bits.
+inline __m128i round_bfloat16(const __m128 x) noexcept {
+    const auto bits = _mm_castps_si128(x);
+    const auto lsb = _mm_and_si128(_mm_srli_epi32(bits, 16), _mm_set1_epi32(1));
+    const auto bias = _mm_add_epi32(lsb, _mm_set1_epi32(0x7FFF));
+    const auto rounded = _mm_srai_epi32(_mm_add_epi32(bits, bias), 16);
+    const auto nan = _mm_castps_si128(_mm_cmpunord_ps(x, x));
+    const auto quiet = _mm_or_si128(_mm_srai_epi32(bits, 16), _mm_set1_epi32(0x40));
+    return _mm_or_si128(_mm_and_si128(nan, quiet), _mm_andnot_si128(nan, rounded));
+}
+
+// Converts the four bytes of the word, in memory order.
+inline __m128 widen_int8(const std::int32_t word) noexcept {
+    auto x = _mm_cvtsi32_si128(word);
+    x = _mm_unpacklo_epi8(x, x);
+    x = _mm_unpacklo_epi16(x, x);
+    return _mm_cvtepi32_ps(_mm_srai_epi32(x, 24));
+}
+
+// Rounds to the nearest integer within the range of `std::int8_t`, returned as 32 bits.
+inline __m128i round_int8(const __m128 x) noexcept {
+    const auto clamped = _mm_min_ps(_mm_max_ps(x, _mm_set1_ps(-128.0F)), _mm_set1_ps(127.0F));
+    return _mm_cvtps_epi32(clamped);
+}
+
+}  // namespace detail
+
+#endif
+
+#if defined(TENSOR_SIMD_AVX512)
+
+inline constexpr bool has_fma = true;
+
+namespace detail {
+
+// Masks enabling every lane. Unmasked AVX-512 intrinsics merge into an undefined register, which
+// GCC reports as used uninitialized, hence the zero-masked forms are used with these instead.
+inline constexpr __mmask16 lanes16 = 0xFFFF;
+inline constexpr __mmask8 lanes8 = 0xFF;
+
+}  // namespace detail
+
+template <>
+struct mask<float> {
+    __mmask16 m;
+
+    friend mask operator&(const mask a, const mask b) noexcept {
+        return {static_cast<__mmask16>(a.m & b.m)};
+    }
+    friend mask operator|(const mask a, const mask b) noexcept {
+        return {static_cast<__mmask16>(a.m | b.m)};
+    }
+};
+
+template <>
+struct pack<float> {
+    using value_type = float;
+    static constexpr std::size_t width = 16;
+
+    __m512 v;
+
+    pack() noexcept = default;
+    pack(const __m512 r) noexcept : v{r} {}
+    pack(const float x) noexcept : v{_mm512_set1_ps(x)} {}
+
+    static pack load(const float* p) noexcept {
+        return _mm512_loadu_ps(p);
+    }
+    static pack load_strided(const float* p, const std::size_t stride) noexcept {
+        const auto s = stride;
+        return _mm512_set_ps(p[15 * s], p[14 * s], p[13 * s], p[12 * s], p[11 * s], p[10 * s],
+                             p[9 * s], p[8 * s], p[7 * s], p[6 * s], p[5 * s], p[4 * s], p[3 * s],
+                             p[2 * s], p[s], p[0]);
+    }
+    void store(float* p) const noexcept {
+        _mm512_storeu_ps(p, v);
+    }
+
+    friend pack operator+(const pack a, const pack b) noexcept {
+        return _mm512_add_ps(a.v, b.v);
+    }
+    friend pack operator-(const pack a, const pack b) noexcept {
+        return _mm512_sub_ps(a.v, b.v);
+    }
+    friend pack operator*(const pack a, const pack b) noexcept {
+        return _mm512_mul_ps(a.v, b.v);
+    }
+    friend pack operator/(const pack a, const pack b) noexcept {
+        return _mm512_div_ps(a.v, b.v);
+    }
+    friend pack operator-(const pack a) noexcept {
+        return _mm512_castsi512_ps(
+            _mm512_xor_si512(_mm512_castps_si512(a.v), _mm512_set1_epi32(INT32_MIN)));
+    }
+
+    friend mask<float> operator==(const pack a, const pack b) noexcept {
+        return {_mm512_cmp_ps_mask(a.v, b.v, _CMP_EQ_OQ)};
+    }
+    friend mask<float> operator!=(const pack a, const pack b) noexcept {
+        return {_mm512_cmp_ps_mask(a.v, b.v, _CMP_NEQ_UQ)};
+    }
+    friend mask<float> operator<(const pack a, const pack b) noexcept {
+        return {_mm512_cmp_ps_mask(a.v, b.v, _CMP_LT_OQ)};
+    }
+    friend mask<float> operator<=(const pack a, const pack b) noexcept {
+        return {_mm512_cmp_ps_mask(a.v, b.v, _CMP_LE_OQ)};
+    }
+    friend mask<float> operator>(const pack a, const pack b) noexcept {
+        return {_mm512_cmp_ps_mask(a.v, b.v, _CMP_GT_OQ)};
+    }
+    friend mask<float> operator>=(const pack a, const pack b) noexcept {
+        return {_mm512_cmp_ps_mask(a.v, b.v, _CMP_GE_OQ)};
+    }
+};
+
+inline bool any(const mask<float> m) noexcept {
+    return m.m != 0;
+}
+inline bool all(const mask<float> m) noexcept {
+    return m.m == 0xFFFF;
+}
+inline unsigned bits(const mask<float> m) noexcept {
+    return m.m;
+}
+inline pack<float> select(const mask<float> m, const pack<float> a, const pack<float> b) noexcept {
+    return _mm512_mask_blend_ps(m.m, b.v, a.v);
+}
+inline pack<float> fma(const pack<float> a, const pack<float> b, const pack<float> c) noexcept {
+    return _mm512_fmadd_ps(a.v, b.v, c.v);
+}
+inline pack<float> sqrt(const pack<float> a) noexcept {
+    return _mm512_maskz_sqrt_ps(detail::lanes16, a.v);
+}
+inline pack<float> abs(const pack<float> a) noexcept {
+    return _mm512_abs_ps(a.v);
+}
+inline pack<float> trunc(const pack<float> a) noexcept {
+    return _mm512_maskz_roundscale_ps(detail::lanes16, a.v, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+}
+inline pack<float> nearbyint(const pack<float> a) noexcept {
+    return _mm512_maskz_roundscale_ps(detail::lanes16, a.v,
+                                      _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+}
+inline pack<float> ldexp(const pack<float> a, const pack<float> n) noexcept {
+    return _mm512_maskz_scalef_ps(detail::lanes16, a.v, n.v);
+}
+inline pack<float> logb(const pack<float> a) noexcept {
+    return _mm512_maskz_getexp_ps(detail::lanes16, a.v);
+}
+
+template <>
+struct mask<double> {
+    __mmask8 m;
+
+    friend mask operator&(const mask a, const mask b) noexcept {
+        return {static_cast<__mmask8>(a.m & b.m)};
+    }
+    friend mask operator|(const mask a, const mask b) noexcept {
+        return {static_cast<__mmask8>(a.m | b.m)};
+    }
+};
+
+template <>
+struct pack<double> {
+    using value_type = double;
+    static constexpr std::size_t width = 8;
+
+    __m512d v;
+
+    pack() noexcept = default;
+    pack(const __m512d r) noexcept : v{r} {}
+    pack(const double x) noexcept : v{_mm512_set1_pd(x)} {}
+
+    static pack load(const double* p) noexcept {
+        return _mm512_loadu_pd(p);
+    }
+    static pack load_strided(const double* p, const std::size_t stride) noexcept {
+        const auto s = stride;
+        return _mm512_set_pd(p[7 * s], p[6 * s], p[5 * s], p[4 * s], p[3 * s], p[2 * s], p[s],
+                             p[0]);
+    }
+    void store(double* p) const noexcept {
+        _mm512_storeu_pd(p, v);
+    }
+
+    friend pack operator+(const pack a, const pack b) noexcept {
+        return _mm512_add_pd(a.v, b.v);
+    }
+    friend pack operator-(const pack a, const pack b) noexcept {
+        return _mm512_sub_pd(a.v, b.v);
+    }
+    friend pack operator*(const pack a, const pack b) noexcept {
+        return _mm512_mul_pd(a.v, b.v);
+    }
+    friend pack operator/(const pack a, const pack b) noexcept {
+        return _mm512_div_pd(a.v, b.v);
+    }
+    friend pack operator-(const pack a) noexcept {
+        return _mm512_castsi512_pd(
+            _mm512_xor_si512(_mm512_castpd_si512(a.v), _mm512_set1_epi64(INT64_MIN)));
+    }
+
+    friend mask<double> operator==(const pack a, const pack b) noexcept {
+        return {_mm512_cmp_pd_mask(a.v, b.v, _CMP_EQ_OQ)};
+    }
+    friend mask<double> operator!=(const pack a, const pack b) noexcept {
+        return {_mm512_cmp_pd_mask(a.v, b.v, _CMP_NEQ_UQ)};
+    }
+    friend mask<double> operator<(const pack a, const pack b) noexcept {
+        return {_mm512_cmp_pd_mask(a.v, b.v, _CMP_LT_OQ)};
+    }
+    friend mask<double> operator<=(const pack a, const pack b) noexcept {
+        return {_mm512_cmp_pd_mask(a.v, b.v, _CMP_LE_OQ)};
+    }
+    friend mask<double> operator>(const pack a, const pack b) noexcept {
+        return {_mm512_cmp_pd_mask(a.v, b.v, _CMP_GT_OQ)};
+    }
+    friend mask<double> operator>=(const pack a, const pack b) noexcept {
+        return {_mm512_cmp_pd_mask(a.v, b.v, _CMP_GE_OQ)};
+    }
+};
+
+inline bool any(const mask<double> m) noexcept {
+    return m.m != 0;
+}
+inline bool all(const mask<double> m) noexcept {
+    return m.m == 0xFF;
+}
+inline unsigned bits(const mask<double> m) noexcept {
+    return m.m;
+}
+inline pack<double> select(const mask<double> m, const pack<double> a,
+                           const pack<double> b) noexcept {
+    return _mm512_mask_blend_pd(m.m, b.v, a.v);
+}
+inline pack<double> fma(const pack<double> a, const pack<double> b,
+                        const pack<double> c) noexcept {
+    return _mm512_fmadd_pd(a.v, b.v, c.v);
+}
+inline pack<double> sqrt(const pack<double> a) noexcept {
+    return _mm512_maskz_sqrt_pd(detail::lanes8, a.v);
+}
+inline pack<double> abs(const pack<double> a) noexcept {
+    return _mm512_abs_pd(a.v);
+}
+inline pack<double> trunc(const pack<double> a) noexcept {
+    return _mm512_maskz_roundscale_pd(detail::lanes8, a.v, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+}
+inline pack<double> nearbyint(const pack<double> a) noexcept {
+    return _mm512_maskz_roundscale_pd(detail::lanes8, a.v,
+                                      _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+}
+inline pack<double> ldexp(const pack<double> a, const pack<double> n) noexcept {
+    return _mm512_maskz_scalef_pd(detail::lanes8, a.v, n.v);
+}
+inline pack<double> logb(const pack<double> a) noexcept {
+    return _mm512_maskz_getexp_pd(detail::lanes8, a.v);
+}
+
+inline pack<float> widen(const core::float16* p) noexcept {
+    const auto h = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+    return _mm512_maskz_cvtph_ps(detail::lanes16, h);
+}
+inline void narrow(core::float16* p, const pack<float> x) noexcept {
+    const auto h =
+        _mm512_maskz_cvtps_ph(detail::lanes16, x.v, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), h);
+}
+inline pack<float> widen(const core::bfloat16* p) noexcept {
+    const auto bits = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+    const auto h = _mm512_maskz_cvtepu16_epi32(detail::lanes16, bits);
+    return _mm512_castsi512_ps(_mm512_maskz_slli_epi32(detail::lanes16, h, 16));
+}
+inline void narrow(core::bfloat16* p, const pack<float> x) noexcept {
+    const auto bits = _mm512_castps_si512(x.v);
+    const auto high = _mm512_maskz_srli_epi32(detail::lanes16, bits, 16);
+    const auto bias = _mm512_add_epi32(_mm512_and_si512(high, _mm512_set1_epi32(1)),
+                                       _mm512_set1_epi32(0x7FFF));
+    const auto rounded = _mm512_maskz_srli_epi32(detail::lanes16, _mm512_add_epi32(bits, bias), 16);
+    const auto nan = _mm512_cmp_ps_mask(x.v, x.v, _CMP_UNORD_Q);
+    const auto quiet = _mm512_or_si512(high, _mm512_set1_epi32(0x40));
+    const auto h = _mm512_mask_mov_epi32(rounded, nan, quiet);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(p),
+                        _mm512_maskz_cvtepi32_epi16(detail::lanes16, h));
+}
+inline pack<float> widen(const std::int8_t* p) noexcept {
+    const auto b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    return _mm512_maskz_cvtepi32_ps(detail::lanes16,
+                                    _mm512_maskz_cvtepi8_epi32(detail::lanes16, b));
+}
+inline void narrow(std::int8_t* p, const pack<float> x) noexcept {
+    const auto low = _mm512_maskz_max_ps(detail::lanes16, x.v, _mm512_set1_ps(-128.0F));
+    const auto clamped = _mm512_maskz_min_ps(detail::lanes16, low, _mm512_set1_ps(127.0F));
+    const auto rounded = _mm512_maskz_cvtps_epi32(detail::lanes16, clamped);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(p),
+                     _mm512_maskz_cvtsepi32_epi8(detail::lanes16, rounded));
+}
+
+#elif defined(TENSOR_SIMD_AVX)
+
+#if defined(__FMA__)
+inline constexpr bool has_fma = true;
+#else
+inline constexpr bool has_fma = false;
+#endif
+
+template <>
+struct mask<float> {
+    __m256 m;
+
+    friend mask operator&(const mask a, const mask b) noexcept {
+        return {_mm256_and_ps(a.m, b.m)};
+    }
+    friend mask operator|(const mask a, const mask b) noexcept {
+        return {_mm256_or_ps(a.m, b.m)};
+    }
+};
+
+template <>
+struct pack<float> {
+    using value_type = float;
+    static constexpr std::size_t width = 8;
+
+    __m256 v;
+
+    pack() noexcept = default;
+    pack(const __m256 r) noexcept : v{r} {}
+    pack(const float x) noexcept : v{_mm256_set1_ps(x)} {}
+
+    static pack load(const float* p) noexcept {
+        return _mm256_loadu_ps(p);
+    }
+    static pack load_strided(const float* p, const std::size_t stride) noexcept {
+        const auto s = stride;
+        return _mm256_set_ps(p[7 * s], p[6 * s], p[5 * s], p[4 * s], p[3 * s], p[2 * s], p[s],
+                             p[0]);
+    }
+    void store(float* p) const noexcept {
+        _mm256_storeu_ps(p, v);
+    }
+
+    friend pack operator+(const pack a, const pack b) noexcept {
+        return _mm256_add_ps(a.v, b.v);
+    }
+    friend pack operator-(const pack a, const pack b) noexcept {
+        return _mm256_sub_ps(a.v, b.v);
+    }
+    friend pack operator*(const pack a, const pack b) noexcept {
+        return _mm256_mul_ps(a.v, b.v);
+    }
+    friend pack operator/(const pack a, const pack b) noexcept {
+        return _mm256_div_ps(a.v, b.v);
+    }
+    friend pack operator-(const pack a) noexcept {
+        return _mm256_xor_ps(a.v, _mm256_set1_ps(-0.0F));
+    }
+
+    friend mask<float> operator==(const pack a, const pack b) noexcept {
+        return {_mm256_cmp_ps(a.v, b.v, _CMP_EQ_OQ)};
+    }
+    friend mask<float> operator!=(const pack a, const pack b) noexcept {
+        return {_mm256_cmp_ps(a.v, b.v, _CMP_NEQ_UQ)};
+    }
+    friend mask<float> operator<(const pack a, const pack b) noexcept {
+        return {_mm256_cmp_ps(a.v, b.v, _CMP_LT_OQ)};
+    }
+    friend mask<float> operator<=(const pack a, const pack b) noexcept {
+        return {_mm256_cmp_ps(a.v, b.v, _CMP_LE_OQ)};
+    }
+    friend mask<float> operator>(const pack a, const pack b) noexcept {
+        return {_mm256_cmp_ps(a.v, b.v, _CMP_GT_OQ)};
+    }
+    friend mask<float> operator>=(const pack a, const pack b) noexcept {
+        return {_mm256_cmp_ps(a.v, b.v, _CMP_GE_OQ)};
+    }
+};
+
+inline bool any(const mask<float> m) noexcept {
+    return _mm256_movemask_ps(m.m) != 0;
+}
+inline bool all(const mask<float> m) noexcept {
+    return _mm256_movemask_ps(m.m) == 0xFF;
+}
+inline unsigned bits(const mask<float> m) noexcept {
+    return static_cast<unsigned>(_mm256_movemask_ps(m.m));
+}
+inline pack<float> select(const mask<float> m, const pack<float> a, const pack<float> b) noexcept {
+#if defined(__AVX2__)
+    return _mm256_blendv_ps(b.v, a.v, m.m);
+#else
+    // Without AVX2 the compiler scalarizes blends it can fold, the bitwise form stays in registers.
+    return _mm256_or_ps(_mm256_and_ps(m.m, a.v), _mm256_andnot_ps(m.m, b.v));
+#endif
+}
+inline pack<float> fma(const pack<float> a, const pack<float> b, const pack<float> c) noexcept {
+#if defined(__FMA__)
+    return _mm256_fmadd_ps(a.v, b.v, c.v);
+#else
+    return _mm256_add_ps(_mm256_mul_ps(a.v, b.v), c.v);
+#endif
+}
+inline pack<float> sqrt(const pack<float> a) noexcept {
+    return _mm256_sqrt_ps(a.v);
+}
+inline pack<float> abs(const pack<float> a) noexcept {
+    return _mm256_andnot_ps(_mm256_set1_ps(-0.0F), a.v);
+}
+inline pack<float> trunc(const pack<float> a) noexcept {
+    return _mm256_round_ps(a.v, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+}
+inline pack<float> nearbyint(const pack<float> a) noexcept {
+    return _mm256_round_ps(a.v, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+}
+inline pack<float> ldexp(const pack<float> a, const pack<float> n) noexcept {
+    const auto e = _mm256_cvtps_epi32(n.v);
+#if defined(__AVX2__)
+    const auto p = _mm256_slli_epi32(_mm256_add_epi32(e, _mm256_set1_epi32(127)), 23);
+#else
+    const auto bias = _mm_set1_epi32(127);
+    const auto lo = _mm_slli_epi32(_mm_add_epi32(_mm256_castsi256_si128(e), bias), 23);
+    const auto hi = _mm_slli_epi32(_mm_add_epi32(_mm256_extractf128_si256(e, 1), bias), 23);
+    const auto p = _mm256_set_m128i(hi, lo);
+#endif
+    return _mm256_mul_ps(a.v, _mm256_castsi256_ps(p));
+}
+inline pack<float> logb(const pack<float> a) noexcept {
+    const auto bits = _mm256_castps_si256(a.v);
+#if defined(__AVX2__)
+    const auto e = _mm256_sub_epi32(_mm256_srli_epi32(bits, 23), _mm256_set1_epi32(127));
+#else
+    const auto bias = _mm_set1_epi32(127);
+    const auto lo = _mm_sub_epi32(_mm_srli_epi32(_mm256_castsi256_si128(bits), 23), bias);
+    const auto hi = _mm_sub_epi32(_mm_srli_epi32(_mm256_extractf128_si256(bits, 1), 23), bias);
+    const auto e = _mm256_set_m128i(hi, lo);
+#endif
+    return _mm256_cvtepi32_ps(e);
+}
+
+template <>
+struct mask<double> {
+    __m256d m;
+
+    friend mask operator&(const mask a, const mask b) noexcept {
+        return {_mm256_and_pd(a.m, b.m)};
+    }
+    friend mask operator|(const mask a, const mask b) noexcept {
+        return {_mm256_or_pd(a.m, b.m)};
+    }
+};
+
+template <>
+struct pack<double> {
+    using value_type = double;
+    static constexpr std::size_t width = 4;
+
+    __m256d v;
+
+    pack() noexcept = default;
+    pack(const __m256d r) noexcept : v{r} {}
+    pack(const double x) noexcept : v{_mm256_set1_pd(x)} {}
+
+    static pack load(const double* p) noexcept {
+        return _mm256_loadu_pd(p);
+    }
+    static pack load_strided(const double* p, const std::size_t stride) noexcept {
+        const auto s = stride;
+        return _mm256_set_pd(p[3 * s], p[2 * s], p[s], p[0]);
+    }
+    void store(double* p) const noexcept {
+        _mm256_storeu_pd(p, v);
+    }
+
+    friend pack operator+(const pack a, const pack b) noexcept {
+        return _mm256_add_pd(a.v, b.v);
+    }
+    friend pack operator-(const pack a, const pack b) noexcept {
+        return _mm256_sub_pd(a.v, b.v);
+    }
+    friend pack operator*(const pack a, const pack b) noexcept {
+        return _mm256_mul_pd(a.v, b.v);
+    }
+    friend pack operator/(const pack a, const pack b) noexcept {
+        return _mm256_div_pd(a.v, b.v);
+    }
+    friend pack operator-(const pack a) noexcept {
+        return _mm256_xor_pd(a.v, _mm256_set1_pd(-0.0));
+    }
+
+    friend mask<double> operator==(const pack a, const pack b) noexcept {
+        return {_mm256_cmp_pd(a.v, b.v, _CMP_EQ_OQ)};
+    }
+    friend mask<double> operator!=(const pack a, const pack b) noexcept {
+        return {_mm256_cmp_pd(a.v, b.v, _CMP_NEQ_UQ)};
+    }
+    friend mask<double> operator<(const pack a, const pack b) noexcept {
+        return {_mm256_cmp_pd(a.v, b.v, _CMP_LT_OQ)};
+    }
+    friend mask<double> operator<=(const pack a, const pack b) noexcept {
+        return {_mm256_cmp_pd(a.v, b.v, _CMP_LE_OQ)};
+    }
+    friend mask<double> operator>(const pack a, const pack b) noexcept {
+        return {_mm256_cmp_pd(a.v, b.v, _CMP_GT_OQ)};
+    }
+    friend mask<double> operator>=(const pack a, const pack b) noexcept {
+        return {_mm256_cmp_pd(a.v, b.v, _CMP_GE_OQ)};
+    }
+};
+
+inline bool any(const mask<double> m) noexcept {
+    return _mm256_movemask_pd(m.m) != 0;
+}
+inline bool all(const mask<double> m) noexcept {
+    return _mm256_movemask_pd(m.m) == 0xF;
+}
+inline unsigned bits(const mask<double> m) noexcept {
+    return static_cast<unsigned>(_mm256_movemask_pd(m.m));
+}
+inline pack<double> select(const mask<double> m, const pack<double> a,
+                           const pack<double> b) noexcept {
+#if defined(__AVX2__)
+    return _mm256_blendv_pd(b.v, a.v, m.m);
+#else
+    return _mm256_or_pd(_mm256_and_pd(m.m, a.v), _mm256_andnot_pd(m.m, b.v));
+#endif
+}
+inline pack<double> fma(const pack<double> a, const pack<double> b,
+                        const pack<double> c) noexcept {
+#if defined(__FMA__)
+    return _mm256_fmadd_pd(a.v, b.v, c.v);
+#else
+    return _mm256_add_pd(_mm256_mul_pd(a.v, b.v), c.v);
+#endif
+}
+inline pack<double> sqrt(const pack<double> a) noexcept {
+    return _mm256_sqrt_pd(a.v);
+}
+inline pack<double> abs(const pack<double> a) noexcept {
+    return _mm256_andnot_pd(_mm256_set1_pd(-0.0), a.v);
+}
+inline pack<double> trunc(const pack<double> a) noexcept {
+    return _mm256_round_pd(a.v, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+}
+inline pack<double> nearbyint(const pack<double> a) noexcept {
+    return _mm256_round_pd(a.v, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+}
+inline pack<double> ldexp(const pack<double> a, const pack<double> n) noexcept {
+    const auto e = _mm_add_epi32(_mm256_cvtpd_epi32(n.v), _mm_set1_epi32(1023));
+#if defined(__AVX2__)
+    const auto p = _mm256_slli_epi64(_mm256_cvtepi32_epi64(e), 52);
+#else
+    const auto zero = _mm_setzero_si128();
+    const auto lo = _mm_slli_epi64(_mm_unpacklo_epi32(e, zero), 52);
+    const auto hi = _mm_slli_epi64(_mm_unpackhi_epi32(e, zero), 52);
+    const auto p = _mm256_set_m128i(hi, lo);
+#endif
+    return _mm256_mul_pd(a.v, _mm256_castsi256_pd(p));
+}
+inline pack<double> logb(const pack<double> a) noexcept {
+    const auto bits = _mm256_castpd_si256(a.v);
+    const auto lo = _mm_castsi128_ps(_mm_srli_epi64(_mm256_castsi256_si128(bits), 52));
+    const auto hi = _mm_castsi128_ps(_mm_srli_epi64(_mm256_extractf128_si256(bits, 1), 52));
+    // Gathers the low words of the four lanes.
+    const auto e = _mm_castps_si128(_mm_shuffle_ps(lo, hi, _MM_SHUFFLE(2, 0, 2, 0)));
+    return _mm256_cvtepi32_pd(_mm_sub_epi32(e, _mm_set1_epi32(1023)));
+}
+
+#if defined(__F16C__)
+inline pack<float> widen(const core::float16* p) noexcept {
+    return _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)));
+}
+inline void narrow(core::float16* p, const pack<float> x) noexcept {
+    const auto h = _mm256_cvtps_ph(x.v, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(p), h);
+}
+#endif
+inline pack<float> widen(const core::bfloat16* p) noexcept {
+    const auto h = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    const auto zero = _mm_setzero_si128();
+    return _mm256_castsi256_ps(
+        _mm256_setr_m128i(_mm_unpacklo_epi16(zero, h), _mm_unpackhi_epi16(zero, h)));
+}
+inline void narrow(core::bfloat16* p, const pack<float> x) noexcept {
+    const auto lo = detail::round_bfloat16(_mm256_castps256_ps128(x.v));
+    const auto hi = detail::round_bfloat16(_mm256_extractf128_ps(x.v, 1));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(p), _mm_packs_epi32(lo, hi));
+}
+inline pack<float> widen(const std::int8_t* p) noexcept {
+    std::int32_t lo;
+    std::int32_t hi;
+    std::memcpy(&lo, p, 4);
+    std::memcpy(&hi, p + 4, 4);
+    return _mm256_setr_m128(detail::widen_int8(lo), detail::widen_int8(hi));
+}
+inline void narrow(std::int8_t* p, const pack<float> x) noexcept {
+    const auto lo = detail::round_int8(_mm256_castps256_ps128(x.v));
+    const auto hi = detail::round_int8(_mm256_extractf128_ps(x.v, 1));
+    const auto b = _mm_packs_epi16(_mm_packs_epi32(lo, hi), _mm_setzero_si128());
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(p), b);
+}
+
+#elif defined(TENSOR_SIMD_SSE)
+
+inline constexpr bool has_fma = false;
+
+template <>
+struct mask<float> {
+    __m128 m;
+
+    friend mask operator&(const mask a, const mask b) noexcept {
+        return {_mm_and_ps(a.m, b.m)};
+    }
+    friend mask operator|(const mask a, const mask b) noexcept {
+        return {_mm_or_ps(a.m, b.m)};
+    }
+};
+
+template <>
+struct pack<float> {
+    using value_type = float;
+    static constexpr std::size_t width = 4;
+
+    __m128 v;
+
+    pack() noexcept = default;
+    pack(const __m128 r) noexcept : v{r} {}
+    pack(const float x) noexcept : v{_mm_set1_ps(x)} {}
+
+    static pack load(const float* p) noexcept {
+        return _mm_loadu_ps(p);
+    }
+    static pack load_strided(const float* p, const std::size_t stride) noexcept {
+        const auto s = stride;
+        return _mm_set_ps(p[3 * s], p[2 * s], p[s], p[0]);
+    }
+    void store(float* p) const noexcept {
+        _mm_storeu_ps(p, v);
+    }
+
+    friend pack operator+(const pack a, const pack b) noexcept {
+        return _mm_add_ps(a.v, b.v);
+    }
+    friend pack operator-(const pack a, const pack b) noexcept {
+        return _mm_sub_ps(a.v, b.v);
+    }
+    friend pack operator*(const pack a, const pack b) noexcept {
+        return _mm_mul_ps(a.v, b.v);
+    }
+    friend pack operator/(const pack a, const pack b) noexcept {
+        return _mm_div_ps(a.v, b.v);
+    }
+    friend pack operator-(const pack a) noexcept {
+        return _mm_xor_ps(a.v, _mm_set1_ps(-0.0F));
+    }
+
+    friend mask<float> operator==(const pack a, const pack b) noexcept {
+        return {_mm_cmpeq_ps(a.v, b.v)};
+    }
+    friend mask<float> operator!=(const pack a, const pack b) noexcept {
+        return {_mm_cmpneq_ps(a.v, b.v)};
+    }
+    friend mask<float> operator<(const pack a, const pack b) noexcept {
+        return {_mm_cmplt_ps(a.v, b.v)};
+    }
+    friend mask<float> operator<=(const pack a, const pack b) noexcept {
+        return {_mm_cmple_ps(a.v, b.v)};
+    }
+    friend mask<float> operator>(const pack a, const pack b) noexcept {
+        return {_mm_cmpgt_ps(a.v, b.v)};
+    }
+    friend mask<float> operator>=(const pack a, const pack b) noexcept {
+        return {_mm_cmpge_ps(a.v, b.v)};
+    }
+};
+
+inline bool any(const mask<float> m) noexcept {
+    return _mm_movemask_ps(m.m) != 0;
+}
+inline bool all(const mask<float> m) noexcept {
+    return _mm_movemask_ps(m.m) == 0xF;
+}
+inline unsigned bits(const mask<float> m) noexcept {
+    return static_cast<unsigned>(_mm_movemask_ps(m.m));
+}
+inline pack<float> select(const mask<float> m, const pack<float> a, const pack<float> b) noexcept {
+#if defined(__SSE4_1__)
+    return _mm_blendv_ps(b.v, a.v, m.m);
+#else
+    return _mm_or_ps(_mm_and_ps(m.m, a.v), _mm_andnot_ps(m.m, b.v));
+#endif
+}
+inline pack<float> fma(const pack<float> a, const pack<float> b, const pack<float> c) noexcept {
+    return _mm_add_ps(_mm_mul_ps(a.v, b.v), c.v);
+}
+inline pack<float> sqrt(const pack<float> a) noexcept {
+    return _mm_sqrt_ps(a.v);
+}
+inline pack<float> abs(const pack<float> a) noexcept {
+    return _mm_andnot_ps(_mm_set1_ps(-0.0F), a.v);
+}
+#if defined(__SSE4_1__)
+inline pack<float> trunc(const pack<float> a) noexcept {
+    return _mm_round_ps(a.v, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+}
+inline pack<float> nearbyint(const pack<float> a) noexcept {
+    return _mm_round_ps(a.v, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+}
+#else
+// Adding and subtracting 2^23 rounds magnitudes below 2^23 to the nearest integer, larger ones are
+// integral already.
+inline pack<float> nearbyint(const pack<float> a) noexcept {
+    const auto sign = _mm_and_ps(a.v, _mm_set1_ps(-0.0F));
+    const auto mag = _mm_andnot_ps(_mm_set1_ps(-0.0F), a.v);
+    const auto magic = _mm_set1_ps(8388608.0F);
+    const auto rounded = _mm_or_ps(_mm_sub_ps(_mm_add_ps(mag, magic), magic), sign);
+    return select({_mm_cmplt_ps(mag, magic)}, rounded, a);
+}
+inline pack<float> trunc(const pack<float> a) noexcept {
+    const auto sign = _mm_and_ps(a.v, _mm_set1_ps(-0.0F));
+    const pack<float> mag = _mm_andnot_ps(_mm_set1_ps(-0.0F), a.v);
+    auto t = nearbyint(mag);
+    t = select(t > mag, t - pack<float>{1.0F}, t);
+    return _mm_or_ps(t.v, sign);
+}
+#endif
+inline pack<float> ldexp(const pack<float> a, const pack<float> n) noexcept {
+    const auto e = _mm_add_epi32(_mm_cvtps_epi32(n.v), _mm_set1_epi32(127));
+    return _mm_mul_ps(a.v, _mm_castsi128_ps(_mm_slli_epi32(e, 23)));
+}
+inline pack<float> logb(const pack<float> a) noexcept {
+    const auto e = _mm_srli_epi32(_mm_castps_si128(a.v), 23);
+    return _mm_cvtepi32_ps(_mm_sub_epi32(e, _mm_set1_epi32(127)));
+}
+
+template <>
+struct mask<double> {
+    __m128d m;
+
+    friend mask operator&(const mask a, const mask b) noexcept {
+        return {_mm_and_pd(a.m, b.m)};
+    }
+    friend mask operator|(const mask a, const mask b) noexcept {
+        return {_mm_or_pd(a.m, b.m)};
+    }
+};
+
+template <>
+struct pack<double> {
+    using value_type = double;
+    static constexpr std::size_t width = 2;
+
+    __m128d v;
+
+    pack() noexcept = default;
+    pack(const __m128d r) noexcept : v{r} {}
+    pack(const double x) noexcept : v{_mm_set1_pd(x)} {}
+
+    static pack load(const double* p) noexcept {
+        return _mm_loadu_pd(p);
+    }
+    static pack load_strided(const double* p, const std::size_t stride) noexcept {
+        return _mm_set_pd(p[stride], p[0]);
+    }
+    void store(double* p) const noexcept {
+        _mm_storeu_pd(p, v);
+    }
+
+    friend pack operator+(const pack a, const pack b) noexcept {
+        return _mm_add_pd(a.v, b.v);
+    }
+    friend pack operator-(const pack a, const pack b) noexcept {
+        return _mm_sub_pd(a.v, b.v);
+    }
+    friend pack operator*(const pack a, const pack b) noexcept {
+        return _mm_mul_pd(a.v, b.v);
+    }
+    friend pack operator/(const pack a, const pack b) noexcept {
+        return _mm_div_pd(a.v, b.v);
+    }
+    friend pack operator-(const pack a) noexcept {
+        return _mm_xor_pd(a.v, _mm_set1_pd(-0.0));
+    }
+
+    friend mask<double> operator==(const pack a, const pack b) noexcept {
+        return {_mm_cmpeq_pd(a.v, b.v)};
+    }
+    friend mask<double> operator!=(const pack a, const pack b) noexcept {
+        return {_mm_cmpneq_pd(a.v, b.v)};
+    }
+    friend mask<double> operator<(const pack a, const pack b) noexcept {
+        return {_mm_cmplt_pd(a.v, b.v)};
+    }
+    friend mask<double> operator<=(const pack a, const pack b) noexcept {
+        return {_mm_cmple_pd(a.v, b.v)};
+    }
+    friend mask<double> operator>(const pack a, const pack b) noexcept {
+        return {_mm_cmpgt_pd(a.v, b.v)};
+    }
+    friend mask<double> operator>=(const pack a, const pack b) noexcept {
+        return {_mm_cmpge_pd(a.v, b.v)};
+    }
+};
+
+inline bool any(const mask<double> m) noexcept {
+    return _mm_movemask_pd(m.m) != 0;
+}
+inline bool all(const mask<double> m) noexcept {
+    return _mm_movemask_pd(m.m) == 0x3;
+}
+inline unsigned bits(const mask<double> m) noexcept {
+    return static_cast<unsigned>(_mm_movemask_pd(m.m));
+}
+inline pack<double> select(const mask<double> m, const pack<double> a,
+                           const pack<double> b) noexcept {
+#if defined(__SSE4_1__)
+    return _mm_blendv_pd(b.v, a.v, m.m);
+#else
+    return _mm_or_pd(_mm_and_pd(m.m, a.v), _mm_andnot_pd(m.m, b.v));
+#endif
+}
+inline pack<double> fma(const pack<double> a, const pack<double> b,
+                        const pack<double> c) noexcept {
+    return _mm_add_pd(_mm_mul_pd(a.v, b.v), c.v);
+}
+inline pack<double> sqrt(const pack<double> a) noexcept {
+    return _mm_sqrt_pd(a.v);
+}
+inline pack<double> abs(const pack<double> a) noexcept {
+    return _mm_andnot_pd(_mm_set1_pd(-0.0), a.v);
+}
+#if defined(__SSE4_1__)
+inline pack<double> trunc(const pack<double> a) noexcept {
+    return _mm_round_pd(a.v, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+}
+inline pack<double> nearbyint(const pack<double> a) noexcept {
+    return _mm_round_pd(a.v, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+}
+#else
+inline pack<double> nearbyint(const pack<double> a) noexcept {
+    const auto sign = _mm_and_pd(a.v, _mm_set1_pd(-0.0));
+    const auto mag = _mm_andnot_pd(_mm_set1_pd(-0.0), a.v);
+    const auto magic = _mm_set1_pd(4503599627370496.0);
+    const auto rounded = _mm_or_pd(_mm_sub_pd(_mm_add_pd(mag, magic), magic), sign);
+    return select({_mm_cmplt_pd(mag, magic)}, rounded, a);
+}
+inline pack<double> trunc(const pack<double> a) noexcept {
+    const auto sign = _mm_and_pd(a.v, _mm_set1_pd(-0.0));
+    const pack<double> mag = _mm_andnot_pd(_mm_set1_pd(-0.0), a.v);
+    auto t = nearbyint(mag);
+    t = select(t > mag, t - pack<double>{1.0}, t);
+    return _mm_or_pd(t.v, sign);
+}
+#endif
+inline pack<double> ldexp(const pack<double> a, const pack<double> n) noexcept {
+    const auto e = _mm_add_epi32(_mm_cvtpd_epi32(n.v), _mm_set1_epi32(1023));
+    const auto p = _mm_slli_epi64(_mm_unpacklo_epi32(e, _mm_setzero_si128()), 52);
+    return _mm_mul_pd(a.v, _mm_castsi128_pd(p));
+}
+inline pack<double> logb(const pack<double> a) noexcept {
+    const auto e = _mm_srli_epi64(_mm_castpd_si128(a.v), 52);
+    const auto low = _mm_shuffle_epi32(e, _MM_SHUFFLE(3, 1, 2, 0));
+    return _mm_cvtepi32_pd(_mm_sub_epi32(low, _mm_set1_epi32(1023)));
+}
+
+#if defined(__F16C__)
+inline pack<float> widen(const core::float16* p) noexcept {
+    return _mm_cvtph_ps(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(p)));
+}
+inline void narrow(core::float16* p, const pack<float> x) noexcept {
+    const auto h = _mm_cvtps_ph(x.v, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(p), h);
+}
+#endif
+inline pack<float> widen(const core::bfloat16* p) noexcept {
+    const auto h = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(p));
+    return _mm_castsi128_ps(_mm_unpacklo_epi16(_mm_setzero_si128(), h));
+}
+inline void narrow(core::bfloat16* p, const pack<float> x) noexcept {
+    const auto h = detail::round_bfloat16(x.v);
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(p), _mm_packs_epi32(h, h));
+}
+inline pack<float> widen(const std::int8_t* p) noexcept {
+    std::int32_t word;
+    std::memcpy(&word, p, 4);
+    return detail::widen_int8(word);
+}
+inline void narrow(std::int8_t* p, const pack<float> x) noexcept {
+    const auto i = detail::round_int8(x.v);
+    const auto b = _mm_packs_epi16(_mm_packs_epi32(i, i), _mm_setzero_si128());
+    const auto word = _mm_cvtsi128_si32(b);
+    std::memcpy(p, &word, 4);
+}
+
+#elif defined(TENSOR_SIMD_NEON)
+
+inline constexpr bool has_fma = true;
+
+template <>
+struct mask<float> {
+    uint32x4_t m;
+
+    friend mask operator&(const mask a, const mask b) noexcept {
+        return {vandq_u32(a.m, b.m)};
+    }
+    friend mask operator|(const mask a, const mask b) noexcept {
+        return {vorrq_u32(a.m, b.m)};
+    }
+};
+
+template <>
+struct pack<float> {
+    using value_type = float;
+    static constexpr std::size_t width = 4;
+
+    float32x4_t v;
+
+    pack() noexcept = default;
+    pack(const float32x4_t r) noexcept : v{r} {}
+    pack(const float x) noexcept : v{vdupq_n_f32(x)} {}
+
+    static pack load(const float* p) noexcept {
+        return vld1q_f32(p);
+    }
+    static pack load_strided(const float* p, const std::size_t stride) noexcept {
+        auto r = vld1q_dup_f32(p);
+        r = vld1q_lane_f32(p + stride, r, 1);
+        r = vld1q_lane_f32(p + 2 * stride, r, 2);
+        return vld1q_lane_f32(p + 3 * stride, r, 3);
+    }
+    void store(float* p) const noexcept {
+        vst1q_f32(p, v);
+    }
+
+    friend pack operator+(const pack a, const pack b) noexcept {
+        return vaddq_f32(a.v, b.v);
+    }
+    friend pack operator-(const pack a, const pack b) noexcept {
+        return vsubq_f32(a.v, b.v);
+    }
+    friend pack operator*(const pack a, const pack b) noexcept {
+        return vmulq_f32(a.v, b.v);
+    }
+    friend pack operator/(const pack a, const pack b) noexcept {
+        return vdivq_f32(a.v, b.v);
+    }
+    friend pack operator-(const pack a) noexcept {
+        return vnegq_f32(a.v);
+    }
+
+    friend mask<float> operator==(const pack a, const pack b) noexcept {
+        return {vceqq_f32(a.v, b.v)};
+    }
+    friend mask<float> operator!=(const pack a, const pack b) noexcept {
+        return {vmvnq_u32(vceqq_f32(a.v, b.v))};
+    }
+    friend mask<float> operator<(const pack a, const pack b) noexcept {
+        return {vcltq_f32(a.v, b.v)};
+    }
+    friend mask<float> operator<=(const pack a, const pack b) noexcept {
+        return {vcleq_f32(a.v, b.v)};
+    }
+    friend mask<float> operator>(const pack a, const pack b) noexcept {
+        return {vcgtq_f32(a.v, b.v)};
+    }
+    friend mask<float> operator>=(const pack a, const pack b) noexcept {
+        return {vcgeq_f32(a.v, b.v)};
+    }
+};
+
+inline bool any(const mask<float> m) noexcept {
+    return vmaxvq_u32(m.m) != 0;
+}
+inline bool all(const mask<float> m) noexcept {
+    return vminvq_u32(m.m) != 0;
+}
+inline unsigned bits(const mask<float> m) noexcept {
+    const uint32x4_t lanes = {1, 2, 4, 8};
+    return vaddvq_u32(vandq_u32(m.m, lanes));
+}
+inline pack<float> select(const mask<float> m, const pack<float> a, const pack<float> b) noexcept {
+    return vbslq_f32(m.m, a.v, b.v);
+}
+inline pack<float> fma(const pack<float> a, const pack<float> b, const pack<float> c) noexcept {
+    return vfmaq_f32(c.v, a.v, b.v);
+}
+inline pack<float> sqrt(const pack<float> a) noexcept {
+    return vsqrtq_f32(a.v);
+}
+inline pack<float> abs(const pack<float> a) noexcept {
+    return vabsq_f32(a.v);
+}
+inline pack<float> trunc(const pack<float> a) noexcept {
+    return vrndq_f32(a.v);
+}
+inline pack<float> nearbyint(const pack<float> a) noexcept {
+    return vrndnq_f32(a.v);
+}
+inline pack<float> ldexp(const pack<float> a, const pack<float> n) noexcept {
+    const auto e = vaddq_s32(vcvtnq_s32_f32(n.v), vdupq_n_s32(127));
+    return vmulq_f32(a.v, vreinterpretq_f32_s32(vshlq_n_s32(e, 23)));
+}
+inline pack<float> logb(const pack<float> a) noexcept {
+    const auto e = vreinterpretq_s32_u32(vshrq_n_u32(vreinterpretq_u32_f32(a.v), 23));
+    return vcvtq_f32_s32(vsubq_s32(e, vdupq_n_s32(127)));
+}
+
+template <>
+struct mask<double> {
+    uint64x2_t m;
+
+    friend mask operator&(const mask a, const mask b) noexcept {
+        return {vandq_u64(a.m, b.m)};
+    }
+    friend mask operator|(const mask a, const mask b) noexcept {
+        return {vorrq_u64(a.m, b.m)};
+    }
+};
+
+template <>
+struct pack<double> {
+    using value_type = double;
+    static constexpr std::size_t width = 2;
+
+    float64x2_t v;
+
+    pack() noexcept = default;
+    pack(const float64x2_t r) noexcept : v{r} {}
+    pack(const double x) noexcept : v{vdupq_n_f64(x)} {}
+
+    static pack load(const double* p) noexcept {
+        return vld1q_f64(p);
+    }
+    static pack load_strided(const double* p, const std::size_t stride) noexcept {
+        return vld1q_lane_f64(p + stride, vld1q_dup_f64(p), 1);
+    }
+    void store(double* p) const noexcept {
+        vst1q_f64(p, v);
+    }
+
+    friend pack operator+(const pack a, const pack b) noexcept {
+        return vaddq_f64(a.v, b.v);
+    }
+    friend pack operator-(const pack a, const pack b) noexcept {
+        return vsubq_f64(a.v, b.v);
+    }
+    friend pack operator*(const pack a, const pack b) noexcept {
+        return vmulq_f64(a.v, b.v);
+    }
+    friend pack operator/(const pack a, const pack b) noexcept {
+        return vdivq_f64(a.v, b.v);
+    }
+    friend pack operator-(const pack a) noexcept {
+        return vnegq_f64(a.v);
+    }
+
+    friend mask<double> operator==(const pack a, const pack b) noexcept {
+        return {vceqq_f64(a.v, b.v)};
+    }
+    friend mask<double> operator!=(const pack a, const pack b) noexcept {
+        return {vreinterpretq_u64_u32(vmvnq_u32(vreinterpretq_u32_u64(vceqq_f64(a.v, b.v))))};
+    }
+    friend mask<double> operator<(const pack a, const pack b) noexcept {
+        return {vcltq_f64(a.v, b.v)};
+    }
+    friend mask<double> operator<=(const pack a, const pack b) noexcept {
+        return {vcleq_f64(a.v, b.v)};
+    }
+    friend mask<double> operator>(const pack a, const pack b) noexcept {
+        return {vcgtq_f64(a.v, b.v)};
+    }
+    friend mask<double> operator>=(const pack a, const pack b) noexcept {
+        return {vcgeq_f64(a.v, b.v)};
+    }
+};
+
+inline bool any(const mask<double> m) noexcept {
+    return vmaxvq_u32(vreinterpretq_u32_u64(m.m)) != 0;
+}
+inline bool all(const mask<double> m) noexcept {
+    return vminvq_u32(vreinterpretq_u32_u64(m.m)) != 0;
+}
+inline unsigned bits(const mask<double> m) noexcept {
+    const uint64x2_t lanes = {1, 2};
+    return static_cast<unsigned>(vaddvq_u64(vandq_u64(m.m, lanes)));
+}
+inline pack<double> select(const mask<double> m, const pack<double> a,
+                           const pack<double> b) noexcept {
+    return vbslq_f64(m.m, a.v, b.v);
+}
+inline pack<double> fma(const pack<double> a, const pack<double> b,
+                        const pack<double> c) noexcept {
+    return vfmaq_f64(c.v, a.v, b.v);
+}
+inline pack<double> sqrt(const pack<double> a) noexcept {
+    return vsqrtq_f64(a.v);
+}
+inline pack<double> abs(const pack<double> a) noexcept {
+    return vabsq_f64(a.v);
+}
+inline pack<double> trunc(const pack<double> a) noexcept {
+    return vrndq_f64(a.v);
+}
+inline pack<double> nearbyint(const pack<double> a) noexcept {
+    return vrndnq_f64(a.v);
+}
+inline pack<double> ldexp(const pack<double> a, const pack<double> n) noexcept {
+    const auto e = vaddq_s64(vcvtnq_s64_f64(n.v), vdupq_n_s64(1023));
+    return vmulq_f64(a.v, vreinterpretq_f64_s64(vshlq_n_s64(e, 52)));
+}
+inline pack<double> logb(const pack<double> a) noexcept {
+    const auto e = vreinterpretq_s64_u64(vshrq_n_u64(vreinterpretq_u64_f64(a.v), 52));
+    return vcvtq_f64_s64(vsubq_s64(e, vdupq_n_s64(1023)));
+}
+
+inline pack<float> widen(const core::float16* p) noexcept {
+    return vcvt_f32_f16(vreinterpret_f16_u16(vld1_u16(reinterpret_cast<const std::uint16_t*>(p))));
+}
+inline void narrow(core::float16* p, const pack<float> x) noexcept {
+    vst1_u16(reinterpret_cast<std::uint16_t*>(p), vreinterpret_u16_f16(vcvt_f16_f32(x.v)));
+}
+inline pack<float> widen(const core::bfloat16* p) noexcept {
+    const auto h = vld1_u16(reinterpret_cast<const std::uint16_t*>(p));
+    return vreinterpretq_f32_u32(vshll_n_u16(h, 16));
+}
+inline void narrow(core::bfloat16* p, const pack<float> x) noexcept {
+    const auto bits = vreinterpretq_u32_f32(x.v);
+    const auto high = vshrq_n_u32(bits, 16);
+    const auto bias = vaddq_u32(vandq_u32(high, vdupq_n_u32(1)), vdupq_n_u32(0x7FFF));
+    const auto rounded = vshrq_n_u32(vaddq_u32(bits, bias), 16);
+    const auto nan = vmvnq_u32(vceqq_f32(x.v, x.v));
+    const auto h = vbslq_u32(nan, vorrq_u32(high, vdupq_n_u32(0x40)), rounded);
+    vst1_u16(reinterpret_cast<std::uint16_t*>(p), vmovn_u32(h));
+}
+inline pack<float> widen(const std::int8_t* p) noexcept {
+    std::uint32_t word;
+    std::memcpy(&word, p, 4);
+    const auto w = vmovl_s8(vreinterpret_s8_u32(vdup_n_u32(word)));
+    return vcvtq_f32_s32(vmovl_s16(vget_low_s16(w)));
+}
+inline void narrow(std::int8_t* p, const pack<float> x) noexcept {
+    const auto clamped = vminq_f32(vmaxq_f32(x.v, vdupq_n_f32(-128.0F)), vdupq_n_f32(127.0F));
+    const auto w = vqmovn_s32(vcvtnq_s32_f32(clamped));
+    const auto word = vget_lane_u32(vreinterpret_u32_s8(vqmovn_s16(vcombine_s16(w, w))), 0);
+    std::memcpy(p, &word, 4);
+}
+
+#endif
+
+/**
+ * @brief Specifies a storage type whose values are converted to and from packs of `float` by
+ * `widen` and `narrow`, i.e. the 16-bit floating-point types and `std::int8_t`.
+ */
+template <typename T>
+concept compact = core::is_half_v<T> || std::is_same_v<T, std::int8_t>;
+
+/**
+ * @brief Converts a `float` to the compact type, rounding to nearest even. Conversions to
+ * `std::int8_t` saturate, NaN giving -128.
+ */
+template <compact T>
+[[nodiscard]] inline T narrow_cast(const float val) noexcept {
+    if constexpr (std::is_same_v<T, std::int8_t>) {
+        const auto rounded = std::nearbyint(val);
+        if (rounded >= 127.0F) {
+            return 127;
+        }
+        return rounded > -128.0F ? static_cast<std::int8_t>(rounded) : std::int8_t{-128};
+    } else {
+        return static_cast<T>(val);
+    }
+}
+
+/**
+ * @brief Loads a pack of `float` from values of a compact type, for which the target has no
+ * conversion instructions.
+ */
+template <compact T, supported F = float>
+[[nodiscard]] inline pack<F> widen(const T* p) noexcept {
+    alignas(64) F buf[pack<F>::width];
+    for (std::size_t idx = 0; idx < pack<F>::width; ++idx) {
+        buf[idx] = static_cast<F>(p[idx]);
+    }
+    return pack<F>::load(buf);
+}
+
+/**
+ * @brief Stores a pack of `float` as values of a compact type, for which the target has no
+ * conversion instructions, see `narrow_cast`.
+ */
+template <compact T, supported F>
+inline void narrow(T* p, const pack<F> x) noexcept {
+    alignas(64) F buf[pack<F>::width];
+    x.store(buf);
+    for (std::size_t idx = 0; idx < pack<F>::width; ++idx) {
+        p[idx] = narrow_cast<T>(buf[idx]);
+    }
+}
+
+/**
+ * @brief Type of the lanes values of type `T` are loaded into, i.e. `float` for the 16-bit
+ * floating-point types, which are converted on every load and store, and `T` otherwise.
+ */
+template <typename T>
+using lane_t = core::compute_t<T>;
+
+/**
+ * @brief Specifies a type whose values are loaded into packs, either natively or by conversion.
+ */
+template <typename T>
+concept loadable = supported<lane_t<T> > && (supported<T> || core::is_half_v<T>);
+
+/**
+ * @brief Loads a full pack, converting from the 16-bit floating-point types.
+ * @param p Pointer to the values.
+ * @return A pack holding the values.
+ */
+template <loadable T>
+[[nodiscard]] inline pack<lane_t<T> > load(const T* p) noexcept {
+    if constexpr (core::is_half_v<T>) {
+        return widen(p);
+    } else {
+        return pack<T>::load(p);
+    }
+}
+
+/**
+ * @brief Loads a full pack from values `stride` elements apart, converting from the 16-bit
+ * floating-point types. The lanes are inserted into the register one by one rather than written
+ * to memory and loaded back, which would stall on forwarding the stores to the wider load.
+ * @param p Pointer to the first value.
+ * @param stride Distance between consecutive values.
+ * @return A pack holding the values.
+ */
+template <loadable T>
+[[nodiscard]] inline pack<lane_t<T> > load_strided(const T* p, const std::size_t stride) noexcept {
+    if constexpr (core::is_half_v<T>) {
+        T buf[pack<lane_t<T> >::width];
+        for (std::size_t idx = 0; idx < pack<lane_t<T> >::width; ++idx) {
+            buf[idx] = p[idx * stride];
+        }
+        return widen(static_cast<const T*>(buf));
+    } else {
+        return pack<T>::load_strided(p, stride);
+    }
+}
+
+/**
+ * @brief Stores a full pack, rounding to the 16-bit floating-point types.
+ * @param p Pointer to the destination.
+ * @param x Pack to store.
+ */
+template <loadable T>
+inline void store(T* p, const pack<lane_t<T> > x) noexcept {
+    if constexpr (core::is_half_v<T>) {
+        narrow(p, x);
+    } else {
+        x.store(p);
+    }
+}
+
+/**
+ * @brief Loads the first `count` values, padding the remaining lanes with ones so that padded lanes
+ * never trip a division by zero.
+ * @param p Pointer to the values.
+ * @param count Number of values to load, less than the width of the pack.
+ * @return A pack holding the values.
+ */
+template <loadable T>
+[[nodiscard]] inline pack<lane_t<T> > load_partial(const T* p, const std::size_t count) noexcept {
+    alignas(64) T buf[pack<lane_t<T> >::width];
+    std::fill_n(buf, pack<lane_t<T> >::width, T{1});
+    std::copy_n(p, count, buf);
+    return load(static_cast<const T*>(buf));
+}
+
+/**
+ * @brief Stores the first `count` lanes of the pack.
+ * @param p Pointer to the destination.
+ * @param x Pack to store.
+ * @param count Number of lanes to store, less than the width of the pack.
+ */
+template <loadable T>
+inline void store_partial(T* p, const pack<lane_t<T> > x, const std::size_t count) noexcept {
+    alignas(64) T buf[pack<lane_t<T> >::width];
+    store(static_cast<T*>(buf), x);
+    std::copy_n(buf, count, p);
+}
+
+/**
+ * @brief Loads the first `count` values of a compact type, padding the remaining lanes with ones.
+ */
+template <compact T, supported F = float>
+[[nodiscard]] inline pack<F> widen_partial(const T* p, const std::size_t count) noexcept {
+    T buf[pack<F>::width];
+    std::fill_n(buf, pack<F>::width, T{1});
+    std::copy_n(p, count, buf);
+    return widen(static_cast<const T*>(buf));
+}
+
+/**
+ * @brief Stores the first `count` lanes of the pack as values of a compact type.
+ */
+template <compact T, supported F>
+inline void narrow_partial(T* p, const pack<F> x, const std::size_t count) noexcept {
+    T buf[pack<F>::width];
+    narrow(static_cast<T*>(buf), x);
+    std::copy_n(buf, count, p);
+}
+
+/**
+ * @brief Applies a scalar function to every lane of the pack.
+ */
+template <supported T, typename F>
+[[nodiscard]] inline pack<T> map_lanes(const pack<T> x, F f) {
+    alignas(64) T buf[pack<T>::width];
+    x.store(buf);
+    for (std::size_t idx = 0; idx < pack<T>::width; ++idx) {
+        buf[idx] = static_cast<T>(f(buf[idx]));
+    }
+    return pack<T>::load(buf);
+}
+
+/**
+ * @brief Applies a scalar function to every pair of lanes of the packs.
+ */
+template <supported T, typename F>
+[[nodiscard]] inline pack<T> zip_lanes(const pack<T> x, const pack<T> y, F f) {
+    alignas(64) T lhs[pack<T>::width];
+    alignas(64) T rhs[pack<T>::width];
+    x.store(lhs);
+    y.store(rhs);
+    for (std::size_t idx = 0; idx < pack<T>::width; ++idx) {
+        lhs[idx] = static_cast<T>(f(lhs[idx], rhs[idx]));
+    }
+    return pack<T>::load(lhs);
+}
+
+/**
+ * @brief Returns the lane-wise minimum, keeping the lane of `a` unless `b` compares less.
+ */
+template <supported T>
+[[nodiscard]] inline pack<T> min(const pack<T> a, const pack<T> b) noexcept {
+    return select(b < a, b, a);
+}
+
+/**
+ * @brief Returns the lane-wise maximum, keeping the lane of `a` unless `b` compares greater.
+ */
+template <supported T>
+[[nodiscard]] inline pack<T> max(const pack<T> a, const pack<T> b) noexcept {
+    return select(a < b, b, a);
+}
+
+/**
+ * @brief Combines the lanes of the pack pairwise via the binary operation.
+ * @param x Pack to reduce.
+ * @param f Associative operation invoked on scalars.
+ * @return The combined value.
+ */
+template <supported T, typename F>
+[[nodiscard]] inline T reduce(const pack<T> x, F f) {
+    alignas(64) T buf[pack<T>::width];
+    x.store(buf);
+    for (auto width = pack<T>::width / 2; width > 0; width /= 2) {
+        for (std::size_t idx = 0; idx < width; ++idx) {
+            buf[idx] = f(buf[idx], buf[idx + width]);
+        }
+    }
+    return buf[0];
+}
+
+template <supported T>
+[[nodiscard]] inline pack<T> floor(const pack<T> x) noexcept {
+    const auto t = trunc(x);
+    return select(t > x, t - T{1}, t);
+}
+
+/**
+ * @brief Rounds half away from zero, matching `std::round`.
+ */
+template <supported T>
+[[nodiscard]] inline pack<T> round(const pack<T> x) noexcept {
+    const auto t = trunc(x);
+    const auto away = select(x < T{0}, t - T{1}, t + T{1});
+    return select(abs(x - t) >= T{0.5}, away, t);
+}
+
+namespace detail {
+
+/**
+ * @brief Cody-Waite constants splitting pi / 2 into three parts, along with the minimax
+ * coefficients of Cephes on [-pi/4, pi/4]. With a fused multiply-add every part carries full
+ * precision, otherwise the leading parts are short enough for their products with the quadrant to
+ * be exact within the reduction range.
+ */
+template <typename T>
+struct trig;
+
+template <>
+struct trig<float> {
+    static constexpr float limit = has_fma ? 8192.0F : 64.0F;
+    static constexpr float two_over_pi = 0.636619772367581343F;
+    static constexpr std::array<float, 3> pio2 =
+        has_fma ? std::array<float, 3>{1.570796371e+0F, -4.371138829e-8F, -1.715124510e-15F}
+                : std::array<float, 3>{1.5703125F, 4.837512969970703125e-4F,
+                                       7.54978995489188216e-8F};
+    static constexpr std::array<float, 3> sin = {-1.9515295891e-4F, 8.3321608736e-3F,
+                                                 -1.6666654611e-1F};
+    static constexpr std::array<float, 3> cos = {2.443315711809948e-5F, -1.388731625493765e-3F,
+                                                 4.166664568298827e-2F};
+};
+
+template <>
+struct trig<double> {
+    static constexpr double limit = 1.0e9;
+    static constexpr double two_over_pi = 0.636619772367581343075535;
+    static constexpr std::array<double, 3> pio2 =
+        has_fma ? std::array<double, 3>{1.57079632679489656e+0, 6.12323399573676604e-17,
+                                        -1.49738490485916983e-33}
+                : std::array<double, 3>{1.57079625129699707031e+0, 7.54978941586159635335e-8,
+                                        5.39030285815811905290e-15};
+    static constexpr std::array<double, 6> sin = {
+        1.58962301576546568060e-10, -2.50507477628578072866e-8, 2.75573136213857245213e-6,
+        -1.98412698295895385996e-4, 8.33333333332211858878e-3,  -1.66666666666666307295e-1};
+    static constexpr std::array<double, 6> cos = {
+        -1.13585365213876817300e-11, 2.08757008419747316778e-9, -2.75573141792967388112e-7,
+        2.48015872888517045348e-5,   -1.38888888888730564116e-3, 4.16666666666665929218e-2};
+};
+
+template <supported T, std::size_t N>
+[[nodiscard]] inline pack<T> horner(const pack<T> z, const std::array<T, N>& coeffs) noexcept {
+    pack<T> acc = coeffs[0];
+    for (std::size_t idx = 1; idx < N; ++idx) {
+        acc = fma(acc, z, coeffs[idx]);
+    }
+    return acc;
+}
+
+/**
+ * @brief Reduces the argument to r in [-pi/4, pi/4] and computes sin(r), cos(r) and the quadrant.
+ */
+template <supported T>
+inline void sincos(const pack<T> x, pack<T>& s, pack<T>& c, pack<T>& q) noexcept {
+    using k = trig<T>;
+    const auto j = nearbyint(x * k::two_over_pi);
+    auto r = fma(-j, k::pio2[0], x);
+    r = fma(-j, k::pio2[1], r);
+    r = fma(-j, k::pio2[2], r);
+    const auto z = r * r;
+    s = fma(r * z, horner(z, k::sin), r);
+    c = fma(z * z, horner(z, k::cos), fma(z, pack<T>{T{-0.5}}, pack<T>{T{1}}));
+    q = j - floor(j * T{0.25}) * T{4};
+}
+
+}  // namespace detail
+
+/**
+ * @brief Computes the sine via a polynomial approximation, see `TENSOR_FAST_MATH` for accuracy.
+ */
+template <supported T>
+[[nodiscard]] inline pack<T> sin(const pack<T> x) {
+    if (any(abs(x) >= detail::trig<T>::limit)) {
+        return map_lanes(x, [](const T val) { return std::sin(val); });
+    }
+    pack<T> s;
+    pack<T> c;
+    pack<T> q;
+    detail::sincos(x, s, c, q);
+    auto y = select((q == T{1}) | (q == T{3}), c, s);
+    y = select(q >= T{2}, -y, y);
+    return select(x == T{0}, x, y);
+}
+
+/**
+ * @brief Computes the cosine via a polynomial approximation, see `TENSOR_FAST_MATH` for accuracy.
+ */
+template <supported T>
+[[nodiscard]] inline pack<T> cos(const pack<T> x) {
+    if (any(abs(x) >= detail::trig<T>::limit)) {
+        return map_lanes(x, [](const T val) { return std::cos(val); });
+    }
+    pack<T> s;
+    pack<T> c;
+    pack<T> q;
+    detail::sincos(x, s, c, q);
+    auto y = select((q == T{1}) | (q == T{3}), s, c);
+    return select((q == T{1}) | (q == T{2}), -y, y);
+}
+
+/**
+ * @brief Computes the tangent via a polynomial approximation, see `TENSOR_FAST_MATH` for accuracy.
+ */
+template <supported T>
+[[nodiscard]] inline pack<T> tan(const pack<T> x) {
+    if (any(abs(x) >= detail::trig<T>::limit)) {
+        return map_lanes(x, [](const T val) { return std::tan(val); });
+    }
+    pack<T> s;
+    pack<T> c;
+    pack<T> q;
+    detail::sincos(x, s, c, q);
+    const auto odd = (q == T{1}) | (q == T{3});
+    const auto y = select(odd, -c, s) / select(odd, s, c);
+    return select(x == T{0}, x, y);
+}
+
+namespace detail {
+
+/**
+ * @brief Constants of Cephes for the exponential on [-ln(2) / 2, ln(2) / 2], i.e. ln(2) split into
+ * a leading part short enough for its product with the exponent to be exact, and the coefficients
+ * of a polynomial in `float` and of a rational function in `double`. Beyond the limit the scaled
+ * result would leave the normal range.
+ */
+template <typename T>
+struct exponential;
+
+template <>
+struct exponential<float> {
+    static constexpr float limit = 87.0F;
+    static constexpr float log2e = 1.44269504088896341F;
+    static constexpr std::array<float, 2> ln2 = {0.693359375F, -2.12194440e-4F};
+    static constexpr std::array<float, 6> p = {1.9875691500e-4F, 1.3981999507e-3F,
+                                               8.3334519073e-3F, 4.1665795894e-2F,
+                                               1.6666665459e-1F, 5.0000001201e-1F};
+};
+
+template <>
+struct exponential<double> {
+    static constexpr double limit = 708.0;
+    static constexpr double log2e = 1.4426950408889634073599;
+    static constexpr std::array<double, 2> ln2 = {6.93145751953125e-1, 1.42860682030941723212e-6};
+    static constexpr std::array<double, 3> p = {1.26177193074810590878e-4,
+                                                3.02994407707441961300e-2,
+                                                9.99999999999999999910e-1};
+    static constexpr std::array<double, 4> q = {3.00198505138664455042e-6,
+                                                2.52448340349684104192e-3,
+                                                2.27265548208155028766e-1,
+                                                2.00000000000000000009e0};
+};
+
+/**
+ * @brief Constants of Cephes for the natural logarithm of the mantissa in [sqrt(1/2), sqrt(2)),
+ * along with the largest argument whose exponent may be negated without leaving the normal range.
+ */
+template <typename T>
+struct logarithm;
+
+template <>
+struct logarithm<float> {
+    static constexpr float limit = 0x1p127F;
+    static constexpr std::array<float, 9> p = {
+        7.0376836292e-2F,  -1.1514610310e-1F, 1.1676998740e-1F,
+        -1.2420140846e-1F, 1.4249322787e-1F,  -1.6668057665e-1F,
+        2.0000714765e-1F,  -2.4999993993e-1F, 3.3333331174e-1F};
+};
+
+template <>
+struct logarithm<double> {
+    static constexpr double limit = 0x1p1023;
+    static constexpr std::array<double, 6> p = {
+        1.01875663804580931796e-4, 4.97494994976747001425e-1, 4.70579119878881725854e0,
+        1.44989225341610930846e1,  1.79368678507819816313e1,  7.70838733755885391666e0};
+    static constexpr std::array<double, 6> q = {
+        1.0, 1.12873587189167450590e1, 4.52279145837532221105e1, 8.29875266912776603211e1,
+        7.11544750618563894466e1,      2.31251620126765340583e1};
+};
+
+/**
+ * @brief Constants of Cephes for the hyperbolic tangent of |x| < 0.625, beyond which it is computed
+ * from the exponential, and the argument from which it rounds to one.
+ */
+template <typename T>
+struct hyperbolic;
+
+template <>
+struct hyperbolic<float> {
+    static constexpr float saturation = 10.0F;
+    static constexpr std::array<float, 5> p = {-5.70498872745e-3F, 2.06390887954e-2F,
+                                               -5.37397155531e-2F, 1.33314422036e-1F,
+                                               -3.33332819422e-1F};
+};
+
+template <>
+struct hyperbolic<double> {
+    static constexpr double saturation = 20.0;
+    static constexpr std::array<double, 3> p = {
+        -9.64399179425052238628e-1, -9.92877231001918586564e1, -1.61468768441708447952e3};
+    static constexpr std::array<double, 4> q = {1.0, 1.12811678491632931402e2,
+                                                2.23548839060100448583e3,
+                                                4.84406305325125486048e3};
+};
+
+/**
+ * @brief Computes the exponential of arguments within the limit, splitting x into n ln(2) + r.
+ * The `ldexp` of every target only scales by powers of two within the normal range.
+ */
+template <supported T>
+[[nodiscard]] inline pack<T> exp(const pack<T> x) noexcept {
+    using k = exponential<T>;
+    const auto n = nearbyint(x * k::log2e);
+    auto r = fma(-n, k::ln2[0], x);
+    r = fma(-n, k::ln2[1], r);
+    const auto z = r * r;
+    if constexpr (std::is_same_v<T, float>) {
+        return ldexp(fma(horner(r, k::p), z, r) + T{1}, n);
+    } else {
+        const auto p = r * horner(z, k::p);
+        return ldexp(fma(p / (horner(z, k::q) - p), pack<T>{T{2}}, pack<T>{T{1}}), n);
+    }
+}
+
+}  // namespace detail
+
+/**
+ * @brief Computes the exponential via a polynomial approximation, see `TENSOR_FAST_MATH` for
+ * accuracy. Results which would overflow or be subnormal are passed to `std::exp`.
+ */
+template <supported T>
+[[nodiscard]] inline pack<T> exp(const pack<T> x) {
+    if (any(abs(x) >= detail::exponential<T>::limit)) {
+        return map_lanes(x, [](const T val) { return std::exp(val); });
+    }
+    return detail::exp(x);
+}
+
+/**
+ * @brief Computes the natural logarithm via a polynomial approximation, see `TENSOR_FAST_MATH` for
+ * accuracy. Arguments which are not positive and normal are passed to `std::log`.
+ */
+template <supported T>
+[[nodiscard]] inline pack<T> log(const pack<T> x) {
+    using k = detail::logarithm<T>;
+    if (any((x < std::numeric_limits<T>::min()) | (x >= k::limit))) {
+        return map_lanes(x, [](const T val) { return std::log(val); });
+    }
+    // x = m 2^e with m in [1, 2), then shifted to [sqrt(1/2), sqrt(2)).
+    auto e = logb(x);
+    auto m = ldexp(x, -e);
+    const auto high = m > T{1.41421356237309504880};
+    m = select(high, m * T{0.5}, m);
+    e = select(high, e + T{1}, e);
+    const auto f = m - T{1};
+    const auto z = f * f;
+    pack<T> y;
+    if constexpr (std::is_same_v<T, float>) {
+        y = detail::horner(f, k::p) * f * z;
+    } else {
+        y = f * (z * detail::horner(f, k::p) / detail::horner(f, k::q));
+    }
+    y = fma(e, pack<T>{detail::exponential<T>::ln2[1]}, y);
+    y = fma(z, pack<T>{T{-0.5}}, y);
+    return fma(e, pack<T>{detail::exponential<T>::ln2[0]}, f + y);
+}
+
+/**
+ * @brief Computes the hyperbolic tangent via a polynomial approximation near zero and via the
+ * exponential elsewhere, see `TENSOR_FAST_MATH` for accuracy.
+ */
+template <supported T>
+[[nodiscard]] inline pack<T> tanh(const pack<T> x) {
+    using k = detail::hyperbolic<T>;
+    const auto a = min(abs(x), pack<T>{k::saturation});
+    const auto z = x * x;
+    pack<T> small;
+    if constexpr (std::is_same_v<T, float>) {
+        small = fma(x * z, detail::horner(z, k::p), x);
+    } else {
+        small = fma(x * z, detail::horner(z, k::p) / detail::horner(z, k::q), x);
+    }
+    const auto large = T{1} - T{2} / (detail::exp(a + a) + T{1});
+    const auto y = select(a < T{0.625}, small, select(x < T{0}, -large, large));
+    return select(x == T{0}, x, y);
+}
+
+/**
+ * @brief Raises every lane to the power. Exponents of one and two are exact, other integral
+ * exponents are evaluated via repeated squaring if `TENSOR_FAST_MATH` is enabled.
+ */
+template <supported T, typename E>
+[[nodiscard]] inline pack<T> pow(const pack<T> x, const E exp) {
+    if (exp == 1) {
+        return x;
+    }
+    if (exp == 2) {
+        return x * x;
+    }
+#if TENSOR_FAST_MATH
+    if (std::trunc(exp) == exp && std::abs(exp) <= 64) {
+        auto n = static_cast<long>(std::abs(exp));
+        pack<T> base = x;
+        pack<T> result = T{1};
+        while (n > 0) {
+            if (n & 1) {
+                result = result * base;
+            }
+            base = base * base;
+            n >>= 1;
+        }
+        return exp < 0 ? pack<T>{T{1}} / result : result;
+    }
+#endif
+    return map_lanes(x, [exp](const T val) { return std::pow(val, exp); });
+}
+
+}  // namespace simd
+
+#endif  // SIMD_HPP
@@ -0,0 +1,587 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2022 David Oniani
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef SPARSE_HPP
+#define SPARSE_HPP
+
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "core.hpp"
+
+namespace core {
+
+/**
+ * @brief Order in which a compressed matrix stores its elements, row by row (CSR) or column by
+ * column (CSC).
+ */
+enum class sparse_layout { row, column };
+
+template <typename T, sparse_layout Layout>
+    requires std::is_arithmetic_v<T>
+class compressed_matrix;
+
+namespace detail {
+
+/**
+ * @brief Splits the rows or columns [0, majors) into blocks processed concurrently, unless the
+ * work, i.e. the number of multiply-adds, is below `parallel::threshold()`.
+ * @param majors Number of rows or columns.
+ * @param work Number of multiply-adds across all of them.
+ * @param func Callable invoked as `func(begin, end)`.
+ */
+template <typename F>
+void for_each_major(const size_type majors, const size_type work, F&& func) {
+    const auto count = parallel::threads();
+    if (count <= 1 || majors <= 1 || work < std::max<size_type>(parallel::threshold(), 1)) {
+        func(size_type{0}, majors);
+        return;
+    }
+    const auto blocks = std::min(majors, 4 * count);
+    parallel::for_each_index(blocks, [&](const size_type block) {
+        func(block * majors / blocks, (block + 1) * majors / blocks);
+    });
+}
+
+/**
+ * @brief Adds `a` times the `size` elements of `x` to those of `y`.
+ */
+template <typename T>
+void axpy(T* const y, const T* const x, const T a, const size_type size) noexcept {
+    size_type idx = 0;
+    if constexpr (simd::supported<T>) {
+        using P = simd::pack<T>;
+        const P s(a);
+        for (; idx + P::width <= size; idx += P::width) {
+            simd::fma(s, P::load(x + idx), P::load(y + idx)).store(y + idx);
+        }
+    }
+    for (; idx < size; ++idx) {
+        y[idx] += a * x[idx];
+    }
+}
+
+/**
+ * @brief Compresses (major, minor, value) triplets in any order, sorting the minor indices of
+ * every major index and summing duplicates.
+ * @return The offsets, minor indices and values of the compressed matrix.
+ */
+template <typename T>
+[[nodiscard]] auto compress(const size_type majors, const std::vector<size_type>& major,
+                            const std::vector<size_type>& minor, const std::vector<T>& values) {
+    std::vector<size_type> offsets(majors + 1, 0);
+    for (const auto idx : major) {
+        ++offsets[idx + 1];
+    }
+    std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+    std::vector<std::pair<size_type, T> > entries(values.size());
+    auto next = offsets;
+    for (size_type idx = 0; idx < values.size(); ++idx) {
+        entries[next[major[idx]]++] = {minor[idx], values[idx]};
+    }
+
+    std::vector<size_type> indices;
+    std::vector<T> result;
+    indices.reserve(entries.size());
+    result.reserve(entries.size());
+    size_type begin = 0;
+    for (size_type idx = 0; idx < majors; ++idx) {
+        const auto first = entries.begin() + static_cast<std::ptrdiff_t>(offsets[idx]);
+        const auto last = entries.begin() + static_cast<std::ptrdiff_t>(offsets[idx + 1]);
+        std::sort(first, last, [](const auto& l, const auto& r) { return l.first < r.first; });
+        for (auto it = first; it != last; ++it) {
+            if (indices.size() > begin && indices.back() == it->first) {
+                result.back() += it->second;
+            } else {
+                indices.push_back(it->first);
+                result.push_back(it->second);
+            }
+        }
+        offsets[idx] = begin;
+        begin = indices.size();
+    }
+    offsets[majors] = begin;
+    return std::make_tuple(std::move(offsets), std::move(indices), std::move(result));
+}
+
+}  // namespace detail
+
+/**
+ * @brief A sparse matrix in coordinate format, i.e. unordered (row, column, value) triplets, meant
+ * for assembling a matrix before converting it to a compressed one. Duplicates are summed on
+ * conversion.
+ * @tparam T An arithmetic type representing the type of each element.
+ */
+template <typename T>
+    requires std::is_arithmetic_v<T>
+class coo_matrix {
+   private:
+    array<2> m_extents;
+    std::vector<size_type> m_rows;
+    std::vector<size_type> m_cols;
+    std::vector<T> m_values;
+
+   public:
+    /**
+     * @brief Constructs an empty matrix.
+     * @param extents Number of rows and columns.
+     */
+    explicit coo_matrix(const array<2> extents) noexcept : m_extents{extents} {}
+
+    /**
+     * @brief Constructs a matrix holding the nonzero elements of the tensor.
+     * @param dense Tensor to convert.
+     */
+    explicit coo_matrix(const tensor<T, 2>& dense) : m_extents{dense.extents()} {
+        const auto cols = m_extents[1];
+        for (size_type idx = 0; idx < dense.size(); ++idx) {
+            if (dense.data()[idx] != T{0}) {
+                insert(idx / cols, idx % cols, dense.data()[idx]);
+            }
+        }
+    }
+
+    /**
+     * @brief Appends an element, which is added to any other one at the same position.
+     * @param row Row of the element.
+     * @param col Column of the element.
+     * @param value Value of the element.
+     */
+    void insert(const size_type row, const size_type col, const T value) {
+        if (row >= m_extents[0] || col >= m_extents[1]) {
+            throw std::out_of_range("Index out of bounds.");
+        }
+        m_rows.push_back(row);
+        m_cols.push_back(col);
+        m_values.push_back(value);
+    }
+
+    /**
+     * @brief Reserves storage for the provided number of elements.
+     * @param count Number of elements.
+     */
+    void reserve(const size_type count) {
+        m_rows.reserve(count);
+        m_cols.reserve(count);
+        m_values.reserve(count);
+    }
+
+    [[nodiscard]] auto extents() const noexcept {
+        return m_extents;
+    }
+
+    /**
+     * @brief Returns the number of stored elements, counting duplicates.
+     */
+    [[nodiscard]] size_type nnz() const noexcept {
+        return m_values.size();
+    }
+
+    [[nodiscard]] const auto& rows() const noexcept {
+        return m_rows;
+    }
+
+    [[nodiscard]] const auto& cols() const noexcept {
+        return m_cols;
+    }
+
+    [[nodiscard]] const auto& values() const noexcept {
+        return m_values;
+    }
+
+    /**
+     * @brief Converts the matrix into a compressed one.
+     * @tparam Layout Layout of the result.
+     */
+    template <sparse_layout Layout = sparse_layout::row>
+    [[nodiscard]] auto compress() const {
+        constexpr auto by_row = Layout == sparse_layout::row;
+        const auto& major = by_row ? m_rows : m_cols;
+        const auto& minor = by_row ? m_cols : m_rows;
+        auto [offsets, indices, values] =
+            detail::compress(m_extents[by_row ? 0 : 1], major, minor, m_values);
+        return compressed_matrix<T, Layout>(m_extents, std::move(offsets), std::move(indices),
+                                            std::move(values));
+    }
+
+    /**
+     * @brief Converts the matrix into a dense tensor.
+     */
+    [[nodiscard]] auto dense() const {
+        auto result = tensor<T, 2>(m_extents);
+        kernel::fill(result.data(), result.size(), T{0});
+        for (size_type idx = 0; idx < m_values.size(); ++idx) {
+            result.data()[m_rows[idx] * m_extents[1] + m_cols[idx]] += m_values[idx];
+        }
+        return result;
+    }
+};
+
+/**
+ * @brief A sparse matrix in compressed format, storing for every row (CSR) or column (CSC) the
+ * sorted indices of its elements along the other axis and their values. Transposing swaps the
+ * layout without touching the elements.
+ * @tparam T An arithmetic type representing the type of each element.
+ * @tparam Layout Whether elements are stored row by row or column by column.
+ */
+template <typename T, sparse_layout Layout>
+    requires std::is_arithmetic_v<T>
+class compressed_matrix {
+   private:
+    static constexpr auto major_axis = Layout == sparse_layout::row ? 0 : 1;
+
+    array<2> m_extents;
+    std::vector<size_type> m_offsets;
+    std::vector<size_type> m_indices;
+    std::vector<T> m_values;
+
+   public:
+    using value_type = T;
+    static constexpr sparse_layout layout = Layout;
+
+    /**
+     * @brief Constructs a matrix from its compressed representation.
+     * @param extents Number of rows and columns.
+     * @param offsets Position of the first element of every row or column in `indices`, followed
+     * by the number of elements.
+     * @param indices Column or row of every element, sorted within each row or column.
+     * @param values Value of every element.
+     */
+    compressed_matrix(const array<2> extents, std::vector<size_type> offsets,
+                      std::vector<size_type> indices, std::vector<T> values)
+        : m_extents{extents},
+          m_offsets{std::move(offsets)},
+          m_indices{std::move(indices)},
+          m_values{std::move(values)} {
+        if (m_offsets.size() != m_extents[major_axis] + 1 || m_offsets.front() != 0 ||
+            m_offsets.back() != m_values.size() || m_indices.size() != m_values.size() ||
+            !std::is_sorted(m_offsets.begin(), m_offsets.end())) {
+            throw std::runtime_error("Tensor dimension mismatch.");
+        }
+        const auto minors = m_extents[1 - major_axis];
+        if (std::any_of(m_indices.begin(), m_indices.end(),
+                        [minors](const size_type idx) { return idx >= minors; })) {
+            throw std::out_of_range("Index out of bounds.");
+        }
+    }
+
+    /**
+     * @brief Constructs a matrix holding the nonzero elements of the tensor.
+     * @param dense Tensor to convert.
+     */
+    explicit compressed_matrix(const tensor<T, 2>& dense)
+        : compressed_matrix(coo_matrix<T>(dense).template compress<Layout>()) {}
+
+    [[nodiscard]] auto extents() const noexcept {
+        return m_extents;
+    }
+
+    /**
+     * @brief Returns the number of stored elements.
+     */
+    [[nodiscard]] size_type nnz() const noexcept {
+        return m_values.size();
+    }
+
+    [[nodiscard]] const auto& offsets() const noexcept {
+        return m_offsets;
+    }
+
+    [[nodiscard]] const auto& indices() const noexcept {
+        return m_indices;
+    }
+
+    [[nodiscard]] const auto& values() const noexcept {
+        return m_values;
+    }
+
+    /**
+     * @brief Converts the matrix into a dense tensor.
+     */
+    [[nodiscard]] auto dense() const {
+        auto result = tensor<T, 2>(m_extents);
+        kernel::fill(result.data(), result.size(), T{0});
+        const auto cols = m_extents[1];
+        for (size_type major = 0; major + 1 < m_offsets.size(); ++major) {
+            for (auto idx = m_offsets[major]; idx < m_offsets[major + 1]; ++idx) {
+                const auto minor = m_indices[idx];
+                const auto pos = Layout == sparse_layout::row ? major * cols + minor
+                                                              : minor * cols + major;
+                result.data()[pos] = m_values[idx];
+            }
+        }
+        return result;
+    }
+
+    /**
+     * @brief Returns the transpose, which stores the same elements in the other layout.
+     */
+    [[nodiscard]] auto transpose() const& {
+        return compressed_matrix<T, other()>({m_extents[1], m_extents[0]}, m_offsets, m_indices,
+                                             m_values);
+    }
+
+    /**
+     * @brief Returns the transpose, taking over the elements of the expiring matrix.
+     */
+    [[nodiscard]] auto transpose() && {
+        return compressed_matrix<T, other()>({m_extents[1], m_extents[0]}, std::move(m_offsets),
+                                             std::move(m_indices), std::move(m_values));
+    }
+
+    /**
+     * @brief Multiplies every element by the value in place.
+     * @param val Value to be multiplied by every element.
+     * @return Reference to the matrix.
+     */
+    auto& operator*=(const T val) {
+        kernel::transform(m_values.data(), m_values.data(), val, m_values.size(), op::mul{});
+        return *this;
+    }
+
+    /**
+     * @brief Divides every element by the value in place.
+     * @param val Value to divide every element by, which must not be zero.
+     * @return Reference to the matrix.
+     */
+    auto& operator/=(const T val) {
+        if (val == 0) {
+            throw std::domain_error("Division by zero.");
+        }
+        kernel::transform(m_values.data(), m_values.data(), val, m_values.size(), op::div{});
+        return *this;
+    }
+
+    /**
+     * @param val Value to be multiplied by every element.
+     * @return Matrix with every element multiplied by `val`.
+     */
+    [[nodiscard]] auto operator*(const T val) const {
+        auto result = *this;
+        result *= val;
+        return result;
+    }
+
+    /**
+     * @param val Value to divide every element by, which must not be zero.
+     * @return Matrix with every element divided by `val`.
+     */
+    [[nodiscard]] auto operator/(const T val) const {
+        auto result = *this;
+        result /= val;
+        return result;
+    }
+
+    /**
+     * @brief Adds the value to every element, including the zeros, so the result is dense.
+     * @param val Value to be added to every element.
+     * @return Dense tensor with every element incremented by `val`.
+     */
+    [[nodiscard]] auto operator+(const T val) const {
+        return dense() + val;
+    }
+
+    /**
+     * @brief Subtracts the value from every element, including the zeros, so the result is dense.
+     * @param val Value to be subtracted from every element.
+     * @return Dense tensor with every element decremented by `val`.
+     */
+    [[nodiscard]] auto operator-(const T val) const {
+        return dense() - val;
+    }
+
+    /**
+     * @brief Adds every element to the dense tensor in place, in parallel over rows or columns.
+     * @param t Tensor of the same extents.
+     * @param sign Factor of the elements, one to add them or minus one to subtract them.
+     */
+    void scatter_to(tensor<T, 2>& t, const T sign = T{1}) const {
+        if (t.extents() != m_extents) {
+            throw std::runtime_error("Tensor dimension mismatch.");
+        }
+        const auto cols = m_extents[1];
+        auto* const data = t.data();
+        detail::for_each_major(m_extents[major_axis], nnz(), [&](const auto begin, const auto end) {
+            for (auto major = begin; major < end; ++major) {
+                for (auto idx = m_offsets[major]; idx < m_offsets[major + 1]; ++idx) {
+                    const auto minor = m_indices[idx];
+                    const auto pos = Layout == sparse_layout::row ? major * cols + minor
+                                                                  : minor * cols + major;
+                    data[pos] += sign * m_values[idx];
+                }
+            }
+        });
+    }
+
+   private:
+    [[nodiscard]] static constexpr sparse_layout other() noexcept {
+        return Layout == sparse_layout::row ? sparse_layout::column : sparse_layout::row;
+    }
+};
+
+/**
+ * @brief A sparse matrix stored row by row, also known as CSR.
+ */
+template <typename T>
+using csr_matrix = compressed_matrix<T, sparse_layout::row>;
+
+/**
+ * @brief A sparse matrix stored column by column, also known as CSC.
+ */
+template <typename T>
+using csc_matrix = compressed_matrix<T, sparse_layout::column>;
+
+/**
+ * @brief Adds the sparse matrix to the dense tensor.
+ * @return Dense tensor holding the sum.
+ */
+template <typename T, sparse_layout Layout>
+[[nodiscard]] auto operator+(const compressed_matrix<T, Layout>& lhs, tensor<T, 2> rhs) {
+    lhs.scatter_to(rhs);
+    return std::move(rhs).take();
+}
+
+/**
+ * @brief Adds the dense tensor to the sparse matrix.
+ * @return Dense tensor holding the sum.
+ */
+template <typename T, sparse_layout Layout>
+[[nodiscard]] auto operator+(tensor<T, 2> lhs, const compressed_matrix<T, Layout>& rhs) {
+    rhs.scatter_to(lhs);
+    return std::move(lhs).take();
+}
+
+/**
+ * @brief Subtracts the sparse matrix from the dense tensor.
+ * @return Dense tensor holding the difference.
+ */
+template <typename T, sparse_layout Layout>
+[[nodiscard]] auto operator-(tensor<T, 2> lhs, const compressed_matrix<T, Layout>& rhs) {
+    rhs.scatter_to(lhs, T{0} - T{1});
+    return std::move(lhs).take();
+}
+
+/**
+ * @brief Multiplies a sparse matrix by a dense one (SpMM). Rows of the result are computed in
+ * parallel for CSR, runs of its columns for CSC, so that no two threads write the same element.
+ * @param lhs Sparse matrix of extents {m, k}.
+ * @param rhs Dense matrix of extents {k, n}.
+ * @return A dense tensor of extents {m, n}.
+ */
+template <typename T, sparse_layout Layout>
+[[nodiscard]] auto matmul(const compressed_matrix<T, Layout>& lhs, const tensor<T, 2>& rhs) {
+    const auto [m, k] = lhs.extents();
+    const auto n = rhs.extents()[1];
+    if (k != rhs.extents()[0]) {
+        throw std::runtime_error("Tensor dimension mismatch.");
+    }
+    auto result = tensor<T, 2>(array<2>{m, n});
+    kernel::fill(result.data(), result.size(), T{0});
+    const auto& offsets = lhs.offsets();
+    const auto& indices = lhs.indices();
+    const auto& values = lhs.values();
+    const auto* const b = rhs.data();
+    auto* const c = result.data();
+
+    if constexpr (Layout == sparse_layout::row) {
+        detail::for_each_major(m, lhs.nnz() * n, [&](const size_type begin, const size_type end) {
+            for (auto row = begin; row < end; ++row) {
+                for (auto idx = offsets[row]; idx < offsets[row + 1]; ++idx) {
+                    detail::axpy(c + row * n, b + indices[idx] * n, values[idx], n);
+                }
+            }
+        });
+    } else {
+        // Columns of the result are split in runs a multiple of a cache line wide.
+        constexpr size_type run = 64 / sizeof(T);
+        const auto runs = (n + run - 1) / run;
+        detail::for_each_major(runs, lhs.nnz() * n, [&](const auto begin, const auto end) {
+            const auto first = begin * run;
+            const auto width = std::min(end * run, n) - first;
+            for (size_type col = 0; col < k; ++col) {
+                for (auto idx = offsets[col]; idx < offsets[col + 1]; ++idx) {
+                    detail::axpy(c + indices[idx] * n + first, b + col * n + first, values[idx],
+                                 width);
+                }
+            }
+        });
+    }
+    return result;
+}
+
+/**
+ * @brief Multiplies a dense matrix by a sparse one. Rows of the result are computed in parallel.
+ * @param lhs Dense matrix of extents {m, k}.
+ * @param rhs Sparse matrix of extents {k, n}.
+ * @return A dense tensor of extents {m, n}.
+ */
+template <typename T, sparse_layout Layout>
+[[nodiscard]] auto matmul(const tensor<T, 2>& lhs, const compressed_matrix<T, Layout>& rhs) {
+    const auto [m, k] = lhs.extents();
+    const auto n = rhs.extents()[1];
+    if (k != rhs.extents()[0]) {
+        throw std::runtime_error("Tensor dimension mismatch.");
+    }
+    auto result = tensor<T, 2>(array<2>{m, n});
+    kernel::fill(result.data(), result.size(), T{0});
+    const auto& offsets = rhs.offsets();
+    const auto& indices = rhs.indices();
+    const auto& values = rhs.values();
+    const auto* const a = lhs.data();
+    auto* const c = result.data();
+
+    detail::for_each_major(m, rhs.nnz() * m, [&](const size_type begin, const size_type end) {
+        for (auto row = begin; row < end; ++row) {
+            if constexpr (Layout == sparse_layout::row) {
+                // Row `row` of the result accumulates row `p` of B scaled by A(row, p).
+                for (size_type p = 0; p < k; ++p) {
+                    const auto scale = a[row * k + p];
+                    for (auto idx = offsets[p]; idx < offsets[p + 1]; ++idx) {
+                        c[row * n + indices[idx]] += scale * values[idx];
+                    }
+                }
+            } else {
+                // Every element of the row is the dot product with a sparse column of B.
+                for (size_type col = 0; col < n; ++col) {
+                    T sum{0};
+                    for (auto idx = offsets[col]; idx < offsets[col + 1]; ++idx) {
+                        sum += a[row * k + indices[idx]] * values[idx];
+                    }
+                    c[row * n + col] = sum;
+                }
+            }
+        }
+    });
+    return result;
+}
+
+}  // namespace core
+
+#endif  // SPARSE_HPP
@@ -0,0 +1,533 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2022 David Oniani
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef STATIC_HPP
+#define STATIC_HPP
+
+#include <algorithm>
+#include <array>
+#include <initializer_list>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "view.hpp"
+
+namespace core {
+
+namespace detail {
+
+// Loops over at most this many elements are unrolled completely, longer ones are left to the
+// compiler, which still sees a constant trip count.
+inline constexpr size_type unroll_limit = 64;
+
+/**
+ * @brief Calls the function with every index below `N`, unrolled if `N` is at most
+ * `unroll_limit`.
+ */
+template <size_type N, typename F>
+constexpr void unroll(const F& f) {
+    if constexpr (N <= unroll_limit) {
+        [&]<size_type... I>(std::index_sequence<I...>) {
+            (f(I), ...);
+        }(std::make_index_sequence<N>{});
+    } else {
+        for (size_type idx = 0; idx < N; ++idx) {
+            f(idx);
+        }
+    }
+}
+
+}  // namespace detail
+
+/**
+ * @brief Defines a tensor whose extents are part of its type, e.g. `static_tensor<float, 3, 3>`
+ * for a rotation matrix. Elements are stored inline in row-major order, so the tensor never
+ * allocates and is usable in constant expressions in its entirety. Element-wise loops have a trip
+ * count known at compile time and are unrolled for small tensors. The tensor converts to and from
+ * `tensor`, and takes part in expressions and reductions alongside dynamic tensors and views.
+ * @tparam T An arithmetic type representing the type of each element in tensor.
+ * @tparam Dims The NTTPs representing the extents of the tensor.
+ */
+template <arithmetic T, size_type... Dims>
+    requires(sizeof...(Dims) > 0)
+class static_tensor {
+   public:
+    using value_type = T;
+    static constexpr size_type order = sizeof...(Dims);
+    static constexpr array<order> static_extents{Dims...};
+    static constexpr array<order> static_strides = detail::row_major_strides(static_extents);
+    static constexpr size_type static_size = (Dims * ...);
+
+   private:
+    std::array<T, static_size> m_data{};
+
+    template <typename Op>
+    constexpr auto& apply(const static_tensor& other, const Op operation) {
+        detail::unroll<static_size>(
+            [&](const size_type idx) { m_data[idx] = operation(m_data[idx], other.m_data[idx]); });
+        return *this;
+    }
+
+    template <typename Op>
+    constexpr auto& apply(const arithmetic auto& val, const Op operation) {
+        detail::unroll<static_size>(
+            [&](const size_type idx) { m_data[idx] = operation(m_data[idx], val); });
+        return *this;
+    }
+
+    template <typename Op>
+    [[nodiscard]] constexpr auto map(const Op operation) const {
+        auto result = *this;
+        detail::unroll<static_size>(
+            [&](const size_type idx) { result.m_data[idx] = operation(m_data[idx]); });
+        return result;
+    }
+
+    [[nodiscard]] constexpr bool has_zero() const noexcept {
+        return std::find(m_data.begin(), m_data.end(), T{0}) != m_data.end();
+    }
+
+    [[nodiscard]] constexpr size_type offset(const array<order>& idxs) const {
+        size_type flat_idx = 0;
+        for (size_type idx = 0; idx < order; ++idx) {
+            if (idxs[idx] >= static_extents[idx]) {
+                throw std::out_of_range("Index out of bounds.");
+            }
+            flat_idx += idxs[idx] * static_strides[idx];
+        }
+        return flat_idx;
+    }
+
+   public:
+    /**
+     * @brief Constructs a tensor of zeros.
+     */
+    constexpr static_tensor() noexcept = default;
+
+    /**
+     * @brief Constructs a tensor from its elements in row-major order.
+     * @param values Initializer list holding exactly `static_size` values.
+     */
+    constexpr static_tensor(std::initializer_list<T> values) {
+        if (values.size() != static_size) {
+            throw std::runtime_error("Tensor dimension mismatch.");
+        }
+        std::copy(values.begin(), values.end(), m_data.begin());
+    }
+
+    /**
+     * @brief Constructs a tensor by copying a dynamic tensor of the same extents.
+     * @param t Dynamic tensor.
+     */
+    constexpr explicit static_tensor(const tensor<T, order>& t) {
+        if (t.extents() != static_extents) {
+            throw std::runtime_error("Tensor dimension mismatch.");
+        }
+        std::copy(t.data(), t.data() + static_size, m_data.begin());
+    }
+
+    /**
+     * @brief Constructs a tensor by evaluating the expression of the same extents in a single pass.
+     * @param expr Lazily evaluated expression or view.
+     */
+    template <expression E>
+        requires(E::order == order)
+    constexpr explicit static_tensor(const E& expr) {
+        *this = expr;
+    }
+
+    /**
+     * @brief Assigns the result of evaluating the expression of the same extents in a single pass.
+     * @param expr Lazily evaluated expression or view.
+     */
+    template <expression E>
+        requires(E::order == order)
+    constexpr auto& operator=(const E& expr) {
+        if (expr.extents() != static_extents) {
+            throw std::runtime_error("Tensor dimension mismatch.");
+        }
+        detail::unroll<static_size>([&](const size_type idx) { m_data[idx] = expr[idx]; });
+        return *this;
+    }
+
+    /**
+     * @brief Defines an operator for getting raw data. Bounds are only checked if
+     * `TENSOR_BOUNDS_CHECK` is enabled, which is the default for builds without `NDEBUG`.
+     * @param idx Index for obtaining a value.
+     */
+    [[nodiscard]] constexpr auto& operator[](const size_type idx) {
+#if TENSOR_BOUNDS_CHECK
+        return at(idx);
+#else
+        return m_data[idx];
+#endif
+    }
+
+    /**
+     * @brief Defines an operator for getting raw data. Bounds are only checked if
+     * `TENSOR_BOUNDS_CHECK` is enabled, which is the default for builds without `NDEBUG`.
+     * @param idx Index for obtaining a value.
+     */
+    [[nodiscard]] constexpr auto& operator[](const size_type idx) const {
+#if TENSOR_BOUNDS_CHECK
+        return at(idx);
+#else
+        return m_data[idx];
+#endif
+    }
+
+    /**
+     * @brief Returns raw data at the provided index with bounds checking.
+     * @param idx Index for obtaining a value.
+     */
+    [[nodiscard]] constexpr auto& at(const size_type idx) {
+        if (idx >= static_size) {
+            throw std::out_of_range("Index out of bounds.");
+        }
+        return m_data[idx];
+    }
+
+    /**
+     * @brief Returns raw data at the provided index with bounds checking.
+     * @param idx Index for obtaining a value.
+     */
+    [[nodiscard]] constexpr auto& at(const size_type idx) const {
+        if (idx >= static_size) {
+            throw std::out_of_range("Index out of bounds.");
+        }
+        return m_data[idx];
+    }
+
+    /**
+     * @brief Returns the element at the provided indices with bounds checking.
+     * @param idxs Array of indices, one per axis.
+     */
+    [[nodiscard]] constexpr auto& get(const array<order> idxs) {
+        return m_data[offset(idxs)];
+    }
+
+    /**
+     * @brief Returns the element at the provided indices with bounds checking.
+     * @param idxs Array of indices, one per axis.
+     */
+    [[nodiscard]] constexpr auto& get(const array<order> idxs) const {
+        return m_data[offset(idxs)];
+    }
+
+    /**
+     * @brief Returns a pointer to the elements.
+     * @return A pointer to the elements.
+     */
+    [[nodiscard]] constexpr auto data() noexcept {
+        return m_data.data();
+    }
+
+    /**
+     * @brief Returns a pointer to the elements.
+     * @return A pointer to the elements.
+     */
+    [[nodiscard]] constexpr auto data() const noexcept {
+        return m_data.data();
+    }
+
+    /**
+     * @brief Returns the extents.
+     * @return Extents.
+     */
+    [[nodiscard]] static constexpr auto extents() noexcept {
+        return static_extents;
+    }
+
+    /**
+     * @brief Returns the size of the tensor.
+     * @return Size of the tensor.
+     */
+    [[nodiscard]] static constexpr auto size() noexcept {
+        return static_size;
+    }
+
+    /**
+     * @brief Returns a view sharing the data of the tensor, see `tensor_view`.
+     * @return A view of the whole tensor.
+     */
+    [[nodiscard]] constexpr auto view() noexcept {
+        return tensor_view<T, order>(m_data.data(), static_extents, static_strides);
+    }
+
+    /**
+     * @brief Returns a read-only view sharing the data of the tensor, see `tensor_view`.
+     * @return A read-only view of the whole tensor.
+     */
+    [[nodiscard]] constexpr auto view() const noexcept {
+        return tensor_view<const T, order>(m_data.data(), static_extents, static_strides);
+    }
+
+    /**
+     * @brief Copies the tensor into a dynamic tensor allocated from the default resource.
+     * @return Dynamic tensor of the same extents and elements.
+     */
+    [[nodiscard]] constexpr auto to_tensor() const {
+        auto result = tensor<T, order>(static_extents);
+        std::copy(m_data.begin(), m_data.end(), result.data());
+        return result;
+    }
+
+    /**
+     * @brief Adds the other tensor to the tensor in place.
+     * @param other Other tensor.
+     * @return Reference to the tensor.
+     */
+    constexpr auto& operator+=(const static_tensor& other) {
+        return apply(other, op::add{});
+    }
+
+    /**
+     * @brief Subtracts the other tensor from the tensor in place.
+     * @param other Other tensor.
+     * @return Reference to the tensor.
+     */
+    constexpr auto& operator-=(const static_tensor& other) {
+        return apply(other, op::sub{});
+    }
+
+    /**
+     * @brief Multiplies the tensor by the other tensor element-wise in place.
+     * @param other Other tensor.
+     * @return Reference to the tensor.
+     */
+    constexpr auto& operator*=(const static_tensor& other) {
+        return apply(other, op::mul{});
+    }
+
+    /**
+     * @brief Divides the tensor by the other tensor element-wise in place. The tensor is left
+     * untouched if the other tensor holds a zero.
+     * @param other Other tensor.
+     * @return Reference to the tensor.
+     */
+    constexpr auto& operator/=(const static_tensor& other) {
+        if (other.has_zero()) {
+            throw std::domain_error("Division by zero.");
+        }
+        return apply(other, [](const T lhs, const T rhs) { return lhs / rhs; });
+    }
+
+    /**
+     * @brief Broadcasts in-place addition via the specified value.
+     * @param val Value to be added to every element of the tensor.
+     * @return Reference to the tensor.
+     */
+    constexpr auto& operator+=(const arithmetic auto& val) {
+        return apply(val, op::add{});
+    }
+
+    /**
+     * @brief Broadcasts in-place subtraction via the specified value.
+     * @param val Value to be subtracted from every element of the tensor.
+     * @return Reference to the tensor.
+     */
+    constexpr auto& operator-=(const arithmetic auto& val) {
+        return apply(val, op::sub{});
+    }
+
+    /**
+     * @brief Broadcasts in-place multiplication via the specified value.
+     * @param val Value to be multiplied by every element of the tensor.
+     * @return Reference to the tensor.
+     */
+    constexpr auto& operator*=(const arithmetic auto& val) {
+        return apply(val, op::mul{});
+    }
+
+    /**
+     * @brief Broadcasts in-place division via the specified value.
+     * @param val Value to be divided by every element of the tensor.
+     * @return Reference to the tensor.
+     */
+    constexpr auto& operator/=(const arithmetic auto& val) {
+        if (val == 0) {
+            throw std::domain_error("Division by zero.");
+        }
+        return apply(val, op::div{});
+    }
+
+    /**
+     * @brief Adds the other tensor to the tensor.
+     * @param other Other tensor.
+     * @return New tensor representing the result of the addition.
+     */
+    [[nodiscard]] constexpr auto operator+(const static_tensor& other) const {
+        auto result = *this;
+        return result += other;
+    }
+
+    /**
+     * @brief Subtracts the other tensor from the tensor.
+     * @param other Other tensor.
+     * @return New tensor representing the result of the subtraction.
+     */
+    [[nodiscard]] constexpr auto operator-(const static_tensor& other) const {
+        auto result = *this;
+        return result -= other;
+    }
+
+    /**
+     * @brief Multiplies the tensor by the other tensor element-wise.
+     * @param other Other tensor.
+     * @return New tensor representing the result of the multiplication.
+     */
+    [[nodiscard]] constexpr auto operator*(const static_tensor& other) const {
+        auto result = *this;
+        return result *= other;
+    }
+
+    /**
+     * @brief Divides the tensor by the other tensor element-wise.
+     * @param other Other tensor.
+     * @return New tensor representing the result of the division.
+     */
+    [[nodiscard]] constexpr auto operator/(const static_tensor& other) const {
+        auto result = *this;
+        return result /= other;
+    }
+
+    /**
+     * @brief Broadcasts addition via the specified value.
+     * @param val Value to be added to every element of the tensor.
+     * @return New tensor representing the result of the addition.
+     */
+    [[nodiscard]] constexpr auto operator+(const arithmetic auto& val) const {
+        auto result = *this;
+        return result += val;
+    }
+
+    /**
+     * @brief Broadcasts subtraction via the specified value.
+     * @param val Value to be subtracted from every element of the tensor.
+     * @return New tensor representing the result of the subtraction.
+     */
+    [[nodiscard]] constexpr auto operator-(const arithmetic auto& val) const {
+        auto result = *this;
+        return result -= val;
+    }
+
+    /**
+     * @brief Broadcasts multiplication via the specified value.
+     * @param val Value to be multiplied by every element of the tensor.
+     * @return New tensor representing the result of the multiplication.
+     */
+    [[nodiscard]] constexpr auto operator*(const arithmetic auto& val) const {
+        auto result = *this;
+        return result *= val;
+    }
+
+    /**
+     * @brief Broadcasts division via the specified value.
+     * @param val Value to be divided by every element of the tensor.
+     * @return New tensor representing the result of the division.
+     */
+    [[nodiscard]] constexpr auto operator/(const arithmetic auto& val) const {
+        auto result = *this;
+        return result /= val;
+    }
+
+    /**
+     * @brief Returns true if every element equals the one of the other tensor, false otherwise.
+     * @param other Other tensor.
+     * @return `true` if the comparison holds, `false` otherwise.
+     */
+    [[nodiscard]] constexpr bool operator==(const static_tensor& other) const = default;
+
+    /**
+     * @brief Broadcasts the power operation.
+     * @param exp Exponent.
+     * @return New tensor with every value transformed via the power function.
+     */
+    [[nodiscard]] constexpr auto pow(const arithmetic auto exp) const {
+        return map(op::pow<std::remove_cvref_t<decltype(exp)> >{exp});
+    }
+
+    /**
+     * @brief Broadcasts the square operation.
+     * @return New tensor with every value squared.
+     */
+    [[nodiscard]] constexpr auto square() const {
+        return map(op::square{});
+    }
+
+    /**
+     * @brief Broadcasts the square root operation.
+     * @return New tensor with every value transformed via the square root function.
+     */
+    [[nodiscard]] constexpr auto sqrt() const {
+        return map(op::sqrt{});
+    }
+};
+
+/**
+ * @brief Starts a lazily evaluated expression from the static tensor, which has to outlive the
+ * expression, so that it can be combined with dynamic tensors and views.
+ * @param t Static tensor to start the expression from.
+ * @return A read-only view of the tensor.
+ */
+template <arithmetic T, size_type... Dims>
+[[nodiscard]] constexpr auto lazy(const static_tensor<T, Dims...>& t) noexcept {
+    return t.view();
+}
+
+template <arithmetic T, size_type... Dims>
+auto lazy(const static_tensor<T, Dims...>&& t) = delete;
+
+namespace detail {
+
+// Static tensors are operands of the lazy operators and reductions just like dynamic ones.
+template <arithmetic T, size_type... Dims>
+struct is_tensor<static_tensor<T, Dims...> > : std::true_type {};
+
+}  // namespace detail
+
+/**
+ * @brief Multiplies two static matrices with every loop unrolled for small extents.
+ * @param lhs Left-hand side of extents {M, K}.
+ * @param rhs Right-hand side of extents {K, N}.
+ * @return A static tensor of extents {M, N}.
+ */
+template <arithmetic T, size_type M, size_type K, size_type N>
+[[nodiscard]] constexpr auto matmul(const static_tensor<T, M, K>& lhs,
+                                    const static_tensor<T, K, N>& rhs) noexcept {
+    static_tensor<T, M, N> result;
+    detail::unroll<M * K>([&](const size_type idx) {
+        const auto row = idx / K;
+        const auto val = lhs.data()[idx];
+        const auto* src = rhs.data() + idx % K * N;
+        auto* dst = result.data() + row * N;
+        detail::unroll<N>([&](const size_type col) { dst[col] += val * src[col]; });
+    });
+    return result;
+}
+
+}  // namespace core
+
+#endif  // STATIC_HPP
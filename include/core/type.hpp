@@ -26,6 +26,7 @@
 #define TYPE_HPP
 
 #include "core.hpp"
+#include "sparse.hpp"
 
 namespace type {
 
@@ -85,6 +86,27 @@ using tensor7 = core::tensor<T, 7>;
 template <arithmetic T>
 using tensor8 = core::tensor<T, 8>;
 
+/**
+ * @brief Constructs a type representing a sparse matrix in coordinate format.
+ * @tparam T Arithmetic type representing the type of every element in the returned matrix.
+ */
+template <typename T>
+using coo_matrix = core::coo_matrix<T>;
+
+/**
+ * @brief Constructs a type representing a sparse matrix stored row by row.
+ * @tparam T Arithmetic type representing the type of every element in the returned matrix.
+ */
+template <typename T>
+using csr_matrix = core::csr_matrix<T>;
+
+/**
+ * @brief Constructs a type representing a sparse matrix stored column by column.
+ * @tparam T Arithmetic type representing the type of every element in the returned matrix.
+ */
+template <typename T>
+using csc_matrix = core::csc_matrix<T>;
+
 }  // namespace type
 
 #endif  // TYPE_HPP
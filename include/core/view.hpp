@@ -0,0 +1,617 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2022 David Oniani
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef VIEW_HPP
+#define VIEW_HPP
+
+#include <algorithm>
+#include <functional>
+#include <type_traits>
+#include <utility>
+
+#include "expr.hpp"
+
+namespace core {
+
+/**
+ * @brief Defines a non-owning, strided window into the data of a tensor. Slicing, ranges and
+ * transposition only compute new extents and strides, so the viewed tensor must outlive the view.
+ * Views are expressions and can be used wherever tensors are accepted by the lazy operators, in
+ * which case elements are visited in row-major order of the view. Copying a view shares the data,
+ * whereas assigning to a view writes its elements.
+ * @tparam T An arithmetic type representing the type of each element, `const` for read-only views.
+ * @tparam Order The NTTP representing the order of the view.
+ */
+template <typename T, size_type Order>
+    requires arithmetic<std::remove_const_t<T> >
+class tensor_view : public expr_base<tensor_view<T, Order> > {
+   private:
+    T* m_data;
+    array<Order> m_extents;
+    array<Order> m_strides;
+    size_type m_size;
+    kernel::layout<Order> m_layout;
+
+    /**
+     * @brief Combines every element of the view with the corresponding value of the operand,
+     * which is broadcast to the extents of the view if they differ.
+     * @param rhs Expression, tensor or scalar.
+     * @param operation Element-wise operation, where `nullptr` denotes plain assignment.
+     */
+    template <typename Op>
+    constexpr void apply(const auto& rhs, const Op operation) const {
+        const auto r = detail::as_expr(rhs);
+        using R = std::remove_cvref_t<decltype(r)>;
+        if constexpr (arithmetic<R>) {
+            assign(r, operation);
+        } else {
+            if constexpr (R::order == Order) {
+                if (m_extents == r.extents()) {
+                    assign(r, operation);
+                    return;
+                }
+            }
+            assign(core::broadcast_to(r, m_extents), operation);
+        }
+    }
+
+    /**
+     * @brief Combines every element of the view with the corresponding value of the operand, row
+     * by row along the innermost axis of the collapsed layout. Since a scalar is the same for every
+     * element, elements are then visited in the order of memory.
+     * @param r Expression of the same extents or scalar.
+     * @param operation Element-wise operation, where `nullptr` denotes plain assignment.
+     */
+    template <typename Op>
+    constexpr void assign(const auto& r, const Op operation) const {
+        if constexpr (arithmetic<std::remove_cvref_t<decltype(r)> >) {
+            const auto ordered = memory_order();
+            if constexpr (std::is_same_v<Op, std::nullptr_t>) {
+                kernel::fill(m_data, ordered.m_layout, static_cast<value_type>(r));
+            } else {
+                kernel::transform(m_data, ordered.m_layout, r, operation);
+            }
+        } else if constexpr (std::is_same_v<Op, std::nullptr_t>) {
+            kernel::evaluate(m_data, m_layout, r);
+        } else {
+            kernel::update(m_data, m_layout, r, operation);
+        }
+    }
+
+    /**
+     * @brief Loads `count` elements of a row from the provided one on, filling lanes past `count`
+     * with ones as partial loads do.
+     */
+    template <typename V>
+    [[nodiscard]] static simd::pack<V> within_row(const T* data, const size_type stride,
+                                                  const size_type count) {
+        using P = simd::pack<V>;
+        if (stride == 1) {
+            return count == P::width ? simd::load(data) : simd::load_partial(data, count);
+        }
+        if (stride == 0) {
+            return P(static_cast<V>(*data));
+        }
+        if (count == P::width) {
+            return simd::load_strided(data, stride);
+        }
+        alignas(P) V buf[P::width];
+        for (size_type lane = 0; lane < count; ++lane) {
+            buf[lane] = static_cast<V>(data[lane * stride]);
+        }
+        std::fill(buf + count, buf + P::width, V{1});
+        return P::load(buf);
+    }
+
+    /**
+     * @brief Loads the elements [idx, idx + count) of a non-contiguous view, with a single
+     * contiguous or broadcast load if they lie within a row of the collapsed layout, and otherwise
+     * stepping from element to element, moving to the next row without recomputing the offset.
+     */
+    template <typename V>
+    [[nodiscard]] simd::pack<V> gather(const size_type idx, const size_type count) const {
+        using P = simd::pack<V>;
+        const auto length = m_layout.length();
+        const auto stride = m_layout.stride();
+        auto row = idx / length;
+        auto col = idx % length;
+        const auto* data = m_data + m_layout.row_offset(row) + col * stride;
+        if (col + count <= length) {
+            return within_row<V>(data, stride, count);
+        }
+        alignas(P) V buf[P::width];
+        for (size_type lane = 0; lane < P::width; ++lane) {
+            if (lane >= count) {
+                buf[lane] = V{1};
+                continue;
+            }
+            buf[lane] = static_cast<V>(*data);
+            if (lane + 1 == count) {
+                continue;
+            }
+            if (++col < length) {
+                data += stride;
+            } else {
+                col = 0;
+                data = m_data + m_layout.row_offset(++row);
+            }
+        }
+        return P::load(buf);
+    }
+
+    /**
+     * @brief Walks the view pack by pack, stepping along the rows of the collapsed layout and
+     * locating the next row only once the current one is used up. Contiguous views are walked as
+     * a single row.
+     */
+    class row_cursor {
+       private:
+        const tensor_view* m_view;
+        const T* m_data;
+        size_type m_idx;
+        size_type m_row{0};
+        size_type m_col;
+        size_type m_length;
+        size_type m_stride{1};
+
+       public:
+        row_cursor(const tensor_view& view, const size_type idx) noexcept
+            : m_view{&view},
+              m_data{view.m_data + idx},
+              m_idx{idx},
+              m_col{idx},
+              m_length{view.m_size} {
+            if (!view.m_layout.is_contiguous() && view.m_size != 0) {
+                m_length = view.m_layout.length();
+                m_stride = view.m_layout.stride();
+                m_row = idx / m_length;
+                m_col = idx % m_length;
+                m_data = view.m_data + view.m_layout.row_offset(m_row) + m_col * m_stride;
+            }
+        }
+
+        template <typename V>
+        [[nodiscard]] simd::pack<V> load(const size_type count) const {
+            using P = simd::pack<V>;
+            if (m_col + count > m_length) {
+                return m_view->template gather<V>(m_idx, count);
+            }
+            if (count != P::width || m_stride == 0) {
+                return within_row<V>(m_data, m_stride, count);
+            }
+            return m_stride == 1 ? simd::load(m_data) : simd::load_strided(m_data, m_stride);
+        }
+
+        void advance(const size_type count) noexcept {
+            m_idx += count;
+            m_col += count;
+            if (m_col < m_length) {
+                m_data += count * m_stride;
+                return;
+            }
+            m_row += m_col / m_length;
+            m_col %= m_length;
+            m_data = m_view->m_data + m_view->m_layout.row_offset(m_row) + m_col * m_stride;
+        }
+    };
+
+   public:
+    using value_type = std::remove_const_t<T>;
+    static constexpr size_type order = Order;
+    static constexpr bool is_expression = true;
+
+    template <typename V>
+    static constexpr bool vectorizable =
+        simd::loadable<value_type> && std::is_same_v<simd::lane_t<value_type>, V>;
+
+    /**
+     * @brief Constructs a view of the data with the provided extents and strides.
+     * @param data Pointer to the first element of the view.
+     * @param extents Extents of the view.
+     * @param strides Distance between consecutive elements along every axis.
+     */
+    constexpr tensor_view(T* data, const array<Order> extents, const array<Order> strides) noexcept
+        : m_data{data},
+          m_extents{extents},
+          m_strides{strides},
+          m_size{std::reduce(extents.begin(), extents.end(), size_type{1},
+                             std::multiplies<size_type>())},
+          m_layout{extents, strides} {}
+
+    /**
+     * @brief Converts a mutable view into a read-only one.
+     */
+    constexpr operator tensor_view<const T, Order>() const noexcept
+        requires(!std::is_const_v<T>)
+    {
+        return tensor_view<const T, Order>(m_data, m_extents, m_strides);
+    }
+
+    tensor_view(const tensor_view&) = default;
+    tensor_view(tensor_view&&) = default;
+    ~tensor_view() = default;
+
+    /**
+     * @brief Writes the elements of the other view into the elements of the view.
+     * @param rhs View holding the values to assign.
+     * @return Reference to the view.
+     */
+    constexpr const tensor_view& operator=(const tensor_view& rhs) const
+        requires(!std::is_const_v<T>)
+    {
+        apply(rhs, nullptr);
+        return *this;
+    }
+
+    /**
+     * @brief Writes the values of the expression, tensor or scalar into the elements of the view.
+     * The operand may only read the view at the element being written.
+     * @param rhs Expression, tensor or scalar holding the values to assign.
+     * @return Reference to the view.
+     */
+    template <detail::operand R>
+        requires(!std::is_const_v<T>)
+    constexpr const tensor_view& operator=(const R& rhs) const {
+        apply(rhs, nullptr);
+        return *this;
+    }
+
+    /**
+     * @brief Adds the expression, tensor or scalar to the elements of the view in place.
+     * @param rhs Expression, tensor or scalar.
+     * @return Reference to the view.
+     */
+    template <detail::operand R>
+        requires(!std::is_const_v<T>)
+    constexpr const tensor_view& operator+=(const R& rhs) const {
+        apply(rhs, op::add{});
+        return *this;
+    }
+
+    /**
+     * @brief Subtracts the expression, tensor or scalar from the elements of the view in place.
+     * @param rhs Expression, tensor or scalar.
+     * @return Reference to the view.
+     */
+    template <detail::operand R>
+        requires(!std::is_const_v<T>)
+    constexpr const tensor_view& operator-=(const R& rhs) const {
+        apply(rhs, op::sub{});
+        return *this;
+    }
+
+    /**
+     * @brief Multiplies the elements of the view by the expression, tensor or scalar in place.
+     * @param rhs Expression, tensor or scalar.
+     * @return Reference to the view.
+     */
+    template <detail::operand R>
+        requires(!std::is_const_v<T>)
+    constexpr const tensor_view& operator*=(const R& rhs) const {
+        apply(rhs, op::mul{});
+        return *this;
+    }
+
+    /**
+     * @brief Divides the elements of the view by the expression, tensor or scalar in place.
+     * @param rhs Expression, tensor or scalar.
+     * @return Reference to the view.
+     */
+    template <detail::operand R>
+        requires(!std::is_const_v<T>)
+    constexpr const tensor_view& operator/=(const R& rhs) const {
+        apply(rhs, op::div{});
+        return *this;
+    }
+
+    /**
+     * @brief Replaces every element of the view by the result of the callable.
+     * @param func Callable taking a value, wrapped in `op::packed` if it also accepts SIMD packs.
+     * @return Reference to the view.
+     */
+    template <typename F>
+        requires(!std::is_const_v<T>)
+    constexpr const tensor_view& transform_inplace(const F func) const {
+        apply(this->map(func), nullptr);
+        return *this;
+    }
+
+    /**
+     * @brief Returns the element at the provided row-major index. Bounds are only checked if
+     * `TENSOR_BOUNDS_CHECK` is enabled, which is the default for builds without `NDEBUG`.
+     * @param idx Row-major index of the element.
+     */
+    [[nodiscard]] constexpr T& operator[](const size_type idx) const {
+#if TENSOR_BOUNDS_CHECK
+        return at(idx);
+#else
+        return m_data[m_layout.offset(idx)];
+#endif
+    }
+
+    /**
+     * @brief Returns the element at the provided row-major index with bounds checking.
+     * @param idx Row-major index of the element.
+     */
+    [[nodiscard]] constexpr T& at(const size_type idx) const {
+        if (idx >= m_size) {
+            throw std::out_of_range("Index out of bounds.");
+        }
+        return m_data[m_layout.offset(idx)];
+    }
+
+    /**
+     * @brief Returns the element at the provided indices if `U == Order`, a view of the sub-tensor
+     * at the provided leading indices otherwise.
+     * @param idxs Array of leading indices.
+     */
+    template <size_type U>
+        requires(U <= Order)
+    [[nodiscard]] constexpr decltype(auto) get(const std::array<size_type, U> idxs) const {
+        size_type flat_idx = 0;
+        for (size_type idx = 0; idx < U; ++idx) {
+            if (idxs[idx] >= m_extents[idx]) {
+                throw std::out_of_range("Index out of bounds.");
+            }
+            flat_idx += idxs[idx] * m_strides[idx];
+        }
+
+        if constexpr (U == Order) {
+            return static_cast<T&>(m_data[flat_idx]);
+        } else {
+            array<Order - U> extents;
+            array<Order - U> strides;
+            std::copy(m_extents.begin() + U, m_extents.end(), extents.begin());
+            std::copy(m_strides.begin() + U, m_strides.end(), strides.begin());
+            return tensor_view<T, Order - U>(m_data + flat_idx, extents, strides);
+        }
+    }
+
+    /**
+     * @brief Restricts the axis to the elements from `begin` up to but excluding `end`, taking
+     * every `step`-th one.
+     * @param axis Axis to restrict.
+     * @param begin First index along the axis.
+     * @param end Index past the last one along the axis.
+     * @param step Distance between consecutive indices.
+     * @return A view of the same order.
+     */
+    [[nodiscard]] constexpr auto range(const size_type axis, const size_type begin,
+                                       const size_type end, const size_type step = 1) const {
+        if (axis >= Order || begin > end || end > m_extents[axis]) {
+            throw std::out_of_range("Index out of bounds.");
+        }
+        if (step == 0) {
+            throw std::domain_error("Step must be positive.");
+        }
+        auto extents = m_extents;
+        auto strides = m_strides;
+        extents[axis] = (end - begin + step - 1) / step;
+        strides[axis] *= step;
+        return tensor_view(extents[axis] == 0 ? m_data : m_data + begin * m_strides[axis], extents,
+                           strides);
+    }
+
+    /**
+     * @brief Reverses the order of the axes.
+     * @return A view of the same order.
+     */
+    [[nodiscard]] constexpr auto transpose() const noexcept {
+        auto extents = m_extents;
+        auto strides = m_strides;
+        std::reverse(extents.begin(), extents.end());
+        std::reverse(strides.begin(), strides.end());
+        return tensor_view(m_data, extents, strides);
+    }
+
+    /**
+     * @brief Swaps the two axes.
+     * @param lhs First axis.
+     * @param rhs Second axis.
+     * @return A view of the same order.
+     */
+    [[nodiscard]] constexpr auto transpose(const size_type lhs, const size_type rhs) const {
+        if (lhs >= Order || rhs >= Order) {
+            throw std::out_of_range("Index out of bounds.");
+        }
+        auto extents = m_extents;
+        auto strides = m_strides;
+        std::swap(extents[lhs], extents[rhs]);
+        std::swap(strides[lhs], strides[rhs]);
+        return tensor_view(m_data, extents, strides);
+    }
+
+    /**
+     * @brief Reorders the axes, so that axis `idx` of the result is axis `axes[idx]` of the view.
+     * @param axes Permutation of the axes.
+     * @return A view of the same order.
+     */
+    [[nodiscard]] constexpr auto permute(const array<Order> axes) const {
+        std::array<bool, Order> seen{};
+        auto extents = m_extents;
+        auto strides = m_strides;
+        for (size_type dim = 0; dim < Order; ++dim) {
+            if (axes[dim] >= Order || seen[axes[dim]]) {
+                throw std::out_of_range("Index out of bounds.");
+            }
+            seen[axes[dim]] = true;
+            extents[dim] = m_extents[axes[dim]];
+            strides[dim] = m_strides[axes[dim]];
+        }
+        return tensor_view(m_data, extents, strides);
+    }
+
+    /**
+     * @brief Views the elements, which have to be contiguous, with the provided extents instead.
+     * @param extents Extents of as many elements as the view holds.
+     * @return A view of order `N`.
+     */
+    template <size_type N>
+    [[nodiscard]] constexpr auto reshape(const array<N> extents) const {
+        if (std::reduce(extents.begin(), extents.end(), size_type{1},
+                        std::multiplies<size_type>()) != m_size) {
+            throw std::runtime_error("Tensor dimension mismatch.");
+        }
+        if (!is_contiguous()) {
+            throw std::runtime_error("Tensor is not contiguous.");
+        }
+        return tensor_view<T, N>(m_data, extents, detail::row_major_strides(extents));
+    }
+
+    /**
+     * @brief Views the elements, which have to be contiguous, as an order one view.
+     * @return A view of order one.
+     */
+    [[nodiscard]] constexpr auto flatten() const {
+        return reshape<1>({m_size});
+    }
+
+    /**
+     * @brief Copies the elements into a tensor in row-major order, transposing in cache-sized
+     * tiles if the innermost axis is not the one of smallest stride, see `kernel::copy`. Only
+     * needed where unit strides are required, as views are read in place otherwise.
+     * @return A tensor of the same extents.
+     */
+    [[nodiscard]] constexpr auto contiguous() const {
+        tensor<value_type, Order> result(m_extents);
+        kernel::copy(result.data(), m_data, m_extents, m_strides);
+        return result;
+    }
+
+    /**
+     * @brief Broadcasts the view to the provided extents as in NumPy, adding leading axes and
+     * repeating axes of extent one via a stride of zero. Since repeated elements alias, the
+     * returned view is read-only.
+     * @param extents Extents to broadcast to.
+     * @return A read-only view of order `N`.
+     */
+    template <size_type N>
+        requires(N >= Order)
+    [[nodiscard]] constexpr auto broadcast_to(const array<N> extents) const {
+        array<N> strides{};
+        for (size_type dim = N - Order; dim < N; ++dim) {
+            const auto axis = dim - (N - Order);
+            if (m_extents[axis] == extents[dim]) {
+                strides[dim] = m_strides[axis];
+            } else if (m_extents[axis] != 1) {
+                throw std::runtime_error("Tensor dimension mismatch.");
+            }
+        }
+        return tensor_view<const T, N>(m_data, extents, strides);
+    }
+
+    /**
+     * @brief Returns whether the elements are laid out in row-major order without gaps.
+     */
+    [[nodiscard]] constexpr bool is_contiguous() const noexcept {
+        return m_layout.is_contiguous();
+    }
+
+    /**
+     * @brief Reorders the axes by decreasing stride, the order in which the elements are laid out
+     * in memory, for operations that do not depend on the order of the elements. Ties keep their
+     * order, so that row-major views are unaffected.
+     * @return A view of the same elements and order.
+     */
+    [[nodiscard]] constexpr auto memory_order() const noexcept {
+        auto extents = m_extents;
+        auto strides = m_strides;
+        for (size_type dim = 1; dim < Order; ++dim) {
+            for (auto idx = dim; idx > 0 && strides[idx - 1] < strides[idx]; --idx) {
+                std::swap(extents[idx - 1], extents[idx]);
+                std::swap(strides[idx - 1], strides[idx]);
+            }
+        }
+        return tensor_view(m_data, extents, strides);
+    }
+
+    template <typename V>
+    [[nodiscard]] simd::pack<V> load(const size_type idx, const size_type count) const {
+        if (m_layout.is_contiguous()) {
+            const auto* data = m_data + idx;
+            return count == simd::pack<V>::width ? simd::load(data)
+                                                 : simd::load_partial(data, count);
+        }
+        return gather<V>(idx, count);
+    }
+
+    /**
+     * @brief Returns a cursor reading the elements from the provided one on, see
+     * `kernel::detail::cursor`.
+     */
+    [[nodiscard]] auto cursor(const size_type idx) const noexcept {
+        return row_cursor(*this, idx);
+    }
+
+    /**
+     * @brief Returns a pointer to the first element of the view.
+     */
+    [[nodiscard]] constexpr auto data() const noexcept {
+        return m_data;
+    }
+
+    /**
+     * @brief Returns the extents.
+     */
+    [[nodiscard]] constexpr auto extents() const noexcept {
+        return m_extents;
+    }
+
+    /**
+     * @brief Returns the distance between consecutive elements along every axis.
+     */
+    [[nodiscard]] constexpr auto strides() const noexcept {
+        return m_strides;
+    }
+
+    /**
+     * @brief Returns the number of elements of the view.
+     */
+    [[nodiscard]] constexpr auto size() const noexcept {
+        return m_size;
+    }
+
+    /**
+     * @brief Returns whether the view reads elements in [first, last) other than the one being
+     * written, i.e. whether it overlaps that memory without being a contiguous view of all of it.
+     */
+    [[nodiscard]] bool aliases(const void* first, const void* last) const noexcept {
+        if (m_size == 0) {
+            return false;
+        }
+        size_type span = 1;
+        for (size_type dim = 0; dim < Order; ++dim) {
+            span += (m_extents[dim] - 1) * m_strides[dim];
+        }
+        const std::less<const void*> less;
+        if (!less(m_data, last) || !less(first, m_data + span)) {
+            return false;
+        }
+        return !m_layout.is_contiguous() || m_data != first || m_data + m_size != last;
+    }
+};
+
+}  // namespace core
+
+#endif  // VIEW_HPP
@@ -25,8 +25,24 @@
 #ifndef TENSOR_HPP
 #define TENSOR_HPP
 
+#include "core/batch.hpp"
 #include "core/builder.hpp"
+#include "core/compare.hpp"
 #include "core/core.hpp"
+#include "core/einsum.hpp"
+#include "core/expr.hpp"
+#include "core/half.hpp"
+#include "core/instrument.hpp"
+#include "core/io.hpp"
+#include "core/linalg.hpp"
+#include "core/memory.hpp"
+#include "core/npy.hpp"
+#include "core/quantize.hpp"
+#include "core/random.hpp"
+#include "core/reduce.hpp"
+#include "core/sparse.hpp"
+#include "core/static.hpp"
 #include "core/type.hpp"
+#include "core/view.hpp"
 
 #endif  // TENSOR_HPP
@@ -0,0 +1,665 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <random>
+#include <utility>
+
+#include "../include/tensor.hpp"
+
+using namespace type;
+
+// Sizes of one operand, from 16 KiB of floats resident in L1 to 64 MiB streamed from DRAM.
+#define ELEMENTWISE_SIZES RangeMultiplier(16)->Range(1 << 12, 1 << 24)
+
+namespace {
+
+[[nodiscard]] size_type extent(const benchmark::State& state) {
+    return static_cast<size_type>(state.range(0));
+}
+
+[[nodiscard]] double elements(const benchmark::State& state) {
+    return static_cast<double>(state.range(0));
+}
+
+/**
+ * @brief Reports the elements, memory traffic and arithmetic of one iteration, shown as
+ * items_per_second, bytes_per_second and FLOPS in the console and the JSON output.
+ */
+void report(benchmark::State& state, const double items, const double bytes, const double flops) {
+    const auto iterations = static_cast<double>(state.iterations());
+    state.SetItemsProcessed(static_cast<std::int64_t>(iterations * items));
+    if (bytes > 0) {
+        state.SetBytesProcessed(static_cast<std::int64_t>(iterations * bytes));
+    }
+    if (flops > 0) {
+        state.counters["FLOPS"] =
+            benchmark::Counter(iterations * flops, benchmark::Counter::kIsRate);
+    }
+}
+
+[[nodiscard]] tensor1<float> operand(const size_type size, const float val) {
+    return builder::xs<float, 1>({size}, val);
+}
+
+}  // namespace
+
+// Element access {{{
+
+static void checked_add(benchmark::State& state) {
+    auto t1 = builder::ones<float, 1>({extent(state)});
+    const auto t2 = builder::ones<float, 1>({extent(state)});
+    for (auto _ : state) {
+        for (size_type idx = 0; idx < t1.size(); ++idx) {
+            t1.at(idx) += t2.at(idx);
+        }
+        benchmark::DoNotOptimize(t1.data());
+        benchmark::ClobberMemory();
+    }
+    report(state, elements(state), 3.0 * sizeof(float) * elements(state), elements(state));
+}
+BENCHMARK(checked_add)->Range(1 << 10, 1 << 22);
+
+static void unchecked_add(benchmark::State& state) {
+    auto t1 = builder::ones<float, 1>({extent(state)});
+    const auto t2 = builder::ones<float, 1>({extent(state)});
+    for (auto _ : state) {
+        for (size_type idx = 0; idx < t1.size(); ++idx) {
+            t1[idx] += t2[idx];
+        }
+        benchmark::DoNotOptimize(t1.data());
+        benchmark::ClobberMemory();
+    }
+    report(state, elements(state), 3.0 * sizeof(float) * elements(state), elements(state));
+}
+BENCHMARK(unchecked_add)->Range(1 << 10, 1 << 22);
+
+// }}}
+
+// Arithmetic operators {{{
+
+// Out-of-place operators read both operands and write a new tensor.
+template <typename F>
+static void binary(benchmark::State& state, F func) {
+    const auto t1 = operand(extent(state), 1.5F);
+    const auto t2 = operand(extent(state), 0.5F);
+    for (auto _ : state) {
+        auto result = func(t1, t2);
+        benchmark::DoNotOptimize(result.data());
+        benchmark::ClobberMemory();
+    }
+    report(state, elements(state), 3.0 * sizeof(float) * elements(state), elements(state));
+}
+BENCHMARK_CAPTURE(binary, add, [](const auto& a, const auto& b) { return a + b; })
+    ->ELEMENTWISE_SIZES;
+BENCHMARK_CAPTURE(binary, sub, [](const auto& a, const auto& b) { return a - b; })
+    ->ELEMENTWISE_SIZES;
+BENCHMARK_CAPTURE(binary, mul, [](const auto& a, const auto& b) { return a * b; })
+    ->ELEMENTWISE_SIZES;
+BENCHMARK_CAPTURE(binary, div, [](const auto& a, const auto& b) { return a / b; })
+    ->ELEMENTWISE_SIZES;
+
+// Compound assignments update the left-hand side in place.
+template <typename F>
+static void inplace(benchmark::State& state, F func) {
+    auto t1 = operand(extent(state), 1.5F);
+    const auto t2 = operand(extent(state), 1.0F);
+    for (auto _ : state) {
+        func(t1, t2);
+        benchmark::DoNotOptimize(t1.data());
+        benchmark::ClobberMemory();
+    }
+    report(state, elements(state), 3.0 * sizeof(float) * elements(state), elements(state));
+}
+BENCHMARK_CAPTURE(inplace, add, [](auto& a, const auto& b) { a += b; })->ELEMENTWISE_SIZES;
+BENCHMARK_CAPTURE(inplace, sub, [](auto& a, const auto& b) { a -= b; })->ELEMENTWISE_SIZES;
+BENCHMARK_CAPTURE(inplace, mul, [](auto& a, const auto& b) { a *= b; })->ELEMENTWISE_SIZES;
+BENCHMARK_CAPTURE(inplace, div, [](auto& a, const auto& b) { a /= b; })->ELEMENTWISE_SIZES;
+
+// Operators taking a scalar read and write one tensor each.
+template <typename F>
+static void scalar(benchmark::State& state, F func) {
+    auto t = operand(extent(state), 1.5F);
+    for (auto _ : state) {
+        func(t);
+        benchmark::DoNotOptimize(t.data());
+        benchmark::ClobberMemory();
+    }
+    report(state, elements(state), 2.0 * sizeof(float) * elements(state), elements(state));
+}
+BENCHMARK_CAPTURE(scalar, add, [](auto& t) { t += 1.0F; })->ELEMENTWISE_SIZES;
+BENCHMARK_CAPTURE(scalar, sub, [](auto& t) { t -= 1.0F; })->ELEMENTWISE_SIZES;
+BENCHMARK_CAPTURE(scalar, mul, [](auto& t) { t *= 1.0F; })->ELEMENTWISE_SIZES;
+BENCHMARK_CAPTURE(scalar, div, [](auto& t) { t /= 1.0F; })->ELEMENTWISE_SIZES;
+BENCHMARK_CAPTURE(scalar, add_copy, [](auto& t) { benchmark::DoNotOptimize((t + 1.0F).data()); })
+    ->ELEMENTWISE_SIZES;
+BENCHMARK_CAPTURE(scalar, mul_rvalue, [](auto& t) { t = std::move(t) * 1.0F; })
+    ->ELEMENTWISE_SIZES;
+
+// Expressions fuse a chain into one pass over the operands.
+static void fused(benchmark::State& state) {
+    const auto a = operand(extent(state), 1.5F);
+    const auto b = operand(extent(state), 0.5F);
+    const auto c = operand(extent(state), 2.0F);
+    auto result = tensor1<float>(array<1>{extent(state)});
+    for (auto _ : state) {
+        result = (core::lazy(a) * b + c).sqrt();
+        benchmark::DoNotOptimize(result.data());
+        benchmark::ClobberMemory();
+    }
+    report(state, elements(state), 4.0 * sizeof(float) * elements(state), 3.0 * elements(state));
+}
+BENCHMARK(fused)->ELEMENTWISE_SIZES;
+
+static void broadcast(benchmark::State& state) {
+    const auto n = extent(state);
+    auto m = builder::ones<float, 2>({n, n});
+    const auto row = operand(n, 0.5F);
+    for (auto _ : state) {
+        m += row;
+        benchmark::DoNotOptimize(m.data());
+        benchmark::ClobberMemory();
+    }
+    report(state, static_cast<double>(n * n), 2.0 * sizeof(float) * static_cast<double>(n * n),
+           static_cast<double>(n * n));
+}
+BENCHMARK(broadcast)->RangeMultiplier(4)->Range(64, 4096);
+
+// }}}
+
+// Comparisons {{{
+
+template <typename F>
+static void comparison(benchmark::State& state, F func) {
+    const auto t1 = operand(extent(state), 1.0F);
+    const auto t2 = operand(extent(state), 1.0F);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(func(t1, t2));
+    }
+    report(state, elements(state), 2.0 * sizeof(float) * elements(state), 0);
+}
+BENCHMARK_CAPTURE(comparison, eq, [](const auto& a, const auto& b) { return a == b; })
+    ->ELEMENTWISE_SIZES;
+BENCHMARK_CAPTURE(comparison, ne, [](const auto& a, const auto& b) { return a != b; })
+    ->ELEMENTWISE_SIZES;
+BENCHMARK_CAPTURE(comparison, gt, [](const auto& a, const auto& b) { return a > b; })
+    ->ELEMENTWISE_SIZES;
+BENCHMARK_CAPTURE(comparison, ge, [](const auto& a, const auto& b) { return a >= b; })
+    ->ELEMENTWISE_SIZES;
+BENCHMARK_CAPTURE(comparison, lt, [](const auto& a, const auto& b) { return a < b; })
+    ->ELEMENTWISE_SIZES;
+BENCHMARK_CAPTURE(comparison, le, [](const auto& a, const auto& b) { return a <= b; })
+    ->ELEMENTWISE_SIZES;
+BENCHMARK_CAPTURE(comparison, all_equal,
+                  [](const auto& a, const auto& b) { return core::all(core::equal(a, b)); })
+    ->ELEMENTWISE_SIZES;
+BENCHMARK_CAPTURE(comparison, any_greater,
+                  [](const auto& a, const auto& b) { return core::any(core::greater(a, b)); })
+    ->ELEMENTWISE_SIZES;
+
+// Element-wise comparisons write one `bool` per element.
+static void mask(benchmark::State& state) {
+    const auto t1 = operand(extent(state), 1.0F);
+    const auto t2 = operand(extent(state), 2.0F);
+    auto result = tensor1<bool>(array<1>{extent(state)});
+    for (auto _ : state) {
+        result = core::less(t1, t2);
+        benchmark::DoNotOptimize(result.data());
+        benchmark::ClobberMemory();
+    }
+    report(state, elements(state), (2.0 * sizeof(float) + 1.0) * elements(state), elements(state));
+}
+BENCHMARK(mask)->ELEMENTWISE_SIZES;
+
+// }}}
+
+// Math members {{{
+
+// Math members of an expiring tensor transform its buffer in place.
+template <typename F>
+static void unary(benchmark::State& state, F func) {
+    auto t = operand(extent(state), 0.5F);
+    for (auto _ : state) {
+        t = func(std::move(t));
+        benchmark::DoNotOptimize(t.data());
+        benchmark::ClobberMemory();
+    }
+    report(state, elements(state), 2.0 * sizeof(float) * elements(state), elements(state));
+}
+BENCHMARK_CAPTURE(unary, pow, [](tensor1<float>&& t) { return std::move(t).pow(1); })
+    ->ELEMENTWISE_SIZES;
+BENCHMARK_CAPTURE(unary, square, [](tensor1<float>&& t) { return std::move(t).square(); })
+    ->ELEMENTWISE_SIZES;
+BENCHMARK_CAPTURE(unary, sqrt, [](tensor1<float>&& t) { return std::move(t).sqrt(); })
+    ->ELEMENTWISE_SIZES;
+BENCHMARK_CAPTURE(unary, sin, [](tensor1<float>&& t) { return std::move(t).sin(); })
+    ->ELEMENTWISE_SIZES;
+BENCHMARK_CAPTURE(unary, cos, [](tensor1<float>&& t) { return std::move(t).cos(); })
+    ->ELEMENTWISE_SIZES;
+BENCHMARK_CAPTURE(unary, tan, [](tensor1<float>&& t) { return std::move(t).tan(); })
+    ->ELEMENTWISE_SIZES;
+BENCHMARK_CAPTURE(unary, round, [](tensor1<float>&& t) { return std::move(t).round(); })
+    ->ELEMENTWISE_SIZES;
+
+// Lazy math functions and user callables write into an existing tensor, leaving the argument
+// unchanged so that every iteration stays within the range of the approximations.
+template <typename F>
+static void math(benchmark::State& state, F func) {
+    const auto t = operand(extent(state), 0.5F);
+    auto result = t;
+    for (auto _ : state) {
+        result = func(t);
+        benchmark::DoNotOptimize(result.data());
+        benchmark::ClobberMemory();
+    }
+    report(state, elements(state), 2.0 * sizeof(float) * elements(state), elements(state));
+}
+BENCHMARK_CAPTURE(math, exp, [](const auto& t) { return core::lazy(t).exp(); })->ELEMENTWISE_SIZES;
+BENCHMARK_CAPTURE(math, log, [](const auto& t) { return core::lazy(t).log(); })->ELEMENTWISE_SIZES;
+BENCHMARK_CAPTURE(math, tanh, [](const auto& t) { return core::lazy(t).tanh(); })
+    ->ELEMENTWISE_SIZES;
+BENCHMARK_CAPTURE(math, abs, [](const auto& t) { return core::lazy(t).abs(); })->ELEMENTWISE_SIZES;
+BENCHMARK_CAPTURE(math, map, [](const auto& t) {
+    return core::lazy(t).map([](const float x) { return x > 0 ? x : 0.1F * x; });
+})->ELEMENTWISE_SIZES;
+BENCHMARK_CAPTURE(math, map_packed, [](const auto& t) {
+    return core::lazy(t).map(core::op::packed{[](const auto x) { return x * x + x; }});
+})->ELEMENTWISE_SIZES;
+BENCHMARK_CAPTURE(math, zip, [](const auto& t) {
+    return core::zip(t, t, [](const float a, const float b) { return a < b ? a : b; });
+})->ELEMENTWISE_SIZES;
+
+static void parallel_sqrt(benchmark::State& state) {
+    const auto threads = parallel::set_threads(0);
+    auto t = builder::ones<float, 1>({extent(state)});
+    for (auto _ : state) {
+        t = std::move(t).sqrt();
+        benchmark::DoNotOptimize(t.data());
+        benchmark::ClobberMemory();
+    }
+    report(state, elements(state), 2.0 * sizeof(float) * elements(state), elements(state));
+    parallel::set_threads(threads);
+}
+BENCHMARK(parallel_sqrt)->ELEMENTWISE_SIZES;
+
+// 64 independent chains of three small steps, each step materialized into a tensor, run one call
+// at a time or recorded once into a batch that is resubmitted.
+template <bool Batched>
+static void small_steps(benchmark::State& state) {
+    constexpr size_type chains = 64;
+    const auto threads = parallel::set_threads(static_cast<std::size_t>(state.range(1)));
+    const auto a = operand(extent(state), 2.0F);
+    const auto b = operand(extent(state), 1.0F);
+    const auto sum = [](const auto& x, const auto& y) { return core::lazy(x) + y; };
+    const auto product = [](const auto& x, const auto& y) { return core::lazy(x) * y; };
+    const auto root = [](const auto& x) { return core::lazy(x).sqrt(); };
+    if constexpr (Batched) {
+        parallel::batch batch;
+        const auto x = batch.input(a);
+        const auto y = batch.input(b);
+        for (size_type idx = 0; idx < chains; ++idx) {
+            const auto step = batch.record(product, batch.record(sum, x, y), x);
+            static_cast<void>(batch.record(root, step));
+        }
+        for (auto _ : state) {
+            batch.submit().get();
+        }
+    } else {
+        for (auto _ : state) {
+            for (size_type idx = 0; idx < chains; ++idx) {
+                const tensor1<float> s = sum(a, b);
+                const tensor1<float> p = product(s, a);
+                const tensor1<float> r = root(p);
+                benchmark::DoNotOptimize(r.data());
+            }
+            benchmark::ClobberMemory();
+        }
+    }
+    report(state, 3 * chains * elements(state), 0, 3 * chains * elements(state));
+    parallel::set_threads(threads);
+}
+BENCHMARK_TEMPLATE(small_steps, false)->ArgsProduct({{64, 512, 4096}, {1, 4}})->UseRealTime();
+BENCHMARK_TEMPLATE(small_steps, true)->ArgsProduct({{64, 512, 4096}, {1, 4}})->UseRealTime();
+
+// }}}
+
+// Builders {{{
+
+template <typename F>
+static void fill(benchmark::State& state, F func) {
+    for (auto _ : state) {
+        auto t = func(extent(state));
+        benchmark::DoNotOptimize(t.data());
+        benchmark::ClobberMemory();
+    }
+    report(state, elements(state), 1.0 * sizeof(float) * elements(state), 0);
+}
+BENCHMARK_CAPTURE(fill, zeros, [](const size_type n) { return builder::zeros<float, 1>({n}); })
+    ->ELEMENTWISE_SIZES;
+BENCHMARK_CAPTURE(fill, ones, [](const size_type n) { return builder::ones<float, 1>({n}); })
+    ->ELEMENTWISE_SIZES;
+BENCHMARK_CAPTURE(fill, xs, [](const size_type n) { return builder::xs<float, 1>({n}, 2.0F); })
+    ->ELEMENTWISE_SIZES;
+BENCHMARK_CAPTURE(fill, empty, [](const size_type n) { return builder::empty<float, 1>({n}); })
+    ->ELEMENTWISE_SIZES;
+BENCHMARK_CAPTURE(fill, range1,
+                  [](const size_type n) { return builder::range1<float>(0, n, 1); })
+    ->ELEMENTWISE_SIZES;
+
+BENCHMARK_CAPTURE(fill, arange,
+                  [](const size_type n) {
+                      return builder::arange(0.0F, static_cast<float>(n)).eval();
+                  })
+    ->ELEMENTWISE_SIZES;
+BENCHMARK_CAPTURE(fill, linspace,
+                  [](const size_type n) { return builder::linspace(0.0F, 1.0F, n).eval(); })
+    ->ELEMENTWISE_SIZES;
+BENCHMARK_CAPTURE(fill, arange_scaled,
+                  [](const size_type n) {
+                      return (builder::arange(0.0F, static_cast<float>(n)) * 2.0F).eval();
+                  })
+    ->ELEMENTWISE_SIZES;
+BENCHMARK_CAPTURE(fill, uniform,
+                  [](const size_type n) { return builder::uniform<float, 1>({n}); })
+    ->ELEMENTWISE_SIZES;
+BENCHMARK_CAPTURE(fill, normal, [](const size_type n) { return builder::normal<float, 1>({n}); })
+    ->ELEMENTWISE_SIZES;
+BENCHMARK_CAPTURE(fill, bernoulli,
+                  [](const size_type n) { return builder::bernoulli<float, 1>({n}, 0.5); })
+    ->ELEMENTWISE_SIZES;
+BENCHMARK_CAPTURE(fill, mt19937, [](const size_type n) {
+    auto t = builder::empty<float, 1>({n});
+    auto engine = std::mt19937(0);
+    auto distribution = std::uniform_real_distribution<float>(0.0F, 1.0F);
+    std::generate(t.data(), t.data() + t.size(), [&] { return distribution(engine); });
+    return t;
+})->ELEMENTWISE_SIZES;
+
+static void fill_like(benchmark::State& state) {
+    const auto t = operand(extent(state), 1.0F);
+    for (auto _ : state) {
+        auto result = builder::xs_like(t, 2.0F);
+        benchmark::DoNotOptimize(result.data());
+        benchmark::ClobberMemory();
+    }
+    report(state, elements(state), 1.0 * sizeof(float) * elements(state), 0);
+}
+BENCHMARK(fill_like)->ELEMENTWISE_SIZES;
+
+// }}}
+
+// Construction, copies and moves {{{
+
+static void construct(benchmark::State& state) {
+    for (auto _ : state) {
+        auto t = tensor1<float>(array<1>{extent(state)});
+        benchmark::DoNotOptimize(t.data());
+    }
+    report(state, elements(state), 0, 0);
+}
+BENCHMARK(construct)->ELEMENTWISE_SIZES;
+
+static void copy_construct(benchmark::State& state) {
+    const auto t = operand(extent(state), 1.0F);
+    for (auto _ : state) {
+        auto result = t;
+        benchmark::DoNotOptimize(result.data());
+        benchmark::ClobberMemory();
+    }
+    report(state, elements(state), 2.0 * sizeof(float) * elements(state), 0);
+}
+BENCHMARK(copy_construct)->ELEMENTWISE_SIZES;
+
+static void copy_assign(benchmark::State& state) {
+    const auto t = operand(extent(state), 1.0F);
+    auto result = operand(extent(state), 0.0F);
+    for (auto _ : state) {
+        result = t;
+        benchmark::DoNotOptimize(result.data());
+        benchmark::ClobberMemory();
+    }
+    report(state, elements(state), 2.0 * sizeof(float) * elements(state), 0);
+}
+BENCHMARK(copy_assign)->ELEMENTWISE_SIZES;
+
+static void move_construct(benchmark::State& state) {
+    auto t = operand(extent(state), 1.0F);
+    for (auto _ : state) {
+        auto result = std::move(t);
+        benchmark::DoNotOptimize(result.data());
+        t = std::move(result);
+    }
+    report(state, 1, 0, 0);
+}
+BENCHMARK(move_construct)->ELEMENTWISE_SIZES;
+
+// A chain of eager operators allocates a temporary per operator, either from the default resource
+// or from an arena scope opened per iteration.
+template <bool Arena>
+static void temporaries(benchmark::State& state) {
+    const auto a = operand(extent(state), 1.0F);
+    const auto chain = [&a] {
+        const auto r = (a + a) * (a - 1.0F) + (a * a) / (a + 1.0F);
+        benchmark::DoNotOptimize(r.data());
+    };
+    for (auto _ : state) {
+        if constexpr (Arena) {
+            memory::tensor_arena scope(8 * sizeof(float) * extent(state));
+            chain();
+        } else {
+            chain();
+        }
+        benchmark::ClobberMemory();
+    }
+    report(state, 7 * elements(state), 0, 7 * elements(state));
+}
+BENCHMARK_TEMPLATE(temporaries, false)
+    ->RangeMultiplier(8)
+    ->Range(1 << 6, 1 << 15)
+    ->ThreadRange(1, 4);
+BENCHMARK_TEMPLATE(temporaries, true)
+    ->RangeMultiplier(8)
+    ->Range(1 << 6, 1 << 15)
+    ->ThreadRange(1, 4);
+
+// }}}
+
+// Slicing {{{
+
+// `get` copies the sub-tensor at the leading index, `slice` only computes a view of it.
+static void get_subtensor(benchmark::State& state) {
+    const auto n = extent(state);
+    const auto m = builder::ones<float, 2>({n, n});
+    size_type row = 0;
+    for (auto _ : state) {
+        auto result = m.get<1>({row});
+        benchmark::DoNotOptimize(result.data());
+        row = (row + 1) % n;
+    }
+    report(state, static_cast<double>(n), 2.0 * sizeof(float) * static_cast<double>(n), 0);
+}
+BENCHMARK(get_subtensor)->RangeMultiplier(4)->Range(64, 4096);
+
+static void get_element(benchmark::State& state) {
+    const auto n = extent(state);
+    const auto m = builder::ones<float, 2>({n, n});
+    size_type idx = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(m.get<2>({idx, n - 1 - idx}));
+        idx = (idx + 1) % n;
+    }
+    report(state, 1, 0, 0);
+}
+BENCHMARK(get_element)->RangeMultiplier(4)->Range(64, 4096);
+
+static void slice(benchmark::State& state) {
+    const auto n = extent(state);
+    const auto m = builder::ones<float, 2>({n, n});
+    size_type row = 0;
+    for (auto _ : state) {
+        auto result = m.slice<1>({row});
+        benchmark::DoNotOptimize(result.data());
+        row = (row + 1) % n;
+    }
+    report(state, 1, 0, 0);
+}
+BENCHMARK(slice)->RangeMultiplier(4)->Range(64, 4096);
+
+// `reshape` on an expiring tensor hands over its buffer, whereas `flatten` on an lvalue copies it.
+static void reshape(benchmark::State& state) {
+    const auto n = extent(state);
+    auto m = builder::ones<float, 2>({n, n});
+    for (auto _ : state) {
+        auto result = std::move(m).reshape<3>({n, n / 4, 4});
+        benchmark::DoNotOptimize(result.data());
+        m = std::move(result).reshape<2>({n, n});
+    }
+    report(state, 1, 0, 0);
+}
+BENCHMARK(reshape)->RangeMultiplier(4)->Range(64, 4096);
+
+// Copying a transposed view element by element, as evaluating it does, against copying it in
+// tiles via `contiguous`.
+template <typename F>
+static void transpose_copy(benchmark::State& state, F func) {
+    const auto n = extent(state);
+    const auto m = builder::ones<float, 2>({n, n});
+    for (auto _ : state) {
+        auto result = func(m.transpose());
+        benchmark::DoNotOptimize(result.data());
+    }
+    report(state, static_cast<double>(n * n), 2.0 * sizeof(float) * static_cast<double>(n * n), 0);
+}
+BENCHMARK_CAPTURE(transpose_copy, evaluate, [](const auto& v) { return tensor2<float>(v); })
+    ->RangeMultiplier(4)
+    ->Range(64, 4096);
+BENCHMARK_CAPTURE(transpose_copy, contiguous, [](const auto& v) { return v.contiguous(); })
+    ->RangeMultiplier(4)
+    ->Range(64, 4096);
+
+// Kernels on views every other column of a matrix, whose rows collapse into a single strided one,
+// and on transposed views, which reductions and scalar assignments read in the order of memory.
+template <typename F>
+static void strided(benchmark::State& state, F func) {
+    const auto n = extent(state);
+    auto m = builder::ones<float, 2>({n, 2 * n});
+    for (auto _ : state) {
+        func(m);
+        benchmark::ClobberMemory();
+    }
+    report(state, static_cast<double>(n * n), 0, 0);
+}
+BENCHMARK_CAPTURE(strided, add, [](auto& m) {
+    const auto v = m.view().range(1, 0, m.extents()[1], 2);
+    benchmark::DoNotOptimize(tensor2<float>(v + v).data());
+})->RangeMultiplier(4)->Range(64, 4096);
+BENCHMARK_CAPTURE(strided, assign, [](auto& m) {
+    m.view().range(1, 1, m.extents()[1], 2) = m.view().range(1, 0, m.extents()[1], 2);
+})->RangeMultiplier(4)->Range(64, 4096);
+BENCHMARK_CAPTURE(strided, sum_transposed, [](auto& m) {
+    benchmark::DoNotOptimize(core::sum(m.transpose()));
+})->RangeMultiplier(4)->Range(64, 4096);
+BENCHMARK_CAPTURE(strided, fill_transposed, [](auto& m) { m.transpose() = 2.0F; })
+    ->RangeMultiplier(4)
+    ->Range(64, 4096);
+
+// }}}
+
+// Reductions and products {{{
+
+static void reduce_sum(benchmark::State& state) {
+    const auto t = operand(extent(state), 0.5F);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(core::sum(t));
+    }
+    report(state, elements(state), 1.0 * sizeof(float) * elements(state), elements(state));
+}
+BENCHMARK(reduce_sum)->ELEMENTWISE_SIZES;
+
+static void matrix_product(benchmark::State& state) {
+    const auto n = extent(state);
+    const auto a = builder::ones<float, 2>({n, n});
+    const auto b = builder::ones<float, 2>({n, n});
+    for (auto _ : state) {
+        auto c = core::matmul(a, b);
+        benchmark::DoNotOptimize(c.data());
+        benchmark::ClobberMemory();
+    }
+    report(state, static_cast<double>(n * n), 3.0 * sizeof(float) * static_cast<double>(n * n),
+           2.0 * static_cast<double>(n * n * n));
+}
+BENCHMARK(matrix_product)->RangeMultiplier(2)->Range(64, 1024);
+
+// An n by n matrix with 5% nonzeros times a dense n by 64 one, as a dense product or an SpMM.
+template <bool Sparse>
+static void sparse_product(benchmark::State& state) {
+    const auto n = extent(state);
+    auto a = builder::zeros<float, 2>({n, n});
+    for (size_type idx = 0; idx < a.size(); idx += 20) {
+        a[idx] = 1.0F;
+    }
+    const auto csr = core::csr_matrix<float>(a);
+    const auto b = builder::ones<float, 2>({n, 64});
+    for (auto _ : state) {
+        auto c = Sparse ? core::matmul(csr, b) : core::matmul(a, b);
+        benchmark::DoNotOptimize(c.data());
+        benchmark::ClobberMemory();
+    }
+    const auto nnz = static_cast<double>(csr.nnz());
+    report(state, static_cast<double>(n * 64), 0, 2.0 * 64 * (Sparse ? nnz : 1.0 * n * n));
+}
+BENCHMARK_TEMPLATE(sparse_product, false)->RangeMultiplier(4)->Range(256, 4096);
+BENCHMARK_TEMPLATE(sparse_product, true)->RangeMultiplier(4)->Range(256, 4096);
+
+// }}}
+
+// Reduced precision {{{
+
+template <typename U>
+static void convert_to(benchmark::State& state) {
+    const auto t = operand(extent(state), 1.5F);
+    for (auto _ : state) {
+        auto result = core::convert<U>(t);
+        benchmark::DoNotOptimize(result.data());
+        benchmark::ClobberMemory();
+    }
+    report(state, elements(state), (sizeof(float) + sizeof(U)) * elements(state), 0);
+}
+BENCHMARK(convert_to<core::float16>)->ELEMENTWISE_SIZES;
+BENCHMARK(convert_to<core::bfloat16>)->ELEMENTWISE_SIZES;
+
+static void half_add(benchmark::State& state) {
+    const auto t1 = core::convert<core::bfloat16>(operand(extent(state), 1.0F));
+    const auto t2 = core::convert<core::bfloat16>(operand(extent(state), 2.0F));
+    for (auto _ : state) {
+        auto result = t1 + t2;
+        benchmark::DoNotOptimize(result.data());
+        benchmark::ClobberMemory();
+    }
+    report(state, elements(state), 3.0 * sizeof(core::bfloat16) * elements(state),
+           elements(state));
+}
+BENCHMARK(half_add)->ELEMENTWISE_SIZES;
+
+static void quantize(benchmark::State& state) {
+    const auto t = operand(extent(state), 1.5F);
+    for (auto _ : state) {
+        auto q = core::quantize(t, 0.1F, std::int8_t{0});
+        benchmark::DoNotOptimize(q.values.data());
+        benchmark::ClobberMemory();
+    }
+    report(state, elements(state), (sizeof(float) + 1.0) * elements(state), 0);
+}
+BENCHMARK(quantize)->ELEMENTWISE_SIZES;
+
+static void dequantize(benchmark::State& state) {
+    const auto q = core::quantize(operand(extent(state), 1.5F), 0.1F, std::int8_t{0});
+    for (auto _ : state) {
+        auto result = core::dequantize(q);
+        benchmark::DoNotOptimize(result.data());
+        benchmark::ClobberMemory();
+    }
+    report(state, elements(state), (sizeof(float) + 1.0) * elements(state), 0);
+}
+BENCHMARK(dequantize)->ELEMENTWISE_SIZES;
+
+// }}}